@@ -0,0 +1,47 @@
+/*
+ *  analyze.cpp
+ *  SimpleChess
+ *
+ *  Copyright (c) 2013-2015 Ronak Gajrawala. All rights reserved.
+ */
+
+/*
+ * Analyses every game of an archive with the engine and writes the evaluations to <archive>.ann.
+ * Run it again to carry on after it was stopped.
+ * Usage: simplechess-analyze [archive] [depth] [nodes] [threads]
+ */
+
+#include "core.hpp"
+
+int main(int argc, char* argv[]) {
+	const std::string archive = argc > 1 ? argv[1] : "log/Games.sca";
+	SimpleChess::Annotations::Limits limits;
+	limits.Depth = argc > 2 ? std::atoi(argv[2]) : SimpleChess::Annotations::DefaultDepth;
+	limits.Nodes = argc > 3 ? std::strtoull(argv[3], nullptr, 10) : 0;
+	const int threads = argc > 4 ? std::atoi(argv[4]) : 0;
+
+	SimpleChess::Engine::Zobrist::Initialize();
+	sf::Clock clock, shown;
+	SimpleChess::Annotations::Stats stats;
+
+	// At most one progress line a second.
+	const auto progress = [&](const SimpleChess::Annotations::Stats& now) {
+		if (shown.getElapsedTime().asSeconds() >= 1.0f) {
+			shown.restart();
+			std::cout << "Analysed " << now.Games << " games, " << static_cast<sf::Uint64>(now.Positions / std::max(clock.getElapsedTime().asSeconds(), 1e-6f)) << " positions/s" << std::endl;
+		}
+	};
+
+	try {
+		stats = SimpleChess::Annotations::Run(archive, limits, threads, progress);
+	} catch (int e) {
+		std::cerr << "Could not analyse " << archive << "." << std::endl;
+		return EXIT_FAILURE;
+	}
+
+	const double seconds = std::max(clock.getElapsedTime().asSeconds(), 1e-6f);
+	std::cout << "Analysed " << stats.Games << " games (" << stats.Positions << " positions, " << stats.Blunders << " blunders) to " << archive << ".ann in " << seconds << " s"
+			  << (stats.Resumed > 0 ? ", " + std::to_string(stats.Resumed) + " were already done" : "") << "." << std::endl
+			  << "Throughput: " << static_cast<sf::Uint64>(stats.Positions / seconds) << " positions/s, " << static_cast<sf::Uint64>(stats.Nodes / seconds) << " nodes/s" << std::endl;
+	return 0;
+}
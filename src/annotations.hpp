@@ -0,0 +1,466 @@
+/*
+ *  annotations.hpp
+ *  SimpleChess
+ *
+ *  Copyright (c) 2013-2015 Ronak Gajrawala. All rights reserved.
+ */
+
+#ifndef SimpleChess_annotations_hpp
+#define SimpleChess_annotations_hpp
+
+namespace SimpleChess {
+	/**
+	 * The Annotations class.
+	 * Engine evaluations of every position of the games in an archive, kept next to it (<archive>.ann).
+	 * Games are added one record at a time as they are analysed, in any order, so an analysis that stops can carry on where it was.
+	 * All numbers are little-endian.
+	 *
+	 *   offset  size  field
+	 *        0     4  magic "SCN" 0x1A
+	 *        4     2  version
+	 *        6     2  search depth (0 for none)
+	 *        8     8  search nodes (0 for none)
+	 *       16     .  records: game in the archive (4), number of positions (4, its moves + 1, or the moves before the first
+	 *                 broken one + 1, whose last position is flagged Cut),
+	 *                 6 bytes per position: score for White in centipawns (2), best move (2), flags of the move played (1), reserved (1),
+	 *                 then a CRC-32C of the record (4)
+	 */
+	namespace Annotations {
+		const char Magic[4] = { 'S', 'C', 'N', 0x1A }; /**< The first bytes of every annotation file. */
+		const sf::Uint16 Version = 1; /**< The version this code writes and reads. */
+		const std::size_t HeaderSize = 16; /**< Bytes before the first record. */
+		const std::size_t RecordHeaderSize = 8; /**< Bytes before the positions of a record. */
+		const std::size_t PositionSize = 6; /**< Bytes per position. */
+		const int MistakeMargin = 100, /**< Centipawns a move must lose to be a mistake. */
+				  BlunderMargin = 300, /**< Centipawns a move must lose to be a blunder. */
+				  ScoreCap = 2000; /**< Scores are capped at this when working out what a move lost, so mates do not count for more. */
+		const int DefaultDepth = 8; /**< How deep each position is searched by default. */
+		const int DefaultHash = 16; /**< Transposition table size of each thread in megabytes. */
+
+		/**
+		 * What the move played from a position was.
+		 */
+		enum Flags {
+			Best = 1, /**< The engine's best move. */
+			Mistake = 2, /**< Lost at least MistakeMargin. */
+			Blunder = 4, /**< Lost at least BlunderMargin. */
+			Cut = 8 /**< The move played is broken (see Replay), so the game is only analysed up to here. */
+		};
+
+		/**
+		 * The evaluation of a position.
+		 */
+		class Position {
+		public:
+			sf::Int16 Score = 0; /**< For White, in centipawns. Mates are beyond Engine::Score::MateBound. */
+			Engine::Move16 Best = Engine::NoMove; /**< The engine's best move, or NoMove if the game is over. */
+			sf::Uint8 Flags = 0; /**< Flags of the move that was played. @see Flags */
+		};
+
+		typedef std::map<sf::Uint32, std::vector<Position>> Games; /**< The positions of each analysed game, by game in the archive. */
+
+		/**
+		 * How deep every position is searched. Zero means no limit, but one of them must be set.
+		 */
+		class Limits {
+		public:
+			int Depth = DefaultDepth; /**< Maximum depth. */
+			sf::Uint64 Nodes = 0; /**< Maximum nodes. */
+		};
+
+		/**
+		 * What an analysis did.
+		 */
+		class Stats {
+		public:
+			sf::Uint64 Games = 0, /**< Games analysed. */
+					   Positions = 0, /**< Positions searched. */
+					   Nodes = 0, /**< Nodes searched. */
+					   Resumed = 0, /**< Games found already analysed. */
+					   Blunders = 0; /**< Moves flagged as blunders. */
+		};
+
+		/**
+		 * Reads the annotations of an archive. A last record cut short by a crash is removed from the file.
+		 * @param archive The name of the archive.
+		 * @param limits The limits the annotations must have been made with.
+		 * @param games Where the annotations will be dumped.
+		 * @return False if the archive has no annotations yet.
+		 */
+		bool Load(std::string, const Limits&, Games&);
+
+		/**
+		 * Searches every position of a game up to its first broken move and flags the moves played.
+		 * A position without one of the kings is not searched: the game is over, and the side without a king lost.
+		 * @param engine The engine.
+		 * @param game The game's start.
+		 * @param moves The game's moves.
+		 * @param plies The number of moves.
+		 * @param limits How deep to search.
+		 * @param positions Where the positions will be dumped, one more than there are moves before the first broken one.
+		 * @return The number of nodes searched.
+		 */
+		sf::Uint64 Analyze(Engine::Searcher&, const SCG::Game&, const SCG::MoveSource&, std::size_t, const Limits&, std::vector<Position>&);
+
+		/**
+		 * Analyses every game of an archive that is not in its annotations yet and adds them.
+		 * Games are dealt out to the threads in equal shares, and a thread that runs out takes half of what is left of another's.
+		 * Each game is written out as soon as it is done, so stopping loses at most the games being analysed.
+		 * @param archive The name of the archive.
+		 * @param limits How deep to search.
+		 * @param threads The number of threads, 0 for one per core.
+		 * @param progress Called after every game with the stats so far, from the thread that analysed it.
+		 * @return What was done.
+		 */
+		Stats Run(std::string, const Limits&, int = 0, std::function<void(const Stats&)> = nullptr);
+	};
+};
+
+////////// SOURCE //////////
+
+namespace SimpleChess {
+	namespace Annotations {
+		/**
+		 * The games a thread has left. The thread takes from the front, others steal from the back.
+		 */
+		class WorkQueue {
+		public:
+			std::mutex Lock; /**< Guards Games. */
+			std::deque<sf::Uint32> Games; /**< The games left. */
+		};
+
+		/**
+		 * Gets the next game for a thread, stealing from the others when its own queue is empty.
+		 * @param queues Every thread's queue.
+		 * @param id The thread.
+		 * @param game Where the game will be dumped.
+		 * @return False once every queue is empty.
+		 */
+		inline bool Take(std::vector<std::unique_ptr<WorkQueue>>& queues, std::size_t id, sf::Uint32& game) {
+			{
+				std::lock_guard<std::mutex> lock(queues[id]->Lock);
+				if (not queues[id]->Games.empty()) {
+					game = queues[id]->Games.front();
+					queues[id]->Games.pop_front();
+					return true;
+				}
+			}
+
+			for (std::size_t step = 1; step < queues.size(); step++) {
+				WorkQueue& victim = *queues[(id + step) % queues.size()];
+				std::deque<sf::Uint32> stolen;
+
+				{
+					std::lock_guard<std::mutex> lock(victim.Lock);
+					const std::size_t half = (victim.Games.size() + 1) / 2;
+					stolen.assign(victim.Games.end() - half, victim.Games.end());
+					victim.Games.erase(victim.Games.end() - half, victim.Games.end());
+				}
+
+				if (not stolen.empty()) {
+					game = stolen.front();
+					stolen.pop_front();
+
+					std::lock_guard<std::mutex> lock(queues[id]->Lock);
+					queues[id]->Games.insert(queues[id]->Games.end(), stolen.begin(), stolen.end());
+					return true;
+				}
+			}
+
+			return false;
+		}
+
+		/**
+		 * Caps a score, so mates count as a big advantage and nothing more.
+		 * @param score The score.
+		 * @return The capped score.
+		 */
+		inline int Cap(int score) {
+			return std::min(std::max(score, -ScoreCap), ScoreCap);
+		}
+	};
+};
+
+bool SimpleChess::Annotations::Load(std::string archive, const Limits& limits, Games& games) {
+	std::ifstream in(File::Path + archive + ".ann", std::ios::in | std::ios::binary);
+	if (not in.is_open()) {
+		return false;
+	}
+
+	const std::string data((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+	in.close();
+	const unsigned char* const begin = reinterpret_cast<const unsigned char*>(data.data());
+
+	if (data.size() < HeaderSize or memcmp(begin, Magic, 4) != 0 or SCG::ReadLE(begin + 4, 2) != Version) {
+		FError(false, "ERROR: %s.ann is not a version %d annotation file!", archive.c_str(), Version);
+
+		throw 2;
+		return false;
+	}
+
+	if (static_cast<int>(SCG::ReadLE(begin + 6, 2)) != limits.Depth or SCG::ReadLE(begin + 8, 8) != limits.Nodes) {
+		FError(false, "ERROR: %s.ann was made with depth %d and %d nodes!", archive.c_str(), static_cast<int>(SCG::ReadLE(begin + 6, 2)), static_cast<int>(SCG::ReadLE(begin + 8, 8)));
+
+		throw 2;
+		return false;
+	}
+
+	std::size_t good = HeaderSize;
+	while (data.size() - good >= RecordHeaderSize) {
+		const unsigned char* record = begin + good;
+		const sf::Uint64 count = SCG::ReadLE(record + 4, 4);
+		const sf::Uint64 size = RecordHeaderSize + count * PositionSize + 4;
+
+		if (data.size() - good < size or File::CRC32C(record, static_cast<std::size_t>(size - 4)) != SCG::ReadLE(record + size - 4, 4)) {
+			break;
+		}
+
+		std::vector<Position>& positions = games[static_cast<sf::Uint32>(SCG::ReadLE(record, 4))];
+		positions.resize(static_cast<std::size_t>(count));
+		for (std::size_t i = 0; i < positions.size(); i++) {
+			const unsigned char* position = record + RecordHeaderSize + i * PositionSize;
+			positions[i].Score = static_cast<sf::Int16>(SCG::ReadLE(position, 2));
+			positions[i].Best = static_cast<Engine::Move16>(SCG::ReadLE(position + 2, 2));
+			positions[i].Flags = position[4];
+		}
+
+		good += static_cast<std::size_t>(size);
+	}
+
+	if (good < data.size()) {
+		std::ofstream out(File::Path + archive + ".ann", std::ios::out | std::ios::binary | std::ios::trunc);
+		if (not out.is_open()) {
+			FError(false, "ERROR: %s.ann could not be opened!", archive.c_str());
+
+			throw 1;
+			return false;
+		}
+
+		out.write(data.data(), good);
+		FError(false, "ERROR: %s.ann was cut back to its last good record (%d bytes dropped).", archive.c_str(), static_cast<int>(data.size() - good));
+	}
+
+	return true;
+}
+
+sf::Uint64 SimpleChess::Annotations::Analyze(Engine::Searcher& engine, const SCG::Game& game, const SCG::MoveSource& moves, std::size_t plies, const Limits& limits, std::vector<Position>& positions) {
+	Engine::Position position;
+	Engine::MoveList list;
+	Engine::Undo undo;
+	Engine::SearchLimits search;
+	sf::Uint64 nodes = 0;
+
+	// Positions after a broken move could be anything, so the analysis stops before it.
+	std::size_t chess;
+	const std::size_t legal = Replay::FirstBroken(game, moves, plies, chess);
+
+	search.Depth = limits.Depth;
+	search.Nodes = limits.Nodes;
+	positions.assign(legal + 1, Position());
+	Codec::StartPosition(game, position);
+
+	if (legal < plies) {
+		positions[legal].Flags |= Cut;
+	}
+	plies = legal;
+
+	for (std::size_t ply = 0; ply <= plies; ply++) {
+		int score;
+
+		// A captured king ends the game, and the engine needs both kings.
+		const bool captured = position.Kings[1] < 0 or position.Kings[2] < 0;
+		if (not captured) {
+			position.GenerateLegalMoves(list);
+		}
+
+		if (captured) {
+			score = position.Kings[position.SideToMove] < 0 ? -Engine::Score::Mate : Engine::Score::Mate;
+		} else if (list.Size is 0) {
+			score = position.InCheck() ? -Engine::Score::Mate : 0;
+		} else {
+			engine.Start(position, search);
+			engine.Wait();
+
+			Engine::SearchCounters counters;
+			engine.Collect(counters);
+			nodes += counters.Nodes;
+
+			score = engine.BestScore;
+			positions[ply].Best = engine.BestMove;
+		}
+
+		positions[ply].Score = static_cast<sf::Int16>(position.SideToMove is 1 ? score : -score);
+
+		if (ply < plies) {
+			const Engine::Move16 move = moves(ply);
+			position.DoMove(move, undo);
+
+			if (move is positions[ply].Best) {
+				positions[ply].Flags |= Best;
+			}
+		}
+	}
+
+	// What each move lost is the mover's score before it against after it.
+	for (std::size_t ply = 0; ply < plies; ply++) {
+		const int sign = (ply % 2 is 0) is (game.SideToMove is 1) ? 1 : -1;
+		const int lost = sign * (Cap(positions[ply].Score) - Cap(positions[ply + 1].Score));
+
+		if (lost >= BlunderMargin) {
+			positions[ply].Flags |= Blunder;
+		} else if (lost >= MistakeMargin) {
+			positions[ply].Flags |= Mistake;
+		}
+	}
+
+	return nodes;
+}
+
+SimpleChess::Annotations::Stats SimpleChess::Annotations::Run(std::string archive, const Limits& limits, int threads, std::function<void(const Stats&)> progress) {
+	SCG::Directory directory;
+	File::Mapping map;
+	Games done;
+	Stats stats;
+
+	if (limits.Depth <= 0 and limits.Nodes is 0) {
+		FError(false, "ERROR: analysing %s needs a depth or a node limit!", archive.c_str());
+
+		throw 2;
+		return stats;
+	}
+
+	if (not directory.Open(archive)) {
+		FError(false, "ERROR: %s has no directory!", archive.c_str());
+
+		throw 1;
+		return stats;
+	}
+	map.Open(archive);
+
+	// Check every game first, since the threads that analyse them cannot throw.
+	std::vector<SCG::Game> starts(directory.Size());
+	std::vector<SCG::Entry> entries(directory.Size());
+	for (std::size_t i = 0; i < entries.size(); i++) {
+		entries[i] = directory[i];
+		if (entries[i].Offset + SCG::HeaderSize > map.Size()) {
+			FError(false, "ERROR: %s is cut short!", archive.c_str());
+
+			throw 2;
+			return stats;
+		}
+
+		entries[i].Plies = SCG::ReadHeader(map.Data() + entries[i].Offset, archive, starts[i]);
+		if (entries[i].Offset + SCG::HeaderSize + static_cast<sf::Uint64>(entries[i].Plies) * 2 > map.Size()) {
+			FError(false, "ERROR: %s is cut short!", archive.c_str());
+
+			throw 2;
+			return stats;
+		}
+	}
+
+	const bool resumed = Load(archive, limits, done);
+	std::ofstream fl(File::Path + archive + ".ann", std::ios::out | std::ios::binary | (resumed ? std::ios::app : std::ios::trunc));
+	if (not fl.is_open()) {
+		FError(false, "ERROR: %s.ann could not be opened!", archive.c_str());
+
+		throw 1;
+		return stats;
+	}
+
+	if (not resumed) {
+		unsigned char header[HeaderSize] = { 0 };
+		memcpy(header, Magic, 4);
+		SCG::WriteLE(header + 4, Version, 2);
+		SCG::WriteLE(header + 6, static_cast<sf::Uint64>(limits.Depth), 2);
+		SCG::WriteLE(header + 8, limits.Nodes, 8);
+		fl.write(reinterpret_cast<const char*>(header), HeaderSize);
+		fl.flush();
+	}
+
+	// Each thread starts with an equal run of the games that are left.
+	std::vector<sf::Uint32> left;
+	for (sf::Uint32 i = 0; i < entries.size(); i++) {
+		if (done.count(i) and (done[i].size() is entries[i].Plies + 1 or (not done[i].empty() and done[i].size() <= entries[i].Plies and (done[i].back().Flags & Cut)))) {
+			stats.Resumed++;
+		} else {
+			left.push_back(i);
+		}
+	}
+
+	threads = threads > 0 ? threads : std::max<int>(1, std::thread::hardware_concurrency());
+	std::vector<std::unique_ptr<WorkQueue>> queues;
+	for (int t = 0; t < threads; t++) {
+		queues.emplace_back(new WorkQueue());
+		queues.back()->Games.assign(left.begin() + left.size() * t / threads, left.begin() + left.size() * (t + 1) / threads);
+	}
+
+	std::mutex lock;
+	bool failed = false;
+
+	const auto worker = [&](std::size_t id) {
+		Engine::Searcher engine;
+		engine.SetThreads(1);
+		engine.SetHash(DefaultHash);
+
+		std::vector<Position> positions;
+		std::vector<unsigned char> record;
+		sf::Uint32 game;
+
+		while (Take(queues, id, game)) {
+			const unsigned char* moves = map.Data() + entries[game].Offset + SCG::HeaderSize;
+			const SCG::MoveSource source = [moves](std::size_t ply) {
+				return static_cast<Engine::Move16>(SCG::ReadLE(moves + ply * 2, 2));
+			};
+
+			const sf::Uint64 nodes = Analyze(engine, starts[game], source, entries[game].Plies, limits, positions);
+
+			record.assign(RecordHeaderSize + positions.size() * PositionSize + 4, 0);
+			SCG::WriteLE(&record[0], game, 4);
+			SCG::WriteLE(&record[4], positions.size(), 4);
+			sf::Uint64 blunders = 0;
+			for (std::size_t i = 0; i < positions.size(); i++) {
+				unsigned char* position = &record[RecordHeaderSize + i * PositionSize];
+				SCG::WriteLE(position, static_cast<sf::Uint16>(positions[i].Score), 2);
+				SCG::WriteLE(position + 2, positions[i].Best, 2);
+				position[4] = positions[i].Flags;
+				blunders += (positions[i].Flags & Blunder) != 0;
+			}
+			SCG::WriteLE(&record[record.size() - 4], File::CRC32C(record.data(), record.size() - 4), 4);
+
+			std::lock_guard<std::mutex> guard(lock);
+			fl.write(reinterpret_cast<const char*>(record.data()), record.size());
+			fl.flush();
+			failed = failed or not fl;
+
+			stats.Games++;
+			stats.Positions += positions.size();
+			stats.Nodes += nodes;
+			stats.Blunders += blunders;
+
+			if (progress) {
+				progress(stats);
+			}
+		}
+	};
+
+	std::vector<std::thread> workers;
+	for (int t = 1; t < threads; t++) {
+		workers.emplace_back(worker, static_cast<std::size_t>(t));
+	}
+	worker(0);
+
+	for (auto& thread : workers) {
+		thread.join();
+	}
+
+	if (failed) {
+		FError(false, "ERROR: %s.ann could not be written!", archive.c_str());
+
+		throw 1;
+		return stats;
+	}
+
+	return stats;
+}
+
+#endif
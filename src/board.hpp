@@ -76,124 +76,10 @@ namespace SimpleChess {
 	};
 
 	typedef std::array<std::array<short, 8>, 8> Board8; /**< Typedef for board. */
-
-	/**
-	 * The Texture class.
-	 * The images will be loaded into these textures for continuous use.
-	 * SimpleChess::Textures::Initialize must first be called.
-	 */
-	namespace Textures {
-		sf::Texture ChessBoard, /**< The board image (chessboard.png) will be loaded into here. */
-					Enemy_Capture, /**< The enemy capture (red-bordered square) image (enemy_capture.png) will be loaded into here. */
-					Enemy_Move, /**< The enemy move (filled red square) image (enemy_move.png) will be loaded into here. */
-					Valid_Capture, /**< The valid capture (green-bordered square) image (valid_capture.png) will be loaded into here. */
-					Valid_Move; /**< The valid move (filled green square) image (valid_move.png) will be loaded into here. */
-
-		/**
-		 * The SimpleChess::Textures::Black class.
-		 * The black pieces' images will be stored here for use.
-		 */
-		namespace Black {
-			sf::Texture Pawn, /**< The piece image for a Black Pawn (black_pawn.png). */
-						Rook, /**< The piece image for a Black Rook (Castle) (black_rook.png). */
-						Knight, /**< The piece image for a Black Knight (Horse) (black_knight.png). */
-						Bishop, /**< The piece image for a Black Bishop (black_bishop.png). */
-						King, /**< The piece image for a Black King (black_king.png). */
-						Queen; /**< The piece image for a Black Queen (black_queen.png). */
-		};
-
-		/**
-		 * The SimpleChess::Textures::White class.
-		 * The white pieces' images will be stored here for use.
-		 */
-		namespace White {
-			sf::Texture Pawn, /**< The piece image for a White Pawn (white_pawn.png). */
-						Rook, /**< The piece image for a White Rook (Castle) (white_rook.png). */
-						Knight, /**< The piece image for a White Knight (Horse) (white_knight.png). */
-						Bishop, /**< The piece image for a White Bishop (white_bishop.png). */
-						King, /**< The piece image for a White King (white_king.png). */
-						Queen; /**< The piece image for a White Queen (white_queen.png). */
-		};
-
-		/**
-		 * Loads all the textures with their images.
-		 */
-		void Initialize(void);
-	};
 };
 
 ////////// SOURCE //////////
 
-void SimpleChess::Textures::Initialize(void) {
-	if (!ChessBoard.loadFromFile(Resources::GetResource("chessboard.png"))) {
-		exit(EXIT_FAILURE);
-	}
-
-	if (!Black::Pawn.loadFromFile(Resources::GetResource("black_pawn.png"))) {
-		exit(EXIT_FAILURE);
-	}
-
-	if (!Black::Rook.loadFromFile(Resources::GetResource("black_rook.png"))) {
-		exit(EXIT_FAILURE);
-	}
-
-	if (!Black::Knight.loadFromFile(Resources::GetResource("black_knight.png"))) {
-		exit(EXIT_FAILURE);
-	}
-
-	if (!Black::Bishop.loadFromFile(Resources::GetResource("black_bishop.png"))) {
-		exit(EXIT_FAILURE);
-	}
-
-	if (!Black::Queen.loadFromFile(Resources::GetResource("black_queen.png"))) {
-		exit(EXIT_FAILURE);
-	}
-
-	if (!Black::King.loadFromFile(Resources::GetResource("black_king.png"))) {
-		exit(EXIT_FAILURE);
-	}
-
-	if (!White::Pawn.loadFromFile(Resources::GetResource("white_pawn.png"))) {
-		exit(EXIT_FAILURE);
-	}
-
-	if (!White::Rook.loadFromFile(Resources::GetResource("white_rook.png"))) {
-		exit(EXIT_FAILURE);
-	}
-
-	if (!White::Knight.loadFromFile(Resources::GetResource("white_knight.png"))) {
-		exit(EXIT_FAILURE);
-	}
-
-	if (!White::Bishop.loadFromFile(Resources::GetResource("white_bishop.png"))) {
-		exit(EXIT_FAILURE);
-	}
-
-	if (!White::Queen.loadFromFile(Resources::GetResource("white_queen.png"))) {
-		exit(EXIT_FAILURE);
-	}
-
-	if (!White::King.loadFromFile(Resources::GetResource("white_king.png"))) {
-		exit(EXIT_FAILURE);
-	}
-
-	if (!Valid_Move.loadFromFile(Resources::GetResource("valid_move.png"))) {
-		exit(EXIT_FAILURE);
-	}
-
-	if (!Valid_Capture.loadFromFile(Resources::GetResource("valid_capture.png"))) {
-		exit(EXIT_FAILURE);
-	}
-
-	if (!Enemy_Move.loadFromFile(Resources::GetResource("enemy_move.png"))) {
-		exit(EXIT_FAILURE);
-	}
-
-	if (!Enemy_Capture.loadFromFile(Resources::GetResource("enemy_capture.png"))) {
-		exit(EXIT_FAILURE);
-	}
-}
-
 bool SimpleChess::Pieces::isEmpty(const short piece) {
 	return piece == 0;
 }
@@ -0,0 +1,723 @@
+/*
+ *  codec.hpp
+ *  SimpleChess
+ *
+ *  Copyright (c) 2013-2015 Ronak Gajrawala. All rights reserved.
+ */
+
+#ifndef SimpleChess_codec_hpp
+#define SimpleChess_codec_hpp
+
+namespace SimpleChess {
+	/**
+	 * The Codec class.
+	 * Packs an archive (.sca) into a compressed archive (.scz). Each move is stored as its rank among the moves
+	 * the move generator gives, best looking first, and the ranks are range coded with an adaptive model. The
+	 * ranks come from pseudo-legal moves, so decoding a move is one DoMove rather than a legality check of every
+	 * move in the position. Games are grouped into
+	 * blocks that each start with a fresh model, so one game can be read by decoding only its block.
+	 *
+	 *   offset  size  field
+	 *        0     4  magic "SCZ" 0x1A
+	 *        4     2  version
+	 *        6     2  games per block
+	 *        8     8  number of games
+	 *       16     8  offset of the block table
+	 *       24     .  blocks
+	 *        .   8*b  block table: offset of each block
+	 *
+	 * In a block each game is: a bit for a standard start (otherwise the board as 64 4-bit pieces, the side to
+	 * move, the castling rights and the en passant square), the date (64 bits), the result (2 bits), then one
+	 * symbol per move: the move's rank + 1, Escape followed by 16 bits for a move the generator does not give,
+	 * and 0 after the last move.
+	 */
+	namespace Codec {
+		const char Magic[4] = { 'S', 'C', 'Z', 0x1A }; /**< The first bytes of every .scz file. */
+		const sf::Uint16 Version = 1; /**< The version this code writes and reads. */
+		const std::size_t HeaderSize = 24; /**< Bytes before the first block. */
+		const sf::Uint16 DefaultGamesPerBlock = 16; /**< Games per block. */
+		const int Escape = 255; /**< The symbol for a move stored whole. */
+
+		/**
+		 * Writes bits with a binary range coder.
+		 */
+		class Encoder {
+		public:
+			/**
+			 * @param out Where the bytes will be appended.
+			 */
+			explicit Encoder(std::vector<unsigned char>&);
+
+			/**
+			 * Writes a bit and teaches the model.
+			 * @param probability The model: the chance of a 0 bit out of 2048.
+			 * @param bit The bit.
+			 */
+			void Bit(sf::Uint16&, int);
+
+			/**
+			 * Writes bits that are as likely to be 0 as 1.
+			 * @param value The bits.
+			 * @param count How many bits, at most 32.
+			 */
+			void Direct(sf::Uint32, int);
+
+			/**
+			 * Writes the bytes still held back. Call it once at the end.
+			 */
+			void Finish(void);
+
+		private:
+			/**
+			 * Moves the top byte of Low out.
+			 */
+			void ShiftLow(void);
+
+			std::vector<unsigned char>& Out; /**< Where the bytes go. */
+			sf::Uint64 Low = 0; /**< Bottom of the range, with a carry bit. */
+			sf::Uint32 Range = 0xFFFFFFFF; /**< Size of the range. */
+			sf::Uint8 Cache = 0; /**< A byte held back until it is known not to get a carry. */
+			sf::Uint64 CacheSize = 1; /**< Cache plus the 0xFF bytes held back behind it. */
+		};
+
+		/**
+		 * Reads bits written by an Encoder.
+		 */
+		class Decoder {
+		public:
+			/**
+			 * @param data The first byte.
+			 * @param end One past the last byte. Reading past it gives zeros.
+			 */
+			Decoder(const unsigned char*, const unsigned char*);
+
+			/**
+			 * Reads a bit and teaches the model.
+			 * @param probability The model, as given to Encoder::Bit.
+			 * @return The bit.
+			 */
+			int Bit(sf::Uint16&);
+
+			/**
+			 * Reads bits written by Encoder::Direct.
+			 * @param count How many bits, at most 32.
+			 * @return The bits.
+			 */
+			sf::Uint32 Direct(int);
+
+		private:
+			/**
+			 * Reads the next byte.
+			 * @return The byte or 0 past the end.
+			 */
+			sf::Uint8 Next(void);
+
+			const unsigned char* Data; /**< The next byte. */
+			const unsigned char* End; /**< One past the last byte. */
+			sf::Uint32 Range = 0xFFFFFFFF; /**< Size of the range. */
+			sf::Uint32 Code = 0; /**< Where the bits read so far fall in the range. */
+		};
+
+		/**
+		 * The adaptive model for the move symbols: a binary tree of 8-bit symbols.
+		 */
+		class Model {
+		public:
+			Model(void);
+
+			/**
+			 * Writes a symbol.
+			 * @param encoder The encoder.
+			 * @param symbol The symbol (0 to 255).
+			 */
+			void Encode(Encoder&, int);
+
+			/**
+			 * Reads a symbol.
+			 * @param decoder The decoder.
+			 * @return The symbol.
+			 */
+			int Decode(Decoder&);
+
+		private:
+			std::array<sf::Uint16, 256> Probabilities; /**< The chance of a 0 at each node of the tree. */
+		};
+
+		/**
+		 * A compressed archive mapped into memory.
+		 */
+		class Archive {
+		public:
+			/**
+			 * Maps a compressed archive and checks its header. An open archive is closed first.
+			 * @param filename The name of the file to open.
+			 */
+			void Open(std::string);
+
+			/**
+			 * Unmaps the file.
+			 */
+			void Close(void);
+
+			/**
+			 * Counts the games.
+			 * @return The number of games.
+			 */
+			std::size_t Size(void) const;
+
+			/**
+			 * Counts the blocks.
+			 * @return The number of blocks.
+			 */
+			std::size_t Blocks(void) const;
+
+			/**
+			 * Decodes every game of a block.
+			 * @param block The block, from 0.
+			 * @param games Where the games will be dumped.
+			 * @param entries Where each game's date and result will be dumped. Offset and Length are left at 0.
+			 */
+			void ReadBlock(std::size_t, std::vector<SCG::Game>&, std::vector<SCG::Entry>&) const;
+
+			/**
+			 * Decodes one game. Only its block is read, and only up to the game.
+			 * @param index The game, from 0.
+			 * @param game Where the game will be dumped.
+			 * @param entry Where its date and result will be dumped.
+			 */
+			void Read(std::size_t, SCG::Game&, SCG::Entry&) const;
+
+		private:
+			/**
+			 * Finds where a block is in the file.
+			 * @param block The block, from 0.
+			 * @param start Where the block's first byte will be stored.
+			 * @param end Where the offset one past its last byte will be stored.
+			 */
+			void Span(std::size_t, std::size_t&, std::size_t&) const;
+
+			File::Mapping Map; /**< The mapped file. */
+			std::string Name; /**< The file name, for errors. */
+			sf::Uint16 GamesPerBlock = DefaultGamesPerBlock; /**< Games per block. */
+			std::size_t Games = 0; /**< The number of games. */
+			std::size_t Table = 0; /**< Where the block table starts. */
+		};
+
+		/**
+		 * Packs an archive.
+		 * @param input The name of the archive (.sca).
+		 * @param output The name of the compressed archive to write (.scz).
+		 * @param games_per_block Games per block. Fewer decode faster one at a time, more compress better.
+		 * @return The number of games packed.
+		 */
+		std::size_t Pack(std::string, std::string, sf::Uint16 = DefaultGamesPerBlock);
+
+		/**
+		 * Gives the key moves are ranked by, lowest first: captures by most valuable victim, then promotions,
+		 * then quiet moves by how much they improve the piece's square. The move itself breaks ties, so no two
+		 * moves share a key and the rank does not depend on the order the moves were generated in.
+		 * @param position The position.
+		 * @param move The move.
+		 * @return The key. The move is in the low 16 bits.
+		 */
+		sf::Int64 Key(const Engine::Position&, Engine::Move16);
+
+		/**
+		 * Writes one game to a block.
+		 * @param encoder The block's encoder.
+		 * @param model The block's model.
+		 * @param game The game.
+		 * @param entry Its date and result.
+		 */
+		void EncodeGame(Encoder&, Model&, const SCG::Game&, const SCG::Entry&);
+
+		/**
+		 * Reads one game from a block.
+		 * @param decoder The block's decoder.
+		 * @param model The block's model.
+		 * @param game Where the game will be dumped.
+		 * @param entry Where its date and result will be dumped.
+		 */
+		void DecodeGame(Decoder&, Model&, SCG::Game&, SCG::Entry&);
+
+		/**
+		 * Sets up a position from the start of a game.
+		 * @param game The game.
+		 * @param position Where the position will be dumped.
+		 */
+		void StartPosition(const SCG::Game&, Engine::Position&);
+	};
+};
+
+////////// SOURCE //////////
+
+SimpleChess::Codec::Encoder::Encoder(std::vector<unsigned char>& out) : Out(out) {}
+
+void SimpleChess::Codec::Encoder::Bit(sf::Uint16& probability, int bit) {
+	const sf::Uint32 bound = (Range >> 11) * probability;
+
+	if (bit is 0) {
+		Range = bound;
+		probability += (2048 - probability) >> 5;
+	} else {
+		Low += bound;
+		Range -= bound;
+		probability -= probability >> 5;
+	}
+
+	while (Range < (1u << 24)) {
+		Range <<= 8;
+		ShiftLow();
+	}
+}
+
+void SimpleChess::Codec::Encoder::Direct(sf::Uint32 value, int count) {
+	for (int i = count - 1; i >= 0; i--) {
+		Range >>= 1;
+		if ((value >> i) & 1) {
+			Low += Range;
+		}
+
+		while (Range < (1u << 24)) {
+			Range <<= 8;
+			ShiftLow();
+		}
+	}
+}
+
+void SimpleChess::Codec::Encoder::Finish(void) {
+	for (int i = 0; i < 5; i++) {
+		ShiftLow();
+	}
+}
+
+void SimpleChess::Codec::Encoder::ShiftLow(void) {
+	if (static_cast<sf::Uint32>(Low) < 0xFF000000u or (Low >> 32) != 0) {
+		const sf::Uint8 carry = static_cast<sf::Uint8>(Low >> 32);
+		sf::Uint8 byte = Cache;
+
+		do {
+			Out.push_back(static_cast<unsigned char>(byte + carry));
+			byte = 0xFF;
+		} while (--CacheSize != 0);
+
+		Cache = static_cast<sf::Uint8>(Low >> 24);
+	}
+
+	CacheSize++;
+	Low = (Low & 0x00FFFFFF) << 8;
+}
+
+SimpleChess::Codec::Decoder::Decoder(const unsigned char* data, const unsigned char* end) : Data(data), End(end) {
+	for (int i = 0; i < 5; i++) {
+		Code = Code << 8 | Next();
+	}
+}
+
+sf::Uint8 SimpleChess::Codec::Decoder::Next(void) {
+	return Data < End ? *Data++ : 0;
+}
+
+int SimpleChess::Codec::Decoder::Bit(sf::Uint16& probability) {
+	const sf::Uint32 bound = (Range >> 11) * probability;
+	int bit;
+
+	if (Code < bound) {
+		Range = bound;
+		probability += (2048 - probability) >> 5;
+		bit = 0;
+	} else {
+		Code -= bound;
+		Range -= bound;
+		probability -= probability >> 5;
+		bit = 1;
+	}
+
+	while (Range < (1u << 24)) {
+		Range <<= 8;
+		Code = Code << 8 | Next();
+	}
+
+	return bit;
+}
+
+sf::Uint32 SimpleChess::Codec::Decoder::Direct(int count) {
+	sf::Uint32 value = 0;
+
+	for (int i = 0; i < count; i++) {
+		Range >>= 1;
+		const sf::Uint32 bit = Code >= Range ? 1 : 0;
+		Code -= Range & (0 - bit);
+		value = value << 1 | bit;
+
+		while (Range < (1u << 24)) {
+			Range <<= 8;
+			Code = Code << 8 | Next();
+		}
+	}
+
+	return value;
+}
+
+SimpleChess::Codec::Model::Model(void) {
+	Probabilities.fill(1024);
+}
+
+void SimpleChess::Codec::Model::Encode(Encoder& encoder, int symbol) {
+	int node = 1;
+
+	for (int i = 7; i >= 0; i--) {
+		const int bit = (symbol >> i) & 1;
+		encoder.Bit(Probabilities[node], bit);
+		node = node << 1 | bit;
+	}
+}
+
+int SimpleChess::Codec::Model::Decode(Decoder& decoder) {
+	int node = 1;
+
+	while (node < 256) {
+		node = node << 1 | decoder.Bit(Probabilities[node]);
+	}
+
+	return node - 256;
+}
+
+sf::Int64 SimpleChess::Codec::Key(const Engine::Position& position, Engine::Move16 move) {
+	const int from = Engine::FromSquare(move), to = Engine::ToSquare(move);
+	const short piece = position.At(from), victim = position.At(to), type = Engine::TypeOf(piece);
+	const int flip = Engine::SideOf(piece) is 1 ? 0 : 56;
+	int score;
+
+	if (victim != Pieces::Empty or Engine::FlagOf(move) is Engine::MoveFlag::EnPassant) {
+		score = (1 << 20) + Engine::PieceValue[Engine::TypeOf(victim)] * 16 - Engine::PieceValue[type] / 16;
+	} else if (Engine::FlagOf(move) is Engine::MoveFlag::Promotion) {
+		score = (1 << 19) + Engine::PieceValue[Engine::TypeOf(Engine::PromotionOf(move, 1))];
+	} else {
+		score = Engine::PieceSquareTable[type][to ^ flip] - Engine::PieceSquareTable[type][from ^ flip];
+	}
+
+	return static_cast<sf::Int64>(-score) * 65536 + move;
+}
+
+void SimpleChess::Codec::StartPosition(const SCG::Game& game, Engine::Position& position) {
+	position.FromBoard(game.Start, game.SideToMove);
+	position.CastlingRights = game.CastlingRights;
+	position.EnPassant = game.EnPassant;
+	position.Hash = position.ComputeHash();
+}
+
+void SimpleChess::Codec::EncodeGame(Encoder& encoder, Model& model, const SCG::Game& game, const SCG::Entry& entry) {
+	Engine::Position position, standard;
+	Engine::MoveList list;
+	Engine::Undo undo;
+
+	standard.Reset();
+	const bool is_standard = game.Start is standard.Board and game.SideToMove is 1 and game.CastlingRights is standard.CastlingRights and game.EnPassant is -1;
+
+	encoder.Direct(is_standard ? 1 : 0, 1);
+	if (not is_standard) {
+		for (int square = 0; square < 64; square++) {
+			encoder.Direct(static_cast<sf::Uint32>(game.Start[square >> 3][square & 7]), 4);
+		}
+
+		encoder.Direct(game.SideToMove is 2 ? 1 : 0, 1);
+		encoder.Direct(game.CastlingRights, 4);
+		encoder.Direct(static_cast<sf::Uint8>(game.EnPassant), 8);
+	}
+
+	encoder.Direct(static_cast<sf::Uint32>(static_cast<sf::Uint64>(entry.Date) >> 32), 32);
+	encoder.Direct(static_cast<sf::Uint32>(entry.Date), 32);
+	encoder.Direct(entry.Result & 3, 2);
+
+	StartPosition(game, position);
+
+	for (const Engine::Move16 move : game.Moves) {
+		list.Size = 0;
+		position.GenerateMoves(list);
+
+		// The rank is how many moves come before this one. No need to sort them all.
+		const sf::Int64 key = Key(position, move);
+		unsigned short rank = 0;
+		bool found = false;
+
+		for (unsigned short i = 0; i < list.Size; i++) {
+			if (list.Moves[i] is move) {
+				found = true;
+			} else if (Key(position, list.Moves[i]) < key) {
+				rank++;
+			}
+		}
+
+		if (found and rank + 1 < Escape) {
+			model.Encode(encoder, rank + 1);
+			position.DoMove(move, undo);
+		} else {
+			// Not a move here (e.g. from an edited board), so store it whole and carry on from the board.
+			model.Encode(encoder, Escape);
+			encoder.Direct(move, 16);
+
+			Board8 board = position.Board;
+			SCG::Play(board, move);
+			position.FromBoard(board, 3 - position.SideToMove);
+		}
+	}
+
+	model.Encode(encoder, 0);
+}
+
+void SimpleChess::Codec::DecodeGame(Decoder& decoder, Model& model, SCG::Game& game, SCG::Entry& entry) {
+	Engine::Position position;
+	Engine::MoveList list;
+	Engine::Undo undo;
+	std::array<sf::Int64, 256> keys;
+
+	if (decoder.Direct(1)) {
+		position.Reset();
+		game.Start = position.Board;
+		game.SideToMove = 1;
+		game.CastlingRights = position.CastlingRights;
+		game.EnPassant = -1;
+	} else {
+		for (int square = 0; square < 64; square++) {
+			const short piece = static_cast<short>(decoder.Direct(4));
+			game.Start[square >> 3][square & 7] = piece <= Pieces::Black_King ? piece : Pieces::Empty;
+		}
+
+		game.SideToMove = decoder.Direct(1) ? 2 : 1;
+		game.CastlingRights = static_cast<sf::Uint8>(decoder.Direct(4));
+		game.EnPassant = static_cast<sf::Int8>(decoder.Direct(8));
+	}
+
+	entry.Offset = 0;
+	entry.Length = 0;
+	entry.Date = static_cast<sf::Int64>(static_cast<sf::Uint64>(decoder.Direct(32)) << 32 | decoder.Direct(32));
+	entry.Result = static_cast<sf::Uint8>(decoder.Direct(2));
+
+	StartPosition(game, position);
+	game.Moves.clear();
+
+	while (true) {
+		const int symbol = model.Decode(decoder);
+		if (symbol is 0) {
+			break;
+		}
+
+		if (symbol != Escape) {
+			list.Size = 0;
+			position.GenerateMoves(list);
+			if (symbol > list.Size) {
+				FError(false, "ERROR: bad move in a compressed game!");
+
+				throw 2;
+				return;
+			}
+
+			for (unsigned short i = 0; i < list.Size; i++) {
+				keys[i] = Key(position, list.Moves[i]);
+			}
+
+			// Only the move at the rank has to be found, not the whole order.
+			std::nth_element(keys.begin(), keys.begin() + (symbol - 1), keys.begin() + list.Size);
+			const Engine::Move16 move = static_cast<Engine::Move16>(keys[symbol - 1] & 0xFFFF);
+			position.DoMove(move, undo);
+			game.Moves.push_back(move);
+		} else {
+			const Engine::Move16 move = static_cast<Engine::Move16>(decoder.Direct(16));
+			Board8 board = position.Board;
+			SCG::Play(board, move);
+			position.FromBoard(board, 3 - position.SideToMove);
+			game.Moves.push_back(move);
+		}
+	}
+
+	entry.Plies = static_cast<sf::Uint32>(game.Moves.size());
+}
+
+std::size_t SimpleChess::Codec::Pack(std::string input, std::string output, sf::Uint16 games_per_block) {
+	SCG::Directory directory;
+	if (not directory.Open(input)) {
+		FError(false, "ERROR: %s has no directory!", input.c_str());
+
+		throw 1;
+		return 0;
+	}
+
+	std::ofstream fl(File::Path + output, std::ios::out | std::ios::binary | std::ios::trunc);
+	if (not fl.is_open()) {
+		FError(false, "ERROR: %s could not be opened!", output.c_str());
+
+		throw 1;
+		return 0;
+	}
+
+	games_per_block = std::max<sf::Uint16>(games_per_block, 1);
+
+	std::vector<unsigned char> header(HeaderSize, 0), block;
+	std::vector<sf::Uint64> table;
+	sf::Uint64 offset = HeaderSize;
+
+	fl.write(reinterpret_cast<const char*>(header.data()), header.size());
+
+	// The archive is mapped once, not once a game.
+	File::Mapping map;
+	map.Open(input);
+
+	for (std::size_t first = 0; first < directory.Size(); first += games_per_block) {
+		Encoder encoder(block);
+		Model model;
+		SCG::Game game;
+
+		block.clear();
+
+		for (std::size_t index = first; index < directory.Size() and index < first + games_per_block; index++) {
+			const SCG::Entry entry = directory[index];
+			if (entry.Offset + SCG::HeaderSize > map.Size()) {
+				FError(false, "ERROR: %s is cut short!", input.c_str());
+
+				throw 2;
+				return 0;
+			}
+
+			const sf::Uint32 plies = SCG::ReadHeader(map.Data() + entry.Offset, input, game);
+			if (entry.Offset + SCG::HeaderSize + static_cast<sf::Uint64>(plies) * 2 > map.Size()) {
+				FError(false, "ERROR: %s is cut short!", input.c_str());
+
+				throw 2;
+				return 0;
+			}
+
+			const unsigned char* moves = map.Data() + entry.Offset + SCG::HeaderSize;
+			game.Moves.resize(plies);
+			for (std::size_t ply = 0; ply < plies; ply++) {
+				game.Moves[ply] = static_cast<Engine::Move16>(SCG::ReadLE(moves + ply * 2, 2));
+			}
+
+			EncodeGame(encoder, model, game, entry);
+		}
+
+		encoder.Finish();
+		fl.write(reinterpret_cast<const char*>(block.data()), block.size());
+
+		table.push_back(offset);
+		offset += block.size();
+	}
+
+	std::vector<unsigned char> data(table.size() * 8);
+	for (std::size_t i = 0; i < table.size(); i++) {
+		SCG::WriteLE(&data[i * 8], table[i], 8);
+	}
+
+	fl.write(reinterpret_cast<const char*>(data.data()), data.size());
+
+	memcpy(header.data(), Magic, 4);
+	SCG::WriteLE(&header[4], Version, 2);
+	SCG::WriteLE(&header[6], games_per_block, 2);
+	SCG::WriteLE(&header[8], directory.Size(), 8);
+	SCG::WriteLE(&header[16], offset, 8);
+
+	// The header goes in last, so a file cut short while packing is never taken for a whole one.
+	fl.seekp(0);
+	fl.write(reinterpret_cast<const char*>(header.data()), header.size());
+
+	return directory.Size();
+}
+
+void SimpleChess::Codec::Archive::Open(std::string filename) {
+	Close();
+	Map.Open(filename);
+	Name = filename;
+
+	const unsigned char* data = Map.Data();
+	if (Map.Size() < HeaderSize or memcmp(data, Magic, 4) != 0 or SCG::ReadLE(data + 4, 2) != Version or SCG::ReadLE(data + 6, 2) is 0) {
+		Close();
+		FError(false, "ERROR: %s is not a version %d .scz file!", filename.c_str(), Version);
+
+		throw 2;
+		return;
+	}
+
+	GamesPerBlock = static_cast<sf::Uint16>(SCG::ReadLE(data + 6, 2));
+	Games = static_cast<std::size_t>(SCG::ReadLE(data + 8, 8));
+	Table = static_cast<std::size_t>(SCG::ReadLE(data + 16, 8));
+
+	if (Table < HeaderSize or Table > Map.Size() or (Map.Size() - Table) / 8 < Blocks()) {
+		Close();
+		FError(false, "ERROR: %s is cut short!", filename.c_str());
+
+		throw 2;
+		return;
+	}
+}
+
+void SimpleChess::Codec::Archive::Close(void) {
+	Map.Close();
+	Games = 0;
+	Table = 0;
+}
+
+std::size_t SimpleChess::Codec::Archive::Size(void) const {
+	return Games;
+}
+
+std::size_t SimpleChess::Codec::Archive::Blocks(void) const {
+	return (Games + GamesPerBlock - 1) / GamesPerBlock;
+}
+
+void SimpleChess::Codec::Archive::Span(std::size_t block, std::size_t& start, std::size_t& end) const {
+	if (block >= Blocks()) {
+		FError(false, "ERROR: %s has no block %d!", Name.c_str(), static_cast<int>(block));
+
+		throw 2;
+		return;
+	}
+
+	start = static_cast<std::size_t>(SCG::ReadLE(Map.Data() + Table + block * 8, 8));
+	end = block + 1 < Blocks() ? static_cast<std::size_t>(SCG::ReadLE(Map.Data() + Table + (block + 1) * 8, 8)) : Table;
+
+	if (start < HeaderSize or start > end or end > Table) {
+		FError(false, "ERROR: %s not formatted correctly!", Name.c_str());
+
+		throw 2;
+		return;
+	}
+}
+
+void SimpleChess::Codec::Archive::ReadBlock(std::size_t block, std::vector<SCG::Game>& games, std::vector<SCG::Entry>& entries) const {
+	std::size_t start, end;
+	Span(block, start, end);
+
+	const std::size_t first = block * GamesPerBlock, count = std::min<std::size_t>(GamesPerBlock, Games - first);
+	Decoder decoder(Map.Data() + start, Map.Data() + end);
+	Model model;
+
+	games.resize(count);
+	entries.resize(count);
+
+	for (std::size_t i = 0; i < count; i++) {
+		DecodeGame(decoder, model, games[i], entries[i]);
+	}
+}
+
+void SimpleChess::Codec::Archive::Read(std::size_t index, SCG::Game& game, SCG::Entry& entry) const {
+	if (index >= Games) {
+		FError(false, "ERROR: %s has no game %d!", Name.c_str(), static_cast<int>(index));
+
+		throw 2;
+		return;
+	}
+
+	const std::size_t block = index / GamesPerBlock;
+	std::size_t start, end;
+	Span(block, start, end);
+
+	Decoder decoder(Map.Data() + start, Map.Data() + end);
+	Model model;
+
+	// The model learns from every game before this one in the block, so they have to be decoded too.
+	for (std::size_t i = block * GamesPerBlock; i <= index; i++) {
+		DecodeGame(decoder, model, game, entry);
+	}
+}
+
+#endif
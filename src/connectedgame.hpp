@@ -22,10 +22,13 @@ namespace SimpleChess {
 		sf::RenderWindow Window; /**< The window for the app. */
 		sf::Image Icon; /**< The icon for the application. */
 		sf::Sprite Sprite; /**< The Sprite that will load the board and pieces. */
-		SimpleChess::Board8 BoardBackground, /**< The board's background. */
-							Board; /**< The board's pieces. */
+		SimpleChess::Game Game; /**< The game: board, turn, moves and log. */
 
 		sf::TcpSocket Socket; /**< Connection to server. */
+		sf::SocketSelector Selector; /**< Tells if Socket has something to read. */
+		sf::Packet Outgoing; /**< The last move sent to the server. */
+		bool Sending = false; /**< True while part of Outgoing is still to be sent. */
+		short Side = 2; /**< Which player this window plays. simplechess-server says so when the game starts; a game hosted by NewGame is played as Black. */
 
 		/**
 		 * Intializes Window.
@@ -108,6 +111,16 @@ namespace SimpleChess {
 		 */
 		void OnEvent(void);
 
+		/**
+		 * Checks the socket without waiting: sends the rest of Outgoing and plays the server's move when it arrives.
+		 */
+		void Poll(void);
+
+		/**
+		 * Sends the rest of Outgoing, waiting for the socket, so the other side gets the last move before the game ends.
+		 */
+		void SendRest(void);
+
 		/**
 		 * Main function for game.
 		 */
@@ -118,18 +131,9 @@ namespace SimpleChess {
 		 * Anything to do with the board.
 		 */
 		namespace Move {
-			sf::Vector2i Select, /**< The user's selection coordinates. */
-						 Coord, /**< The user's raw current-click coordinates. */
+			sf::Vector2i Coord, /**< The user's raw current-click coordinates. */
 						 Piece; /**< The user's refined current-click coordinates. @see Coord */
 
-			int PlayerTurn = 1; /**< Which player's turn it is. */
-
-			/**
-			 * Sets PlayerTurn back to 1 (White).
-			 * @see PlayerTurn
-			 */
-			void Initialize(void);
-
 			/**
 			 * Refines the raw clicks (Coord) from the user and stores the new, refined values (Piece).
 			 * @see Piece
@@ -138,27 +142,15 @@ namespace SimpleChess {
 			void InitializePiece(void);
 
 			/**
-			 * Sets the user's selection.
-			 * @see Select
-			 * @see Piece
-			 */
-			void InitializeSelect(void);
-
-			/**
-			 * Resets the board's background to empty.
-			 * @see Empty
-			 */
-			void InitializeBoard(void);
-
-			/**
-			 * Handler for player 1's turn.
+			 * Checks the move the other player sent and plays it.
+			 * @param packet The packet with the move.
 			 */
-			void OnPlayer1Turn(void);
+			void OnOpponentTurn(sf::Packet&);
 
 			/**
-			 * Handler for player 2's turn.
+			 * Handler for this window's turn.
 			 */
-			void OnPlayer2Turn(void);
+			void OnOwnTurn(void);
 
 			/**
 			 * Handler for player's turn.
@@ -198,6 +190,13 @@ void SimpleChess::ConnectedGame::Initialize(void) {
 		return;
 	}
 
+	// From here on the socket is only read when Poll finds something to read.
+	Socket.setBlocking(false);
+	Selector.clear();
+	Selector.add(Socket);
+	Sending = false;
+	Side = 2;
+
 	fl.close();
 
 	if (not Font.loadFromFile(Resources::GetResource("sansation.ttf"))) {
@@ -216,40 +215,10 @@ void SimpleChess::ConnectedGame::Initialize(void) {
 	LastMove.setPosition(680.0, 40.0);
 	LastMove.setColor(sf::Color::White);
 
-	for (short y = 0; y < 8; y++) {
-		for (short x = 0; x < 8; x++) {
-			BoardBackground[y][x] = Background::Empty;
-		}
-	}
-
-	Board[0][0] = SimpleChess::Pieces::Black_Rook;
-	Board[0][1] = SimpleChess::Pieces::Black_Knight;
-	Board[0][2] = SimpleChess::Pieces::Black_Bishop;
-	Board[0][3] = SimpleChess::Pieces::Black_Queen;
-	Board[0][4] = SimpleChess::Pieces::Black_King;
-	Board[0][5] = SimpleChess::Pieces::Black_Bishop;
-	Board[0][6] = SimpleChess::Pieces::Black_Knight;
-	Board[0][7] = SimpleChess::Pieces::Black_Rook;
-
-	for (short x = 0; x < 8; x++) {
-		Board[1][x] = SimpleChess::Pieces::Black_Pawn;
-		Board[6][x] = SimpleChess::Pieces::White_Pawn;
-	}
-
-	for (short y = 2; y < 6; y++) {
-		for (short x = 0; x < 8; x++) {
-			Board[y][x] = SimpleChess::Pieces::Empty;
-		}
-	}
-
-	Board[7][0] = SimpleChess::Pieces::White_Rook;
-	Board[7][1] = SimpleChess::Pieces::White_Knight;
-	Board[7][2] = SimpleChess::Pieces::White_Bishop;
-	Board[7][3] = SimpleChess::Pieces::White_Queen;
-	Board[7][4] = SimpleChess::Pieces::White_King;
-	Board[7][5] = SimpleChess::Pieces::White_Bishop;
-	Board[7][6] = SimpleChess::Pieces::White_Knight;
-	Board[7][7] = SimpleChess::Pieces::White_Rook;
+	// Start from the configured position, or the standard one if there is none.
+	Game.Start();
+	Game.Log = SimpleChess::IO::Append;
+	PlayerTurn.setString(Game.Turn is 1 ? "Player 1\'s Turn" : "Player 2\'s Turn");
 
 	Window.create(sf::VideoMode(900, 640), "SimpleChess - Game", sf::Style::Close);
 	Window.setFramerateLimit(10);
@@ -297,7 +266,7 @@ void SimpleChess::ConnectedGame::Display(void) {
 		for (int x = 0; x < 8; x++) {
 			bool isNotEmpty = true;
 
-			switch (BoardBackground.at(y).at(x)) {
+			switch (Game.Background.at(y).at(x)) {
 				case Background::Empty: isNotEmpty = false; break;
 				case Background::Enemy_Capture: Sprite.setTexture(SimpleChess::Textures::Enemy_Capture); break;
 				case Background::Enemy_Move: Sprite.setTexture(SimpleChess::Textures::Enemy_Move); break;
@@ -317,7 +286,7 @@ void SimpleChess::ConnectedGame::Display(void) {
 		for (int x = 0; x < 8; x++) {
 			bool isNotEmpty = true;
 
-			switch (Board.at(y).at(x)) {
+			switch (Game.Board.at(y).at(x)) {
 				case SimpleChess::Pieces::Empty: isNotEmpty = false; break;
 				case SimpleChess::Pieces::Black_Pawn: Sprite.setTexture(SimpleChess::Textures::Black::Pawn); break;
 				case SimpleChess::Pieces::Black_Rook: Sprite.setTexture(SimpleChess::Textures::Black::Rook); break;
@@ -372,51 +341,40 @@ void SimpleChess::ConnectedGame::OnEvent(void) {
 	}
 }
 
-void SimpleChess::ConnectedGame::Main(void) {
-	SimpleChess::File::Clear();
-	Move::Initialize();
-	Initialize();
-
-	while (IsOpen()) {
-		Clear();
-
-		while (GetEvent(Event)) {
-			OnEvent();
-		}
-
-		Display();
+void SimpleChess::ConnectedGame::Poll(void) {
+	// Nothing to read, but part of a move may still have to be sent.
+	if (not Selector.wait(sf::microseconds(1)) and not Sending) {
+		return;
 	}
 
-	Socket.disconnect();
-}
-
-void SimpleChess::ConnectedGame::Move::Initialize(void) {
-	PlayerTurn = 1;
-}
+	if (Sending) {
+		const sf::Socket::Status status = Socket.send(Outgoing);
 
-void SimpleChess::ConnectedGame::Move::InitializePiece(void) {
-	Piece.x = (Coord.x - (Coord.x % 80)) / 80;
-	Piece.y = (Coord.y - (Coord.y % 80)) / 80;
-}
-
-void SimpleChess::ConnectedGame::Move::InitializeSelect(void) {
-	Select = Piece;
-}
+		if (status is sf::Socket::Done) {
+			Sending = false;
+		} else if (status != sf::Socket::Partial) {
+			FError(false, "ERROR: Could not send packet.");
 
-void SimpleChess::ConnectedGame::Move::InitializeBoard(void) {
-	for (int y = 0; y < 8; y++) {
-		for (int x = 0; x < 8; x++) {
-			ConnectedGame::BoardBackground[y][x] = Background::Empty;
+			Socket.disconnect();
+			StartPage::Go = -1;
+			Close();
+			return;
 		}
 	}
-}
 
-void SimpleChess::ConnectedGame::Move::OnPlayer1Turn(void) {
-	InitializeBoard();
+	if (not Selector.isReady(Socket)) {
+		return;
+	}
 
 	sf::Packet packet;
+	const sf::Socket::Status status = Socket.receive(packet);
 
-	if (Socket.receive(packet) != sf::Socket::Done) {
+	if (status is sf::Socket::NotReady or status is sf::Socket::Partial) {
+		// The rest of the packet comes with a later call.
+		return;
+	}
+
+	if (status != sf::Socket::Done) {
 		FError(false, "ERROR: Did not receive packet.");
 
 		Socket.disconnect();
@@ -425,9 +383,27 @@ void SimpleChess::ConnectedGame::Move::OnPlayer1Turn(void) {
 		return;
 	}
 
-	File::Info info;
-	if (not (packet >> info.Piece1 >> info.Piece1Loc.x >> info.Piece1Loc.y >> info.Move >> info.Piece2 >> info.Piece2Loc.x >> info.Piece2Loc.y)) {
-		FError(false, "ERROR: Packet is not formatted correctly.");
+	// simplechess-server starts a game by telling each window which side it plays.
+	if (packet.getDataSize() is 1) {
+		sf::Uint8 side = 0;
+		packet >> side;
+
+		if (side != 1 and side != 2) {
+			FError(false, "ERROR: Packet is not formatted correctly.");
+
+			Socket.disconnect();
+			StartPage::Go = -1;
+			Close();
+			return;
+		}
+
+		Side = side;
+		Window.setTitle(Side is 1 ? "SimpleChess - Game (White)" : "SimpleChess - Game (Black)");
+		return;
+	}
+
+	if (Game.Turn is Side) {
+		FError(false, "ERROR: Received a move out of turn.");
 
 		Socket.disconnect();
 		StartPage::Go = -1;
@@ -435,85 +411,101 @@ void SimpleChess::ConnectedGame::Move::OnPlayer1Turn(void) {
 		return;
 	}
 
-	SimpleChess::Sounds::Music1.play();
+	Move::OnOpponentTurn(packet);
+	if (IsOpen()) {
+		Move::IfGameIsOver();
+	}
+}
 
-	ConnectedGame::Board[info.Piece2Loc.y][info.Piece2Loc.x] = ConnectedGame::Board[info.Piece1Loc.y][info.Piece1Loc.x];
+void SimpleChess::ConnectedGame::SendRest(void) {
+	if (not Sending) {
+		return;
+	}
 
-	if (ConnectedGame::Board[info.Piece2Loc.y][info.Piece2Loc.x] is SimpleChess::Pieces::White_Pawn and info.Piece2Loc.y is 0) {
-		ConnectedGame::Board[info.Piece2Loc.y][info.Piece2Loc.x] = SimpleChess::Pieces::White_Queen;
+	Socket.setBlocking(true);
+	if (Socket.send(Outgoing) != sf::Socket::Done) {
+		FError(false, "ERROR: Could not send packet.");
 	}
+	Socket.setBlocking(false);
+	Sending = false;
+}
 
-	ConnectedGame::Board[info.Piece1Loc.y][info.Piece1Loc.x] = SimpleChess::Pieces::Empty;
+void SimpleChess::ConnectedGame::Main(void) {
+	SimpleChess::IO::Clear();
+	Initialize();
 
-	PlayerTurn = PlayerTurn is 1 ? 2 : 1;
-	ConnectedGame::PlayerTurn.setString("Player 2\'s Turn");
+	while (IsOpen()) {
+		Clear();
+		Poll();
 
-	std::stringstream ss, dss;
+		while (GetEvent(Event)) {
+			OnEvent();
+		}
 
-	if (info.Move is 1) {
-		ss << Utils::PStringify(info.Piece1) << " (" << info.Piece1Loc.x << ", " << info.Piece1Loc.y << ") captured " << Utils::PStringify(info.Piece2) << " (" << info.Piece2Loc.x << ", " << info.Piece2Loc.y << ").";
-	} else {
-		ss << Utils::PStringify(info.Piece1) << " (" << info.Piece1Loc.x << ", " << info.Piece1Loc.y << ") moved to (" << info.Piece2Loc.x << ", " << info.Piece2Loc.y << ").";
+		Display();
 	}
 
-	FLog("%s", ss.str().c_str());
-
-	dss << (unsigned short)info.Piece1 << ' ' << (unsigned short)info.Piece1Loc.x << ' ' << (unsigned short)info.Piece1Loc.y << ' ' << (unsigned short)info.Move << ' ' << (unsigned short)info.Piece2 << ' ' << (unsigned short)info.Piece2Loc.x << ' ' << (unsigned short)info.Piece2Loc.y;
+	SimpleChess::IO::Flush();
+	SimpleChess::IO::Archive(SimpleChess::StartPage::WhoWon);
+	SendRest();
+	Selector.clear();
+	Socket.disconnect();
+}
 
-	SimpleChess::File::Append(dss.str() + "\n");
-	ConnectedGame::LastMove.setString("Last move:\n" + ss.str());
+void SimpleChess::ConnectedGame::Move::InitializePiece(void) {
+	Piece.x = (Coord.x - (Coord.x % 80)) / 80;
+	Piece.y = (Coord.y - (Coord.y % 80)) / 80;
 }
 
-void SimpleChess::ConnectedGame::Move::OnPlayer2Turn(void) {
-	if (ConnectedGame::Board[Piece.y][Piece.x] > 6) {
-		SimpleChess::Sounds::Music2.play();
-		InitializeSelect();
-		InitializeBoard();
-
-		switch (ConnectedGame::Board[Piece.y][Piece.x]) {
-			case SimpleChess::Pieces::Black_Pawn: SimpleChess::Move::ShowBlackPawnPath(ConnectedGame::Board, ConnectedGame::BoardBackground, Piece, true); break;
-			case SimpleChess::Pieces::Black_Rook: SimpleChess::Move::ShowBlackRookPath(ConnectedGame::Board, ConnectedGame::BoardBackground, Piece, true); break;
-			case SimpleChess::Pieces::Black_Knight: SimpleChess::Move::ShowBlackKnightPath(ConnectedGame::Board, ConnectedGame::BoardBackground, Piece, true); break;
-			case SimpleChess::Pieces::Black_Bishop: SimpleChess::Move::ShowBlackBishopPath(ConnectedGame::Board, ConnectedGame::BoardBackground, Piece, true); break;
-			case SimpleChess::Pieces::Black_King: SimpleChess::Move::ShowBlackKingPath(ConnectedGame::Board, ConnectedGame::BoardBackground, Piece, true); break;
-			case SimpleChess::Pieces::Black_Queen: SimpleChess::Move::ShowBlackQueenPath(ConnectedGame::Board, ConnectedGame::BoardBackground, Piece, true); break;
-			default: {}
-		}
-	} else if (ConnectedGame::BoardBackground[Piece.y][Piece.x] is Background::Valid_Move or ConnectedGame::BoardBackground[Piece.y][Piece.x] is Background::Valid_Capture) {
-		SimpleChess::Sounds::Music1.play();
-		std::stringstream ss, dss;
-		short omove = ConnectedGame::BoardBackground[Piece.y][Piece.x];
-		InitializeBoard();
-		short opp = ConnectedGame::Board[Piece.y][Piece.x];
+void SimpleChess::ConnectedGame::Move::OnOpponentTurn(sf::Packet& packet) {
+	File::Info info;
+	if (not (packet >> info.Piece1 >> info.Piece1Loc.x >> info.Piece1Loc.y >> info.Move >> info.Piece2 >> info.Piece2Loc.x >> info.Piece2Loc.y)) {
+		FError(false, "ERROR: Packet is not formatted correctly.");
+
+		Socket.disconnect();
+		StartPage::Go = -1;
+		Close();
+		return;
+	}
 
-		if (Select.y != Piece.y or Select.x != Piece.x) {
-			ConnectedGame::Board[Piece.y][Piece.x] = ConnectedGame::Board[Select.y][Select.x];
+	if (not Game.Play(info)) {
+		FError(false, "ERROR: Received a move that is not allowed.");
 
-			if (ConnectedGame::Board[Piece.y][Piece.x] is SimpleChess::Pieces::Black_Pawn and Piece.y is 7) {
-				ConnectedGame::Board[Piece.y][Piece.x] = SimpleChess::Pieces::Black_Queen;
-			}
+		Socket.disconnect();
+		StartPage::Go = -1;
+		Close();
+		return;
+	}
 
-			ConnectedGame::Board[Select.y][Select.x] = SimpleChess::Pieces::Empty;
-			PlayerTurn = PlayerTurn is 1 ? 2 : 1;
-			ConnectedGame::PlayerTurn.setString("Player 1\'s Turn");
-		}
+	SimpleChess::Sounds::Music1.play();
+	ConnectedGame::PlayerTurn.setString(Game.Turn is 1 ? "Player 1\'s Turn" : "Player 2\'s Turn");
 
-		if (omove is Background::Valid_Capture) {
-			ss << Utils::PStringify(ConnectedGame::Board[Piece.y][Piece.x]) << " (" << Select.x << ", " << Select.y << ") captured " << Utils::PStringify(opp) << " (" << Piece.x << ", " << Piece.y << ").";
-		} else {
-			ss << Utils::PStringify(ConnectedGame::Board[Piece.y][Piece.x]) << " (" << Select.x << ", " << Select.y << ") moved to (" << Piece.x << ", " << Piece.y << ").";
-		}
+	const std::string move = Game.Describe(info);
+	FLog("%s", move.c_str());
+	ConnectedGame::LastMove.setString("Last move:\n" + move);
+}
+
+void SimpleChess::ConnectedGame::Move::OnOwnTurn(void) {
+	File::Info info;
 
-		dss << ConnectedGame::Board[Piece.y][Piece.x] << ' ' << Select.x << ' ' << Select.y << ' ' << (omove is Background::Enemy_Capture ? 1 : 0) << ' ' << opp << ' ' << Piece.x << ' ' << Piece.y;
+	if (Game.SelectPiece(Piece)) {
+		SimpleChess::Sounds::Music2.play();
+	} else if (Game.MoveSelected(Piece, info)) {
+		SimpleChess::Sounds::Music1.play();
+		ConnectedGame::PlayerTurn.setString(Game.Turn is 1 ? "Player 1\'s Turn" : "Player 2\'s Turn");
+
+		const std::string move = Game.Describe(info);
+		FLog("%s", move.c_str());
+		ConnectedGame::LastMove.setString("Last move:\n" + move);
 
-		FLog("%s", ss.str().c_str());
+		Outgoing.clear();
+		Outgoing << info.Piece1 << info.Piece1Loc.x << info.Piece1Loc.y << info.Move << info.Piece2 << info.Piece2Loc.x << info.Piece2Loc.y;
 
-		SimpleChess::File::Append(dss.str() + "\n");
-		ConnectedGame::LastMove.setString("Last move:\n" + ss.str());
+		// Whatever the socket cannot take now is sent by Poll.
+		const sf::Socket::Status status = Socket.send(Outgoing);
+		Sending = status is sf::Socket::Partial;
 
-		sf::Packet packet;
-		packet << (sf::Uint8)ConnectedGame::Board[Piece.y][Piece.x] << (sf::Uint8)Select.x << (sf::Uint8)Select.y << (sf::Uint8)0 << (sf::Uint8)opp << (sf::Uint8)Piece.x << (sf::Uint8)Piece.y;
-		if (Socket.send(packet) != sf::Socket::Done) {
+		if (status != sf::Socket::Done and not Sending) {
 			FError(false, "ERROR: Could not send packet.");
 
 			Socket.disconnect();
@@ -525,35 +517,29 @@ void SimpleChess::ConnectedGame::Move::OnPlayer2Turn(void) {
 }
 
 void SimpleChess::ConnectedGame::Move::MovePiece(void) {
+	// The other player's moves come from Poll.
+	if (Game.Turn != Side) {
+		return;
+	}
+
 	InitializePiece();
-	PlayerTurn is 1 ? OnPlayer1Turn() : OnPlayer2Turn();
-	IfGameIsOver();
+	OnOwnTurn();
+
+	if (IsOpen()) {
+		IfGameIsOver();
+	}
 }
 
 void SimpleChess::ConnectedGame::Move::IfGameIsOver(void) {
-	bool WhiteKingExists = false,
-		 BlackKingExists = false;
+	const short winner = Game.Winner();
 
-	for (int y = 0; y < 8; y++) {
-		for (int x = 0; x < 8; x++) {
-			if (WhiteKingExists and BlackKingExists) {
-				return;
-			}
-
-			if (ConnectedGame::Board[y][x] is SimpleChess::Pieces::Black_King) {
-				BlackKingExists = true;
-			} else if (ConnectedGame::Board[y][x] is SimpleChess::Pieces::White_King) {
-				WhiteKingExists = true;
-			}
-		}
-	}
-
-	if (not BlackKingExists) {
-		SimpleChess::StartPage::SetWhoWon(1);
-	} else if (not WhiteKingExists) {
-		SimpleChess::StartPage::SetWhoWon(2);
+	if (winner is 0) {
+		return;
 	}
 
+	// The winning move may still be partly unsent, and the other side has to see it to end its game too.
+	SendRest();
+	SimpleChess::StartPage::SetWhoWon(winner);
 	ConnectedGame::Close();
 }
 
@@ -15,6 +15,8 @@ namespace SimpleChess {
 	 * This is the class for anything to do with the console.
 	 */
 	namespace Console {
+		void (*Sink)(const char*, std::size_t) = nullptr; /**< If set, log lines are handed to it instead of printed, e.g. by the I/O thread. @see IO::Start */
+
 		/**
 		 * Returns the file name from the path.
 		 * @param file The full file path.
@@ -87,14 +89,25 @@ void SimpleChess::Console::Log(const char* format, ...) {
 }
 
 void SimpleChess::Console::Log(const unsigned short line, const char* file, const char* function, const char* format, ...) {
+	char buffer[1024];
 	va_list args;
 	va_start(args, format);
-	Log("%11s:%-4d [%s] ", ParseFileName(file).c_str(), line, function);
-	vprintf(format, args);
-	if (format[strlen(format) - 1] != '\n') {
-		putchar('\n');
+
+	int size = snprintf(buffer, sizeof(buffer), "%11s:%-4d [%s] ", ParseFileName(file).c_str(), line, function);
+	size += vsnprintf(buffer + size, sizeof(buffer) - size, format, args);
+	size = std::min<int>(size, sizeof(buffer) - 2);
+	if (buffer[size - 1] != '\n') {
+		buffer[size++] = '\n';
+		buffer[size] = '\0';
 	}
+
 	va_end(args);
+
+	if (Sink) {
+		Sink(buffer, size);
+	} else {
+		fwrite(buffer, 1, size, stdout);
+	}
 }
 
 void SimpleChess::Console::Pause(void) {
@@ -0,0 +1,31 @@
+/*
+ *  convert.cpp
+ *  SimpleChess
+ *
+ *  Copyright (c) 2013-2015 Ronak Gajrawala. All rights reserved.
+ */
+
+/*
+ * Converts a text game log to the binary .scg format.
+ * Usage: simplechess-convert [input] [output]
+ */
+
+#include "core.hpp"
+
+int main(int argc, char* argv[]) {
+	const std::string input = argc > 1 ? argv[1] : "log/SimpleChess.log",
+					  output = argc > 2 ? argv[2] : "log/SimpleChess.scg";
+
+	SimpleChess::SCG::Game game;
+
+	try {
+		SimpleChess::SCG::Load(input, game);
+		SimpleChess::SCG::Write(output, game);
+	} catch (int e) {
+		std::cerr << "Could not convert " << input << " to " << output << "." << std::endl;
+		return EXIT_FAILURE;
+	}
+
+	std::cout << "Wrote " << game.Moves.size() << " moves to " << output << "." << std::endl;
+	return 0;
+}
@@ -0,0 +1,98 @@
+/*
+ *  core.hpp
+ *  SimpleChess
+ *
+ *  Copyright (c) 2013-2015 Ronak Gajrawala. All rights reserved.
+ */
+
+#ifndef SimpleChess_core_hpp
+#define SimpleChess_core_hpp
+
+/*
+ * Everything that works without a window: the board, the engine and the log files.
+ * The game (main.hpp) and the headless tools build on top of this.
+ */
+
+#include <cstdio>
+#include <cctype>
+#include <cstdarg>
+#include <cstring>
+#include <cassert>
+#include <cmath>
+#include <cerrno>
+#include <ctime>
+#include <csignal>
+
+#include <iostream>
+#include <string>
+#include <array>
+#include <vector>
+#include <list>
+#include <deque>
+#include <queue>
+#include <map>
+#include <sstream>
+#include <fstream>
+#include <algorithm>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <random>
+
+#if defined(__GNUC__) and (defined(__x86_64__) or defined(__i386__))
+	#include <nmmintrin.h>
+#elif defined(__ARM_FEATURE_CRC32)
+	#include <arm_acle.h>
+#endif
+
+#ifdef _WIN32
+	#define WIN32_LEAN_AND_MEAN
+	#define NOMINMAX
+	#include <windows.h>
+#else
+	#include <fcntl.h>
+	#include <sys/mman.h>
+	#include <sys/stat.h>
+	#include <unistd.h>
+#endif
+
+#ifdef __linux__
+	#include <sys/inotify.h>
+	#include <sys/epoll.h>
+	#include <sys/socket.h>
+	#include <sys/resource.h>
+	#include <netinet/in.h>
+	#include <netinet/tcp.h>
+	#include <netdb.h>
+#endif
+
+#include "SFML/Config.hpp"
+#include "SFML/System.hpp"
+
+#define is ==
+#define ChessMain int main(void) {
+#define ChessMainH ChessMain ChessHoldAtExit;
+#define ChessEnd return 0; }
+#define ChessHoldAtExit atexit(SimpleChess::EndChessMain);
+
+#include "console.hpp"
+#include "board.hpp"
+#include "move.hpp"
+#include "position.hpp"
+#include "search.hpp"
+#include "file.hpp"
+#include "scg.hpp"
+#include "codec.hpp"
+#include "pgn.hpp"
+#include "replay.hpp"
+#include "positions.hpp"
+#include "openings.hpp"
+#include "annotations.hpp"
+#include "utils.hpp"
+#include "game.hpp"
+#include "io.hpp"
+
+#endif
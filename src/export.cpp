@@ -0,0 +1,35 @@
+/*
+ *  export.cpp
+ *  SimpleChess
+ *
+ *  Copyright (c) 2013-2015 Ronak Gajrawala. All rights reserved.
+ */
+
+/*
+ * Exports a game log, a binary game or a whole game archive to PGN.
+ * Usage: simplechess-export [input] [output] [threads]
+ */
+
+#include "core.hpp"
+
+int main(int argc, char* argv[]) {
+	const std::string input = argc > 1 ? argv[1] : "log/SimpleChess.log",
+					  output = argc > 2 ? argv[2] : "log/SimpleChess.pgn";
+	const int threads = argc > 3 ? std::atoi(argv[3]) : 0;
+
+	SimpleChess::Engine::Zobrist::Initialize();
+	sf::Clock clock;
+	SimpleChess::PGN::Stats stats;
+
+	try {
+		stats = SimpleChess::PGN::Export(input, output, threads);
+	} catch (int e) {
+		std::cerr << "Could not export " << input << " to " << output << "." << std::endl;
+		return EXIT_FAILURE;
+	}
+
+	const double seconds = std::max(clock.getElapsedTime().asSeconds(), 1e-6f);
+	std::cout << "Exported " << stats.Games << " games (" << stats.Moves << " moves) to " << output << " in " << seconds << " s." << std::endl
+			  << "Throughput: " << stats.Moves / seconds / 1e6 << "M moves/s" << std::endl;
+	return 0;
+}
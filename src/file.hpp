@@ -33,12 +33,182 @@ namespace SimpleChess {
 
 		typedef std::vector<Info> Information;
 
+		/**
+		 * Writes records to a log file that stays open.
+		 * Records are buffered and written out by the flush policy: after FlushEvery records or once the oldest
+		 * buffered record is FlushInterval milliseconds old, whichever comes first. With both at 0 records are
+		 * only written by Flush and Close, e.g. when the game ends.
+		 */
+		class LogWriter {
+		public:
+			unsigned int FlushEvery = 1; /**< Flush after this many records, or 0 to not count records. */
+			sf::Int32 FlushInterval = 0; /**< Flush once a record has waited this many milliseconds, or 0 to not wait. */
+
+			~LogWriter(void);
+
+			/**
+			 * Opens the file. An open file is closed first.
+			 * @param filename The name of the file to open.
+			 * @param truncate True to empty the file, false to append to it.
+			 */
+			void Open(std::string, bool);
+
+			/**
+			 * Checks if the file is open.
+			 * @return True if the file is open.
+			 */
+			bool IsOpen(void) const;
+
+			/**
+			 * Buffers records and flushes if the policy says so.
+			 * @param str The records.
+			 * @param records How many records str holds.
+			 */
+			void Write(const std::string&, unsigned int = 1);
+
+			/**
+			 * Flushes if the oldest buffered record has waited FlushInterval. Call it regularly, e.g. once a frame.
+			 */
+			void Tick(void);
+
+			/**
+			 * Writes the buffered records to the file.
+			 */
+			void Flush(void);
+
+			/**
+			 * Flushes and closes the file.
+			 */
+			void Close(void);
+
+		private:
+			std::ofstream Stream; /**< The open file. */
+			std::string Buffer; /**< Records not written yet. */
+			unsigned int Pending = 0; /**< Records in Buffer. */
+			sf::Clock Age; /**< Restarted when Buffer gets its first record. */
+		};
+
+		LogWriter GameLog; /**< Writes "SimpleChess.log". */
+
+		/**
+		 * A whole file mapped read-only into memory.
+		 * Nothing is copied: pages are read in by the OS when they are first touched and are shared with the page cache.
+		 */
+		class Mapping {
+		public:
+			Mapping(void) = default;
+			Mapping(const Mapping&) = delete;
+			Mapping& operator=(const Mapping&) = delete;
+			~Mapping(void);
+
+			/**
+			 * Maps the file. A mapped file is closed first.
+			 * @param filename The name of the file to map.
+			 */
+			void Open(std::string);
+
+			/**
+			 * Unmaps the file.
+			 */
+			void Close(void);
+
+			/**
+			 * Checks if a file is mapped.
+			 * @return True if a file is mapped.
+			 */
+			bool IsOpen(void) const;
+
+			/**
+			 * Gets the bytes of the file.
+			 * @return The first byte, or nullptr if the file is empty.
+			 */
+			const unsigned char* Data(void) const;
+
+			/**
+			 * Gets the size of the file.
+			 * @return The number of bytes.
+			 */
+			std::size_t Size(void) const;
+
+		private:
+			const unsigned char* Bytes = nullptr; /**< The mapped bytes. */
+			std::size_t Length = 0; /**< The number of mapped bytes. */
+			bool Opened = false; /**< True while a file is mapped (it may be empty). */
+			#ifdef _WIN32
+				HANDLE FileHandle = INVALID_HANDLE_VALUE; /**< The open file. */
+				HANDLE MapHandle = nullptr; /**< The file mapping object. */
+			#endif
+		};
+
+		/**
+		 * Follows a log as it is written, reading only the records added since the last look.
+		 * On Linux the file is watched with inotify and only read when it changed; elsewhere its size is checked.
+		 */
+		class Follower {
+		public:
+			Follower(void) = default;
+			Follower(const Follower&) = delete;
+			Follower& operator=(const Follower&) = delete;
+			~Follower(void);
+
+			/**
+			 * Starts following a file from its beginning. A followed file is closed first. The file does not have to exist yet.
+			 * @param filename The name of the file.
+			 */
+			void Open(std::string);
+
+			/**
+			 * Stops following the file.
+			 */
+			void Close(void);
+
+			/**
+			 * Checks if a file is followed.
+			 * @return True if a file is followed.
+			 */
+			bool IsOpen(void) const;
+
+			/**
+			 * Reads the records added since the last call. A record whose new line was not written yet waits for the next call.
+			 * @param inf Where the new records will be added.
+			 * @return False if the file got shorter, e.g. a new game started. It is then read again from the beginning on the next call.
+			 */
+			bool Poll(Information&);
+
+		private:
+			/**
+			 * Takes the waiting file events. Only does anything on Linux.
+			 * @return True if the file may have changed since the last call.
+			 */
+			bool Changed(void);
+
+			std::string Filename; /**< The followed file. */
+			sf::Uint64 Offset = 0; /**< Bytes read so far. */
+			std::string Partial; /**< The start of a record whose new line was not written yet. */
+			bool Opened = false; /**< True while a file is followed. */
+			#ifdef __linux__
+				int Notify = -1; /**< The inotify instance. */
+				int Watch = -1; /**< The watch on the file, or -1 while it does not exist. */
+			#endif
+		};
+
 		/**
 		 * Appends str to "SimpleChess.log".
+		 * The file stays open and is flushed by GameLog's policy.
 		 * @param str The string to be appended to the file.
 		 */
 		void Append(std::string);
 
+		/**
+		 * Writes everything appended to "SimpleChess.log" so far. Called when a game ends.
+		 */
+		void Flush(void);
+
+		/**
+		 * Lets GameLog flush records that have waited long enough.
+		 */
+		void Tick(void);
+
 		/**
 		 * Set's the log path.
 		 * @see Path
@@ -47,51 +217,483 @@ namespace SimpleChess {
 		void SetPath(std::string);
 
 		/**
-		 * Clears the file.
+		 * Clears the file and opens it for the new game.
+		 * The flush policy is read from config/log.chessconf.
 		 */
 		void Clear(void);
 
+		/**
+		 * Reads a log writer's flush policy.
+		 * Each line is a setting name followed by its value: "FlushEvery 10" or "FlushInterval 500".
+		 * @param filename The name of the file to read from.
+		 * @param writer Where the policy will be dumped.
+		 * @return False if the file does not exist (the writer keeps its policy).
+		 */
+		bool ReadLogSettings(std::string, SimpleChess::File::LogWriter&);
+
 		/**
 		 * Reads the file into a vector of information.
+		 * Records with a checksum are checked. A bad last record is a write cut short by a crash and is left
+		 * out; a bad record anywhere else is an error.
 		 * @param filename The name of the file to read from.
 		 * @param inf Where the information from the file will be dumped.
 		 */
 		void Read(std::string, SimpleChess::File::Information&);
 
 		/**
-		 * Reads the board config file.
+		 * Computes a CRC-32C (Castagnoli), with the CPU's CRC instruction if it has one.
+		 * @param data The bytes.
+		 * @param size The number of bytes.
+		 * @param crc The CRC of the bytes before these, to continue it.
+		 * @return The CRC.
+		 */
+		sf::Uint32 CRC32C(const void*, std::size_t, sf::Uint32 = 0);
+
+		/**
+		 * Makes a log record: the fields, then " *" and their CRC-32C in hex, then a new line.
+		 * @param fields The record's fields, e.g. "1 4 6 0 0 4 4".
+		 * @return The record.
+		 */
+		std::string Seal(const std::string&);
+
+		/**
+		 * Reads one log record.
+		 * @param begin The first character of the line.
+		 * @param end The end of the line (not including the new line).
+		 * @param info Where the record will be dumped.
+		 * @return False if the record is malformed or its checksum is wrong. Records without a checksum are
+		 *         from older logs and are only checked for format.
+		 */
+		bool ParseRecord(const char*, const char*, SimpleChess::File::Info&);
+
+		/**
+		 * Cuts a log back to its last good record, e.g. after a crash in the middle of a write.
+		 * @param filename The name of the file.
+		 * @return True if anything was cut.
+		 */
+		bool Recover(std::string);
+
+		/**
+		 * Reads a start position: a FEN string, or the older layout of 64 piece numbers (one per square, Black's back rank first, White to move).
+		 * The file is read into a fixed buffer and parsed in place, without allocating.
 		 * @param filename The name of the file to read from.
-		 * @param board Where the board state will be dumped.
+		 * @param position Where the position will be dumped.
 		 */
-		void CreateBoardFromFile(std::string, SimpleChess::Board8&);
+		void ReadStartPosition(std::string, Engine::Position&);
+
+		/**
+		 * Reads the computer player's settings.
+		 * Each line is a setting name followed by its value, e.g. "Threads 2". Unknown names are ignored.
+		 * @see Engine::Settings
+		 * @param filename The name of the file to read from.
+		 * @param settings Where the settings will be dumped.
+		 * @return False if the file does not exist (the computer player is off).
+		 */
+		bool ReadEngineSettings(std::string, SimpleChess::Engine::Settings&);
+
+		/**
+		 * Writes search counters as JSON.
+		 * @param filename The name of the file to write to.
+		 * @param counters The counters.
+		 */
+		void WriteSearchStats(std::string, const SimpleChess::Engine::SearchCounters&);
 	};
 };
 
 ////////// SOURCE //////////
 
+namespace SimpleChess {
+	namespace File {
+		/**
+		 * Checks if a line has nothing but spaces.
+		 * @param begin The first character.
+		 * @param end The end of the line.
+		 * @return True if the line is blank.
+		 */
+		inline bool IsBlank(const char* begin, const char* end) {
+			for (; begin < end; begin++) {
+				if (*begin != ' ' and *begin != '\t' and *begin != '\r') {
+					return false;
+				}
+			}
+
+			return true;
+		}
+
+		#if defined(__GNUC__) and (defined(__x86_64__) or defined(__i386__))
+			/**
+			 * The CRC-32C with SSE4.2. Only called once the CPU is known to have it.
+			 * @see CRC32C
+			 */
+			__attribute__((target("sse4.2"))) inline sf::Uint32 CRC32CHardware(const unsigned char* data, std::size_t size, sf::Uint32 crc) {
+				#ifdef __x86_64__
+					sf::Uint64 wide = crc;
+					for (; size >= 8; data += 8, size -= 8) {
+						sf::Uint64 chunk;
+						memcpy(&chunk, data, 8);
+						wide = _mm_crc32_u64(wide, chunk);
+					}
+					crc = static_cast<sf::Uint32>(wide);
+				#endif
+
+				for (; size > 0; data++, size--) {
+					crc = _mm_crc32_u8(crc, *data);
+				}
+
+				return crc;
+			}
+		#endif
+	};
+};
+
 void SimpleChess::File::SetPath(std::string str) {
 	Path = str;
 }
 
+SimpleChess::File::LogWriter::~LogWriter(void) {
+	Close();
+}
+
+void SimpleChess::File::LogWriter::Open(std::string filename, bool truncate) {
+	Close();
+
+	Stream.open(Path + filename, truncate ? std::ios::out | std::ios::trunc : std::ios::out | std::ios::app);
+	if (not Stream.is_open()) {
+		FError(false, "ERROR: %s could not be opened!", filename.c_str());
+
+		throw 1;
+		return;
+	}
+
+	Buffer.reserve(4096);
+}
+
+bool SimpleChess::File::LogWriter::IsOpen(void) const {
+	return Stream.is_open();
+}
+
+void SimpleChess::File::LogWriter::Write(const std::string& str, unsigned int records) {
+	if (Buffer.empty()) {
+		Age.restart();
+	}
+
+	Buffer += str;
+	Pending += records;
+
+	if (FlushEvery > 0 and Pending >= FlushEvery) {
+		Flush();
+	} else {
+		Tick();
+	}
+}
+
+void SimpleChess::File::LogWriter::Tick(void) {
+	if (not Buffer.empty() and FlushInterval > 0 and Age.getElapsedTime().asMilliseconds() >= FlushInterval) {
+		Flush();
+	}
+}
+
+void SimpleChess::File::LogWriter::Flush(void) {
+	if (Buffer.empty() or not Stream.is_open()) {
+		return;
+	}
+
+	Stream.write(Buffer.data(), Buffer.size());
+	Stream.flush();
+	Buffer.clear();
+	Pending = 0;
+}
+
+void SimpleChess::File::LogWriter::Close(void) {
+	if (Stream.is_open()) {
+		Flush();
+		Stream.close();
+	}
+
+	Buffer.clear();
+	Pending = 0;
+}
+
+SimpleChess::File::Mapping::~Mapping(void) {
+	Close();
+}
+
+void SimpleChess::File::Mapping::Open(std::string filename) {
+	Close();
+
+	#ifdef _WIN32
+		FileHandle = CreateFileA((Path + filename).c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+		LARGE_INTEGER size;
+		if (FileHandle is INVALID_HANDLE_VALUE or not GetFileSizeEx(FileHandle, &size)) {
+			Close();
+			FError(false, "ERROR: %s could not be opened!", filename.c_str());
+
+			throw 1;
+			return;
+		}
+
+		Length = static_cast<std::size_t>(size.QuadPart);
+		if (Length > 0) {
+			MapHandle = CreateFileMappingA(FileHandle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+			const void* view = MapHandle ? MapViewOfFile(MapHandle, FILE_MAP_READ, 0, 0, 0) : nullptr;
+			if (not view) {
+				Close();
+				FError(false, "ERROR: %s could not be mapped!", filename.c_str());
+
+				throw 1;
+				return;
+			}
+
+			Bytes = static_cast<const unsigned char*>(view);
+		}
+	#else
+		const int fd = open((Path + filename).c_str(), O_RDONLY);
+		struct stat info;
+		if (fd < 0 or fstat(fd, &info) != 0) {
+			if (fd >= 0) {
+				close(fd);
+			}
+
+			FError(false, "ERROR: %s could not be opened!", filename.c_str());
+
+			throw 1;
+			return;
+		}
+
+		Length = static_cast<std::size_t>(info.st_size);
+		if (Length > 0) {
+			void* view = mmap(nullptr, Length, PROT_READ, MAP_SHARED, fd, 0);
+			if (view is MAP_FAILED) {
+				close(fd);
+				Length = 0;
+				FError(false, "ERROR: %s could not be mapped!", filename.c_str());
+
+				throw 1;
+				return;
+			}
+
+			Bytes = static_cast<const unsigned char*>(view);
+		}
+
+		// The mapping keeps the file alive on its own.
+		close(fd);
+	#endif
+
+	Opened = true;
+}
+
+void SimpleChess::File::Mapping::Close(void) {
+	#ifdef _WIN32
+		if (Bytes) {
+			UnmapViewOfFile(Bytes);
+		}
+
+		if (MapHandle) {
+			CloseHandle(MapHandle);
+			MapHandle = nullptr;
+		}
+
+		if (FileHandle != INVALID_HANDLE_VALUE) {
+			CloseHandle(FileHandle);
+			FileHandle = INVALID_HANDLE_VALUE;
+		}
+	#else
+		if (Bytes) {
+			munmap(const_cast<unsigned char*>(Bytes), Length);
+		}
+	#endif
+
+	Bytes = nullptr;
+	Length = 0;
+	Opened = false;
+}
+
+bool SimpleChess::File::Mapping::IsOpen(void) const {
+	return Opened;
+}
+
+const unsigned char* SimpleChess::File::Mapping::Data(void) const {
+	return Bytes;
+}
+
+std::size_t SimpleChess::File::Mapping::Size(void) const {
+	return Length;
+}
+
 void SimpleChess::File::Clear(void) {
-	std::ofstream(Path + "log/SimpleChess.log", std::ios::out).close();
+	try {
+		ReadLogSettings("config/log.chessconf", GameLog);
+	} catch (int e) {}
+
+	GameLog.Open("log/SimpleChess.log", true);
+}
+
+SimpleChess::File::Follower::~Follower(void) {
+	Close();
+}
+
+void SimpleChess::File::Follower::Open(std::string filename) {
+	Close();
+
+	Filename = filename;
+	Opened = true;
+
+	#ifdef __linux__
+		Notify = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+	#endif
+}
+
+void SimpleChess::File::Follower::Close(void) {
+	#ifdef __linux__
+		if (Notify >= 0) {
+			close(Notify);
+		}
+		Notify = Watch = -1;
+	#endif
+
+	Offset = 0;
+	Partial.clear();
+	Opened = false;
+}
+
+bool SimpleChess::File::Follower::IsOpen(void) const {
+	return Opened;
+}
+
+bool SimpleChess::File::Follower::Changed(void) {
+	#ifdef __linux__
+		if (Notify < 0) {
+			return true;
+		}
+
+		// The watch is made before the file is read, so nothing written in between is missed.
+		if (Watch < 0) {
+			Watch = inotify_add_watch(Notify, (Path + Filename).c_str(), IN_MODIFY | IN_ATTRIB | IN_CLOSE_WRITE | IN_DELETE_SELF | IN_MOVE_SELF);
+			return true;
+		}
+
+		alignas(struct inotify_event) char events[4096];
+		bool changed = false;
+		ssize_t size;
+
+		while ((size = read(Notify, events, sizeof(events))) > 0) {
+			changed = true;
+
+			for (char* at = events; at < events + size; at += sizeof(struct inotify_event) + reinterpret_cast<struct inotify_event*>(at)->len) {
+				const struct inotify_event* event = reinterpret_cast<struct inotify_event*>(at);
+
+				// A file that was deleted or replaced is watched again once it exists.
+				if (event->wd is Watch and (event->mask & (IN_IGNORED | IN_DELETE_SELF | IN_MOVE_SELF))) {
+					inotify_rm_watch(Notify, Watch);
+					Watch = -1;
+				}
+			}
+		}
+
+		return changed;
+	#else
+		return true;
+	#endif
+}
+
+bool SimpleChess::File::Follower::Poll(Information& inf) {
+	if (not Opened or not Changed()) {
+		return true;
+	}
+
+	std::ifstream fl(Path + Filename, std::ios::in | std::ios::binary);
+	const sf::Uint64 size = fl.is_open() and fl.seekg(0, std::ios::end) ? static_cast<sf::Uint64>(fl.tellg()) : 0;
+
+	if (size < Offset) {
+		Offset = 0;
+		Partial.clear();
+
+		// Watched again on the next call, so what is already in the file is read then.
+		#ifdef __linux__
+			if (Watch >= 0) {
+				inotify_rm_watch(Notify, Watch);
+				Watch = -1;
+			}
+		#endif
+		return false;
+	}
+
+	if (size is Offset) {
+		return true;
+	}
+
+	const std::size_t start = Partial.size();
+	Partial.resize(start + static_cast<std::size_t>(size - Offset));
+	fl.seekg(static_cast<std::streamoff>(Offset));
+	fl.read(&Partial[start], static_cast<std::streamsize>(size - Offset));
+	Partial.resize(start + static_cast<std::size_t>(fl.gcount()));
+	Offset += static_cast<sf::Uint64>(fl.gcount());
+
+	const char* line = Partial.data();
+	const char* const end = line + Partial.size();
+	Info info;
+
+	for (const char* next; (next = static_cast<const char*>(memchr(line, '\n', end - line))) != nullptr; line = next + 1) {
+		if (IsBlank(line, next)) {
+			// Nothing to read.
+		} else if (ParseRecord(line, next, info)) {
+			inf.push_back(info);
+		} else {
+			FError(false, "ERROR: %s has a broken record, which was skipped.", Filename.c_str());
+		}
+	}
+
+	Partial.erase(0, line - Partial.data());
+	return true;
 }
 
 void SimpleChess::File::Append(std::string str) {
-	std::ofstream fl(Path + "log/SimpleChess.log", std::ios::out | std::ios::app);
+	if (not GameLog.IsOpen()) {
+		// Appending after a torn record would hide every record after it.
+		Recover("log/SimpleChess.log");
+		GameLog.Open("log/SimpleChess.log", false);
+	}
+
+	GameLog.Write(str);
+}
+
+void SimpleChess::File::Flush(void) {
+	GameLog.Flush();
+}
+
+void SimpleChess::File::Tick(void) {
+	GameLog.Tick();
+}
+
+bool SimpleChess::File::ReadLogSettings(std::string filename, SimpleChess::File::LogWriter& writer) {
+	std::ifstream fl(Path + filename, std::ios::in);
 	if (not fl.is_open()) {
-		FError(false, "ERROR: SimpleChess.log could not be opened!");
+		return false;
+	}
 
-		throw 1;
-		return;
+	std::string name;
+	int value;
+
+	while (fl >> name) {
+		if (not (fl >> value)) {
+			FError(false, "ERROR: %s not formatted correctly!", filename.c_str());
+
+			throw 2;
+			return false;
+		}
+
+		if (name is "FlushEvery") {
+			writer.FlushEvery = static_cast<unsigned int>(std::max(value, 0));
+		} else if (name is "FlushInterval") {
+			writer.FlushInterval = value;
+		}
 	}
 
-	fl << str;
-	fl.close();
+	return true;
 }
 
 void SimpleChess::File::Read(std::string filename, SimpleChess::File::Information& inf) {
-	std::ifstream fl(Path + filename, std::ios::in);
+	std::ifstream fl(Path + filename, std::ios::in | std::ios::binary);
 	if (not fl.is_open()) {
 		FError(false, "ERROR: %s could not be opened!", filename.c_str());
 
@@ -99,15 +701,186 @@ void SimpleChess::File::Read(std::string filename, SimpleChess::File::Informatio
 		return;
 	}
 
-	sf::Uint8 p1, p2, m, c11, c12, c21, c22;
+	const std::string data((std::istreambuf_iterator<char>(fl)), std::istreambuf_iterator<char>());
+	const char* line = data.data();
+	const char* const end = line + data.size();
+	Info info;
+
+	while (line < end) {
+		const char* next = static_cast<const char*>(memchr(line, '\n', end - line));
+		const char* stop = next ? next : end;
+
+		if (IsBlank(line, stop)) {
+			// Nothing to read.
+		} else if (ParseRecord(line, stop, info)) {
+			inf.push_back(info);
+		} else if (next and next + 1 < end) {
+			FError(false, "ERROR: %s not formatted correctly!", filename.c_str());
+
+			throw 2;
+			return;
+		} else {
+			// Only the last record can be torn by a crash.
+			FError(false, "ERROR: %s ends with a broken record, which was skipped.", filename.c_str());
+		}
 
-	while (fl >> p1 >> c11 >> c12 >> m >> p2 >> c21 >> c22) {
-		inf.push_back({ p1, p2, m, { c11, c12 }, { c21, c22 } });
+		line = next ? next + 1 : end;
 	}
 }
 
-void SimpleChess::File::CreateBoardFromFile(std::string filename, SimpleChess::Board8& board) {
-	std::ifstream fl(Path + filename, std::ios::in);
+bool SimpleChess::File::ParseRecord(const char* begin, const char* end, SimpleChess::File::Info& info) {
+	const char* mark = static_cast<const char*>(memchr(begin, '*', end - begin));
+	const char* fields_end = mark ? mark : end;
+
+	while (begin < end and (*begin is ' ' or *begin is '\t')) {
+		begin++;
+	}
+
+	if (mark) {
+		const char* hex = mark + 1;
+		sf::Uint32 expected = 0;
+		int digits = 0;
+
+		for (; hex < end and digits < 8 and isxdigit(static_cast<unsigned char>(*hex)); hex++, digits++) {
+			expected = expected << 4 | static_cast<sf::Uint32>(isdigit(static_cast<unsigned char>(*hex)) ? *hex - '0' : (toupper(static_cast<unsigned char>(*hex)) - 'A' + 10));
+		}
+
+		// The checksum covers the fields without the space before the mark.
+		const char* covered = mark > begin and mark[-1] is ' ' ? mark - 1 : mark;
+		if (digits != 8 or CRC32C(begin, covered - begin) != expected) {
+			return false;
+		}
+	}
+
+	int values[7];
+	const char* p = begin;
+
+	for (int i = 0; i < 7; i++) {
+		while (p < fields_end and (*p is ' ' or *p is '\t')) {
+			p++;
+		}
+
+		if (p is fields_end or not isdigit(static_cast<unsigned char>(*p))) {
+			return false;
+		}
+
+		values[i] = 0;
+		for (; p < fields_end and isdigit(static_cast<unsigned char>(*p)); p++) {
+			values[i] = std::min(values[i] * 10 + (*p - '0'), 1000);
+		}
+	}
+
+	// Read as numbers: sf::Uint8 would read single characters and split "10" in two.
+	const int p1 = values[0], c11 = values[1], c12 = values[2], m = values[3], p2 = values[4], c21 = values[5], c22 = values[6];
+	if (p1 > Pieces::Black_King or p2 > Pieces::Black_King or c11 > 7 or c12 > 7 or c21 > 7 or c22 > 7) {
+		return false;
+	}
+
+	info = { static_cast<sf::Uint8>(p1), static_cast<sf::Uint8>(p2), static_cast<sf::Uint8>(m), { static_cast<sf::Uint8>(c11), static_cast<sf::Uint8>(c12) }, { static_cast<sf::Uint8>(c21), static_cast<sf::Uint8>(c22) } };
+	return true;
+}
+
+std::string SimpleChess::File::Seal(const std::string& fields) {
+	char crc[16];
+	snprintf(crc, sizeof(crc), " *%08X\n", CRC32C(fields.data(), fields.size()));
+	return fields + crc;
+}
+
+bool SimpleChess::File::Recover(std::string filename) {
+	std::ifstream in(Path + filename, std::ios::in | std::ios::binary);
+	if (not in.is_open()) {
+		return false;
+	}
+
+	const std::string data((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+	in.close();
+
+	const char* const begin = data.data();
+	const char* const end = begin + data.size();
+	const char* line = begin;
+	std::size_t good = 0;
+	Info info;
+
+	while (line < end) {
+		const char* next = static_cast<const char*>(memchr(line, '\n', end - line));
+		const char* stop = next ? next : end;
+
+		if (not IsBlank(line, stop) and not ParseRecord(line, stop, info)) {
+			break;
+		}
+
+		line = next ? next + 1 : end;
+		good = line - begin;
+	}
+
+	// A whole last record whose new line never made it gets one, so the next record starts on its own line.
+	const bool newline = good > 0 and begin[good - 1] != '\n';
+	if (good is data.size() and not newline) {
+		return false;
+	}
+
+	std::ofstream out(Path + filename, std::ios::out | std::ios::binary | std::ios::trunc);
+	if (not out.is_open()) {
+		FError(false, "ERROR: %s could not be opened!", filename.c_str());
+
+		throw 1;
+		return false;
+	}
+
+	out.write(begin, good);
+	if (newline) {
+		out.put('\n');
+	}
+
+	FError(false, "ERROR: %s was cut back to its last good record (%d bytes dropped).", filename.c_str(), static_cast<int>(data.size() - good));
+	return true;
+}
+
+sf::Uint32 SimpleChess::File::CRC32C(const void* bytes, std::size_t size, sf::Uint32 crc) {
+	const unsigned char* data = static_cast<const unsigned char*>(bytes);
+	crc = ~crc;
+
+	#if defined(__GNUC__) and (defined(__x86_64__) or defined(__i386__))
+		static const bool hardware = __builtin_cpu_supports("sse4.2");
+		if (hardware) {
+			return ~CRC32CHardware(data, size, crc);
+		}
+	#elif defined(__ARM_FEATURE_CRC32)
+		for (; size >= 8; data += 8, size -= 8) {
+			sf::Uint64 chunk;
+			memcpy(&chunk, data, 8);
+			crc = __crc32cd(crc, chunk);
+		}
+
+		for (; size > 0; data++, size--) {
+			crc = __crc32cb(crc, *data);
+		}
+
+		return ~crc;
+	#endif
+
+	// Byte at a time from a table, for CPUs without the instruction.
+	static const std::array<sf::Uint32, 256> table = [](void) {
+		std::array<sf::Uint32, 256> t;
+		for (sf::Uint32 i = 0; i < 256; i++) {
+			sf::Uint32 c = i;
+			for (int bit = 0; bit < 8; bit++) {
+				c = c & 1 ? (c >> 1) ^ 0x82F63B78u : c >> 1;
+			}
+			t[i] = c;
+		}
+		return t;
+	}();
+
+	for (; size > 0; data++, size--) {
+		crc = table[(crc ^ *data) & 0xFF] ^ (crc >> 8);
+	}
+
+	return ~crc;
+}
+
+void SimpleChess::File::ReadStartPosition(std::string filename, Engine::Position& position) {
+	std::ifstream fl(Path + filename, std::ios::in | std::ios::binary);
 	if (not fl.is_open()) {
 		FError(false, "ERROR: %s could not be opened!", filename.c_str());
 
@@ -115,20 +888,106 @@ void SimpleChess::File::CreateBoardFromFile(std::string filename, SimpleChess::B
 		return;
 	}
 
-	std::array<short, 8> binf;
+	// A FEN string is under 100 characters and the piece numbers under 200, so anything longer is not a position.
+	char text[256];
+	fl.read(text, sizeof(text) - 1);
+	const std::size_t size = static_cast<std::size_t>(fl.gcount());
+	text[size] = '\0';
 
-	for (short c = 0; c < 8; c++) {
-		if (not (fl >> binf.at(0) >> binf.at(1) >> binf.at(2) >> binf.at(3) >> binf.at(4) >> binf.at(5) >> binf.at(6) >> binf.at(7))) {
+	const char* p = text;
+	while (*p and std::isspace(static_cast<unsigned char>(*p))) {
+		p++;
+	}
+
+	if (memchr(text, '/', size) != NULL) {
+		if (size is sizeof(text) - 1 or not position.FromFEN(p)) {
 			FError(false, "ERROR: %s not formatted correctly!", filename.c_str());
 
 			throw 2;
 			return;
 		}
+		return;
+	}
+
+	Board8 board;
+	for (int square = 0; square < 64; square++) {
+		while (*p and std::isspace(static_cast<unsigned char>(*p))) {
+			p++;
+		}
+
+		int piece = -1;
+		for (; *p >= '0' and *p <= '9' and piece < 100; p++) {
+			piece = (piece < 0 ? 0 : piece * 10) + (*p - '0');
+		}
+
+		if (piece < Pieces::Empty or piece > Pieces::Black_King or (*p and not std::isspace(static_cast<unsigned char>(*p)))) {
+			FError(false, "ERROR: %s not formatted correctly!", filename.c_str());
+
+			throw 2;
+			return;
+		}
+
+		board[square >> 3][square & 7] = static_cast<short>(piece);
+	}
+
+	position.FromBoard(board, 1);
+}
+
+bool SimpleChess::File::ReadEngineSettings(std::string filename, SimpleChess::Engine::Settings& settings) {
+	std::ifstream fl(Path + filename, std::ios::in);
+	if (not fl.is_open()) {
+		return false;
+	}
+
+	std::string name;
+	int value;
+
+	while (fl >> name) {
+		if (not (fl >> value)) {
+			FError(false, "ERROR: %s not formatted correctly!", filename.c_str());
+
+			throw 2;
+			return false;
+		}
 
-		for (int x = 0; x < 8; x++) {
-			board.at(c).at(x) = binf.at(x);
+		if (name is "Threads") {
+			settings.Threads = value;
+		} else if (name is "Hash") {
+			settings.Hash = value;
+		} else if (name is "Depth") {
+			settings.Depth = value;
+		} else if (name is "MoveTime") {
+			settings.MoveTime = value;
 		}
 	}
+
+	return true;
+}
+
+void SimpleChess::File::WriteSearchStats(std::string filename, const SimpleChess::Engine::SearchCounters& counters) {
+	std::ofstream fl(Path + filename, std::ios::out);
+	if (not fl.is_open()) {
+		FError(false, "ERROR: %s could not be opened!", filename.c_str());
+
+		throw 1;
+		return;
+	}
+
+	fl << "{\n"
+	   << "\t\"searches\": " << counters.Searches << ",\n"
+	   << "\t\"milliseconds\": " << counters.Milliseconds << ",\n"
+	   << "\t\"nodes\": " << counters.Nodes << ",\n"
+	   << "\t\"qnodes\": " << counters.QNodes << ",\n"
+	   << "\t\"nps\": " << counters.NodesPerSecond() << ",\n"
+	   << "\t\"depth\": " << counters.Depth << ",\n"
+	   << "\t\"seldepth\": " << counters.SelDepth << ",\n"
+	   << "\t\"beta_cutoffs\": " << counters.BetaCutoffs << ",\n"
+	   << "\t\"first_move_cutoffs\": " << counters.FirstMoveCutoffs << ",\n"
+	   << "\t\"tt_probes\": " << counters.TTProbes << ",\n"
+	   << "\t\"tt_hits\": " << counters.TTHits << ",\n"
+	   << "\t\"null_move_cutoffs\": " << counters.NullMoveCutoffs << ",\n"
+	   << "\t\"eval_calls\": " << counters.EvalCalls << "\n"
+	   << "}\n";
 }
 
 #endif
@@ -0,0 +1,316 @@
+/*
+ *  game.hpp
+ *  SimpleChess
+ *
+ *  Copyright (c) 2013-2015 Ronak Gajrawala. All rights reserved.
+ */
+
+#ifndef SimpleChess_game_hpp
+#define SimpleChess_game_hpp
+
+namespace SimpleChess {
+	/**
+	 * A game played by the rules of the game windows: the board, whose turn it is, the moves played and where they are logged.
+	 * It needs no window, so a process can hold as many games as it likes. LocalGame, NewGame and ConnectedGame show one
+	 * in their window, and simplechess-server keeps one for every pair of clients.
+	 */
+	class Game {
+	public:
+		typedef std::function<void(const std::string&)> Sink; /**< Takes each move as a sealed line of the text log. */
+
+		Board8 Board = {}, /**< The board's pieces. */
+			   Background = {}; /**< The paths of the selected piece. */
+		short Turn = 1; /**< Which player's turn it is (1 or 2). */
+		sf::Vector2i Select; /**< The selected piece. */
+		SCG::Game Record; /**< The start and the moves played. */
+		Sink Log; /**< Where the moves are logged, e.g. IO::Append. Nothing is logged if it is empty. */
+
+		/**
+		 * Sets the board up and forgets the moves played.
+		 * @param start The start position.
+		 */
+		void Start(const Engine::Position&);
+
+		/**
+		 * Sets the board up from config/default.chessconf, or the standard position if it is missing.
+		 */
+		void Start(void);
+
+		/**
+		 * Selects a piece of the player whose turn it is and shows its paths.
+		 * @param square The piece's square.
+		 * @param isFriendly True to show the paths as Valid_Move and Valid_Capture, false for Enemy_Move and Enemy_Capture.
+		 * @return False if the square has no piece of that player (nothing changes).
+		 */
+		bool SelectPiece(sf::Vector2i, bool = true);
+
+		/**
+		 * Moves the selected piece to a square one of its paths leads to. A pawn reaching the last rank becomes a queen.
+		 * @param square The square.
+		 * @param info Where the move will be dumped.
+		 * @return False if no path leads there (nothing changes).
+		 */
+		bool MoveSelected(sf::Vector2i, File::Info&);
+
+		/**
+		 * Checks a move made somewhere else, e.g. by the other window, and plays it.
+		 * The record also has to name the piece that ends up on the square (a queen for a pawn reaching the last rank) and
+		 * the piece that was captured, as the windows send them.
+		 * @param info The move of the player whose turn it is.
+		 * @return False if the move is not allowed (the game is then unchanged).
+		 */
+		bool Play(const File::Info&);
+
+		/**
+		 * Plays a move of the engine. It is not checked, since the engine also castles and captures en passant.
+		 * @param move The move.
+		 * @param info Where the move will be dumped.
+		 */
+		void Play(Engine::Move16, File::Info&);
+
+		/**
+		 * Lists the moves the player whose turn it is can make, as the windows would send them.
+		 * @param moves Where the moves will be dumped.
+		 */
+		void Moves(File::Information&);
+
+		/**
+		 * Checks if a king was captured.
+		 * @return 1 if White won, 2 if Black won, 0 if the game goes on.
+		 */
+		short Winner(void) const;
+
+		/**
+		 * Resets the paths shown to empty.
+		 */
+		void ClearBackground(void);
+
+		/**
+		 * Describes a move for the player, e.g. "White Pawn (4, 6) moved to (4, 4).".
+		 * @param info The move.
+		 * @return The description.
+		 */
+		static std::string Describe(const File::Info&);
+
+	private:
+		/**
+		 * Plays a move that is allowed: moves the piece, hides the paths, passes the turn on, and records and logs the move.
+		 * @param from The square the piece leaves.
+		 * @param to The square the piece arrives at.
+		 * @param info Where the move will be dumped.
+		 */
+		void Commit(sf::Vector2i, sf::Vector2i, File::Info&);
+
+		/**
+		 * Logs a move if there is a Log.
+		 * @param info The move.
+		 */
+		void Write(const File::Info&) const;
+	};
+};
+
+////////// SOURCE //////////
+
+void SimpleChess::Game::Start(const Engine::Position& start) {
+	Board = start.Board;
+	Turn = start.SideToMove;
+	Select = sf::Vector2i();
+	ClearBackground();
+	SCG::FromText(File::Information(), start, Record);
+}
+
+void SimpleChess::Game::Start(void) {
+	Engine::Position start;
+	try {
+		File::ReadStartPosition("config/default.chessconf", start);
+	} catch (int e) {
+		start.Reset();
+	}
+
+	Start(start);
+}
+
+bool SimpleChess::Game::SelectPiece(sf::Vector2i square, bool isFriendly) {
+	if (square.x < 0 or square.x > 7 or square.y < 0 or square.y > 7) {
+		return false;
+	}
+
+	const short piece = Board[square.y][square.x];
+	if (Turn is 1 ? not Pieces::isWhite(piece) : not Pieces::isBlack(piece)) {
+		return false;
+	}
+
+	Select = square;
+	ClearBackground();
+	SimpleChess::Move::ShowPath(Board, Background, square, isFriendly);
+	return true;
+}
+
+bool SimpleChess::Game::MoveSelected(sf::Vector2i square, File::Info& info) {
+	if (square.x < 0 or square.x > 7 or square.y < 0 or square.y > 7) {
+		return false;
+	}
+
+	const short path = Background[square.y][square.x];
+	if (path != Background::Valid_Move and path != Background::Valid_Capture and path != Background::Enemy_Move and path != Background::Enemy_Capture) {
+		return false;
+	}
+
+	Commit(Select, square, info);
+	return true;
+}
+
+bool SimpleChess::Game::Play(const File::Info& info) {
+	if (info.Piece1Loc.x > 7 or info.Piece1Loc.y > 7 or info.Piece2Loc.x > 7 or info.Piece2Loc.y > 7) {
+		return false;
+	}
+
+	const sf::Vector2i from(info.Piece1Loc.x, info.Piece1Loc.y), to(info.Piece2Loc.x, info.Piece2Loc.y);
+	const short piece = Board[from.y][from.x];
+
+	if (Turn is 1 ? not Pieces::isWhite(piece) : not Pieces::isBlack(piece)) {
+		return false;
+	}
+
+	Board8 background = {};
+	SimpleChess::Move::ShowPath(Board, background, from, true);
+
+	if (background[to.y][to.x] != Background::Valid_Move and background[to.y][to.x] != Background::Valid_Capture) {
+		return false;
+	}
+
+	short moved = piece;
+	if (piece is Pieces::White_Pawn and to.y is 0) {
+		moved = Pieces::White_Queen;
+	} else if (piece is Pieces::Black_Pawn and to.y is 7) {
+		moved = Pieces::Black_Queen;
+	}
+
+	if (info.Piece1 != moved or info.Piece2 != Board[to.y][to.x]) {
+		return false;
+	}
+
+	File::Info played;
+	Commit(from, to, played);
+	return true;
+}
+
+void SimpleChess::Game::Play(Engine::Move16 move, File::Info& info) {
+	const int from = Engine::FromSquare(move), to = Engine::ToSquare(move);
+	const short captured = SCG::Play(Board, move);
+
+	info.Piece1 = static_cast<sf::Uint8>(Board[to >> 3][to & 7]);
+	info.Piece1Loc = sf::Vector2<sf::Uint8>(static_cast<sf::Uint8>(from & 7), static_cast<sf::Uint8>(from >> 3));
+	info.Move = captured is Pieces::Empty ? 0 : 1;
+	info.Piece2 = static_cast<sf::Uint8>(captured);
+	info.Piece2Loc = sf::Vector2<sf::Uint8>(static_cast<sf::Uint8>(to & 7), static_cast<sf::Uint8>(to >> 3));
+
+	ClearBackground();
+	Record.Moves.push_back(move);
+	Turn = Turn is 1 ? 2 : 1;
+	Write(info);
+}
+
+void SimpleChess::Game::Moves(File::Information& moves) {
+	moves.clear();
+
+	for (int y = 0; y < 8; y++) {
+		for (int x = 0; x < 8; x++) {
+			const short piece = Board[y][x];
+			if (Turn is 1 ? not Pieces::isWhite(piece) : not Pieces::isBlack(piece)) {
+				continue;
+			}
+
+			Board8 background = {};
+			SimpleChess::Move::ShowPath(Board, background, sf::Vector2i(x, y), true);
+
+			for (int ty = 0; ty < 8; ty++) {
+				for (int tx = 0; tx < 8; tx++) {
+					if (background[ty][tx] != Background::Valid_Move and background[ty][tx] != Background::Valid_Capture) {
+						continue;
+					}
+
+					File::Info info;
+					info.Piece1 = static_cast<sf::Uint8>(piece);
+					if (piece is Pieces::White_Pawn and ty is 0) {
+						info.Piece1 = Pieces::White_Queen;
+					} else if (piece is Pieces::Black_Pawn and ty is 7) {
+						info.Piece1 = Pieces::Black_Queen;
+					}
+
+					info.Piece1Loc = sf::Vector2<sf::Uint8>(static_cast<sf::Uint8>(x), static_cast<sf::Uint8>(y));
+					info.Piece2 = static_cast<sf::Uint8>(Board[ty][tx]);
+					info.Piece2Loc = sf::Vector2<sf::Uint8>(static_cast<sf::Uint8>(tx), static_cast<sf::Uint8>(ty));
+					info.Move = info.Piece2 is Pieces::Empty ? 0 : 1;
+					moves.push_back(info);
+				}
+			}
+		}
+	}
+}
+
+short SimpleChess::Game::Winner(void) const {
+	bool white = false, black = false;
+
+	for (int y = 0; y < 8; y++) {
+		for (int x = 0; x < 8; x++) {
+			white = white or Board[y][x] is Pieces::White_King;
+			black = black or Board[y][x] is Pieces::Black_King;
+		}
+	}
+
+	return not black ? 1 : (not white ? 2 : 0);
+}
+
+void SimpleChess::Game::ClearBackground(void) {
+	for (int y = 0; y < 8; y++) {
+		for (int x = 0; x < 8; x++) {
+			Background[y][x] = Background::Empty;
+		}
+	}
+}
+
+std::string SimpleChess::Game::Describe(const File::Info& info) {
+	std::stringstream ss;
+
+	if (info.Piece2 != Pieces::Empty) {
+		ss << Utils::PStringify(info.Piece1) << " (" << (unsigned short)info.Piece1Loc.x << ", " << (unsigned short)info.Piece1Loc.y << ") captured " << Utils::PStringify(info.Piece2) << " (" << (unsigned short)info.Piece2Loc.x << ", " << (unsigned short)info.Piece2Loc.y << ").";
+	} else {
+		ss << Utils::PStringify(info.Piece1) << " (" << (unsigned short)info.Piece1Loc.x << ", " << (unsigned short)info.Piece1Loc.y << ") moved to (" << (unsigned short)info.Piece2Loc.x << ", " << (unsigned short)info.Piece2Loc.y << ").";
+	}
+
+	return ss.str();
+}
+
+void SimpleChess::Game::Commit(sf::Vector2i from, sf::Vector2i to, File::Info& info) {
+	short piece = Board[from.y][from.x];
+	if (piece is Pieces::White_Pawn and to.y is 0) {
+		piece = Pieces::White_Queen;
+	} else if (piece is Pieces::Black_Pawn and to.y is 7) {
+		piece = Pieces::Black_Queen;
+	}
+
+	info.Piece1 = static_cast<sf::Uint8>(piece);
+	info.Piece1Loc = sf::Vector2<sf::Uint8>(static_cast<sf::Uint8>(from.x), static_cast<sf::Uint8>(from.y));
+	info.Piece2 = static_cast<sf::Uint8>(Board[to.y][to.x]);
+	info.Piece2Loc = sf::Vector2<sf::Uint8>(static_cast<sf::Uint8>(to.x), static_cast<sf::Uint8>(to.y));
+	info.Move = info.Piece2 is Pieces::Empty ? 0 : 1;
+
+	ClearBackground();
+	Record.Moves.push_back(SCG::FromInfo(info, Board));
+	Turn = Turn is 1 ? 2 : 1;
+	Write(info);
+}
+
+void SimpleChess::Game::Write(const File::Info& info) const {
+	if (not Log) {
+		return;
+	}
+
+	std::stringstream dss;
+	dss << (unsigned short)info.Piece1 << ' ' << (unsigned short)info.Piece1Loc.x << ' ' << (unsigned short)info.Piece1Loc.y << ' ' << (unsigned short)info.Move << ' ' << (unsigned short)info.Piece2 << ' ' << (unsigned short)info.Piece2Loc.x << ' ' << (unsigned short)info.Piece2Loc.y;
+
+	Log(File::Seal(dss.str()));
+}
+
+#endif
@@ -0,0 +1,36 @@
+/*
+ *  import.cpp
+ *  SimpleChess
+ *
+ *  Copyright (c) 2013-2015 Ronak Gajrawala. All rights reserved.
+ */
+
+/*
+ * Imports the games in a PGN file into a game archive, so they can be browsed in the Reader.
+ * Usage: simplechess-import [input] [archive] [threads]
+ */
+
+#include "core.hpp"
+
+int main(int argc, char* argv[]) {
+	const std::string input = argc > 1 ? argv[1] : "log/Games.pgn",
+					  archive = argc > 2 ? argv[2] : "log/Games.sca";
+	const int threads = argc > 3 ? std::atoi(argv[3]) : 0;
+
+	SimpleChess::Engine::Zobrist::Initialize();
+	sf::Clock clock;
+	SimpleChess::PGN::Stats stats;
+
+	try {
+		stats = SimpleChess::PGN::Import(input, archive, threads);
+	} catch (int e) {
+		std::cerr << "Could not import " << input << " to " << archive << "." << std::endl;
+		return EXIT_FAILURE;
+	}
+
+	const double seconds = std::max(clock.getElapsedTime().asSeconds(), 1e-6f);
+	std::cout << "Imported " << stats.Games << " games (" << stats.Moves << " moves) to " << archive << " in " << seconds << " s." << std::endl
+			  << "Skipped " << stats.Skipped << " games with unreadable or no moves." << std::endl
+			  << "Throughput: " << stats.Games / seconds * 60.0 << " games/minute" << std::endl;
+	return 0;
+}
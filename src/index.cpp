@@ -0,0 +1,57 @@
+/*
+ *  index.cpp
+ *  SimpleChess
+ *
+ *  Copyright (c) 2013-2015 Ronak Gajrawala. All rights reserved.
+ */
+
+/*
+ * Builds the position index of a game archive and times lookups in it.
+ * Usage: simplechess-index [archive] [threads]
+ */
+
+#include "core.hpp"
+
+int main(int argc, char* argv[]) {
+	const std::string archive = argc > 1 ? argv[1] : "log/Games.sca";
+	const int threads = argc > 2 ? std::atoi(argv[2]) : 0;
+	const std::size_t lookups = 100000;
+
+	SimpleChess::Engine::Zobrist::Initialize();
+	sf::Clock clock;
+	sf::Uint64 postings = 0;
+	SimpleChess::Positions::Table table;
+
+	try {
+		postings = SimpleChess::Positions::Build(archive, threads);
+		table.Open(archive);
+	} catch (int e) {
+		std::cerr << "Could not index " << archive << "." << std::endl;
+		return EXIT_FAILURE;
+	}
+
+	const double seconds = std::max(clock.getElapsedTime().asSeconds(), 1e-6f);
+	std::cout << "Indexed " << table.Games() << " games (" << postings << " positions) to " << archive << ".pos in " << seconds << " s." << std::endl;
+
+	if (table.Size() is 0) {
+		return 0;
+	}
+
+	// Half the lookups are positions from the index and half are most likely not in it.
+	std::mt19937_64 random(1);
+	std::vector<sf::Uint64> hashes(lookups);
+	for (std::size_t i = 0; i < lookups; i++) {
+		hashes[i] = i % 2 is 0 ? table[random() % table.Size()].Hash : random();
+	}
+
+	std::vector<SimpleChess::Positions::Posting> found;
+	std::size_t hits = 0;
+	clock.restart();
+	for (const auto hash : hashes) {
+		hits += table.Find(hash, found);
+	}
+
+	const double micros = clock.getElapsedTime().asMicroseconds();
+	std::cout << "Lookups: " << micros / lookups << " us each (" << hits << " postings found in " << lookups << " lookups)" << std::endl;
+	return 0;
+}
@@ -0,0 +1,395 @@
+/*
+ *  io.hpp
+ *  SimpleChess
+ *
+ *  Copyright (c) 2013-2015 Ronak Gajrawala. All rights reserved.
+ */
+
+#ifndef SimpleChess_io_hpp
+#define SimpleChess_io_hpp
+
+namespace SimpleChess {
+	/**
+	 * The IO class.
+	 * Moves log writing off the game's thread. The game pushes records into a lock-free ring and a dedicated
+	 * thread writes them out in batches.
+	 */
+	namespace IO {
+		/**
+		 * A fixed-size queue for exactly one producer thread and one consumer thread.
+		 * Push and Pop never lock or allocate.
+		 */
+		template <typename T, std::size_t Capacity>
+		class RingBuffer {
+			static_assert((Capacity & (Capacity - 1)) is 0, "Capacity must be a power of two.");
+
+		public:
+			/**
+			 * Adds an item. Only the producer thread may call this.
+			 * @param item The item.
+			 * @return False if the queue is full (the item is not added).
+			 */
+			bool Push(const T&);
+
+			/**
+			 * Takes the oldest item. Only the consumer thread may call this.
+			 * @param item Where the item will be stored.
+			 * @return False if the queue is empty.
+			 */
+			bool Pop(T&);
+
+			/**
+			 * Counts the queued items. Exact only on the producer or consumer thread.
+			 * @return The number of items.
+			 */
+			std::size_t Size(void) const;
+
+			/**
+			 * Counts the free slots. Only the producer thread may call this; the count can only grow until it pushes again.
+			 * @return The number of items that can be pushed.
+			 */
+			std::size_t Free(void) const;
+
+		private:
+			char PaddingBefore[64]; /**< Keeps Head off the cache line of whatever comes before. */
+			std::atomic<std::size_t> Head{0}; /**< Next item to pop. Written by the consumer. */
+			char PaddingMiddle[64 - sizeof(std::atomic<std::size_t>)]; /**< Keeps Head and Tail on separate cache lines. */
+			std::atomic<std::size_t> Tail{0}; /**< Next slot to fill. Written by the producer. */
+			char PaddingAfter[64 - sizeof(std::atomic<std::size_t>)]; /**< Keeps Tail off the first slot's cache line. */
+			std::array<T, Capacity> Slots; /**< The items. */
+		};
+
+		/**
+		 * One queued piece of output.
+		 */
+		class Record {
+		public:
+			static const sf::Uint8 Append = 0, /**< Text for the game log. */
+								   Console = 1, /**< A line for stdout. */
+								   Clear = 2, /**< Empty the game log for a new game. */
+								   Flush = 3, /**< Write the game log out now. */
+								   Archive = 4; /**< Add the game log to the archive. Data[0] is the result. */
+
+			sf::Uint8 Kind; /**< One of the kinds above. */
+			sf::Uint16 Size; /**< Bytes used in Data. */
+			char Data[252]; /**< The text. Longer text is split over several records. */
+		};
+
+		const std::size_t QueueSize = 4096; /**< Records the queue holds (1 MB). */
+		RingBuffer<Record, QueueSize> Queue; /**< Records waiting for the I/O thread. */
+		std::thread Worker; /**< The I/O thread. */
+		std::atomic<bool> Running(false), /**< True while the I/O thread runs. */
+						  Quit(false); /**< Tells the I/O thread to drain the queue and stop. */
+		std::atomic<sf::Uint64> Pushed(0), /**< Records pushed. */
+								Done(0), /**< Records the I/O thread has finished writing. */
+								Dropped(0), /**< Console records lost because the queue was full. */
+								Writes(0), /**< Batches written. */
+								HighWater(0); /**< Most records ever waiting at once. */
+
+		/**
+		 * Starts the I/O thread and sends console log lines through it. It is stopped at exit.
+		 */
+		void Start(void);
+
+		/**
+		 * Writes everything still queued, stops the I/O thread and writes log/IOStats.json.
+		 */
+		void Stop(void);
+
+		/**
+		 * Queues text. Only the game's thread may call this.
+		 * A console line is dropped whole if the queue has no room for it; every other kind waits for room, since a lost
+		 * move, clear or archive would break the game log.
+		 * @param kind The record kind.
+		 * @param data The text.
+		 * @param size The length of the text.
+		 * @return False if the console line was dropped.
+		 */
+		bool Push(sf::Uint8, const char*, std::size_t);
+
+		/**
+		 * Appends str to "SimpleChess.log" on the I/O thread, or right away if it is not running.
+		 * @see File::Append
+		 * @param str The string to be appended to the file.
+		 */
+		void Append(const std::string&);
+
+		/**
+		 * Clears "SimpleChess.log" for a new game.
+		 * @see File::Clear
+		 */
+		void Clear(void);
+
+		/**
+		 * Writes everything appended so far. Called when a game ends.
+		 * @see File::Flush
+		 */
+		void Flush(void);
+
+		/**
+		 * Appends the game in "SimpleChess.log" to the archive once everything before it is written. Called when a game ends.
+		 * @see SCG::ArchiveLog
+		 * @param result How the game ended, as StartPage::WhoWon.
+		 */
+		void Archive(short);
+
+		/**
+		 * Waits until the I/O thread has written every record pushed so far.
+		 */
+		void Sync(void);
+
+		/**
+		 * The I/O thread.
+		 */
+		void Run(void);
+
+		/**
+		 * Sends a console log line to the I/O thread.
+		 * @see Console::Sink
+		 * @param data The line.
+		 * @param size The length of the line.
+		 */
+		void ConsoleSink(const char*, std::size_t);
+	};
+};
+
+////////// SOURCE //////////
+
+template <typename T, std::size_t Capacity>
+bool SimpleChess::IO::RingBuffer<T, Capacity>::Push(const T& item) {
+	const std::size_t tail = Tail.load(std::memory_order_relaxed);
+	if (tail - Head.load(std::memory_order_acquire) >= Capacity) {
+		return false;
+	}
+
+	Slots[tail & (Capacity - 1)] = item;
+	Tail.store(tail + 1, std::memory_order_release);
+	return true;
+}
+
+template <typename T, std::size_t Capacity>
+bool SimpleChess::IO::RingBuffer<T, Capacity>::Pop(T& item) {
+	const std::size_t head = Head.load(std::memory_order_relaxed);
+	if (head is Tail.load(std::memory_order_acquire)) {
+		return false;
+	}
+
+	item = Slots[head & (Capacity - 1)];
+	Head.store(head + 1, std::memory_order_release);
+	return true;
+}
+
+template <typename T, std::size_t Capacity>
+std::size_t SimpleChess::IO::RingBuffer<T, Capacity>::Size(void) const {
+	return Tail.load(std::memory_order_acquire) - Head.load(std::memory_order_acquire);
+}
+
+template <typename T, std::size_t Capacity>
+std::size_t SimpleChess::IO::RingBuffer<T, Capacity>::Free(void) const {
+	return Capacity - (Tail.load(std::memory_order_relaxed) - Head.load(std::memory_order_acquire));
+}
+
+void SimpleChess::IO::Start(void) {
+	static bool registered = false;
+
+	if (Running) {
+		return;
+	}
+
+	Quit = false;
+	Running = true;
+	Worker = std::thread(Run);
+	Console::Sink = ConsoleSink;
+
+	if (not registered) {
+		atexit(Stop);
+		registered = true;
+	}
+}
+
+void SimpleChess::IO::Stop(void) {
+	if (not Running) {
+		return;
+	}
+
+	Console::Sink = nullptr;
+	Quit = true;
+	Worker.join();
+	Running = false;
+
+	std::ofstream fl(File::Path + "log/IOStats.json", std::ios::out);
+	if (fl.is_open()) {
+		fl << "{\n"
+		   << "\t\"records\": " << Pushed.load() << ",\n"
+		   << "\t\"dropped\": " << Dropped.load() << ",\n"
+		   << "\t\"writes\": " << Writes.load() << ",\n"
+		   << "\t\"high_water\": " << HighWater.load() << ",\n"
+		   << "\t\"capacity\": " << QueueSize << "\n"
+		   << "}\n";
+	}
+}
+
+bool SimpleChess::IO::Push(sf::Uint8 kind, const char* data, std::size_t size) {
+	Record record;
+	record.Kind = kind;
+
+	// Room for every piece is checked first, so a console line is never cut in half.
+	const std::size_t pieces = std::max<std::size_t>(1, (size + sizeof(record.Data) - 1) / sizeof(record.Data));
+	if (kind is Record::Console and Queue.Free() < pieces) {
+		Dropped.fetch_add(pieces, std::memory_order_relaxed);
+		return false;
+	}
+
+	do {
+		record.Size = static_cast<sf::Uint16>(std::min(size, sizeof(record.Data)));
+		memcpy(record.Data, data, record.Size);
+		data += record.Size;
+		size -= record.Size;
+
+		// The I/O thread is behind, so the game waits for it rather than lose part of the log.
+		while (not Queue.Push(record)) {
+			std::this_thread::yield();
+		}
+
+		Pushed.fetch_add(1, std::memory_order_relaxed);
+	} while (size > 0);
+
+	// Only this thread pushes, so a plain load and store is enough.
+	const sf::Uint64 waiting = Queue.Size();
+	if (waiting > HighWater.load(std::memory_order_relaxed)) {
+		HighWater.store(waiting, std::memory_order_relaxed);
+	}
+
+	return true;
+}
+
+void SimpleChess::IO::Append(const std::string& str) {
+	if (Running) {
+		Push(Record::Append, str.data(), str.size());
+	} else {
+		File::Append(str);
+	}
+}
+
+void SimpleChess::IO::Clear(void) {
+	if (Running) {
+		Push(Record::Clear, "", 0);
+	} else {
+		File::Clear();
+	}
+}
+
+void SimpleChess::IO::Flush(void) {
+	if (Running) {
+		Push(Record::Flush, "", 0);
+	} else {
+		File::Flush();
+	}
+}
+
+void SimpleChess::IO::Archive(short result) {
+	if (Running) {
+		const char data = static_cast<char>(result);
+		Push(Record::Archive, &data, 1);
+	} else {
+		File::Flush();
+		SCG::ArchiveLog(result);
+	}
+}
+
+void SimpleChess::IO::Sync(void) {
+	while (Running and Done.load() < Pushed.load()) {
+		sf::sleep(sf::milliseconds(1));
+	}
+}
+
+void SimpleChess::IO::ConsoleSink(const char* data, std::size_t size) {
+	Push(Record::Console, data, size);
+}
+
+void SimpleChess::IO::Run(void) {
+	Record record;
+	std::string log, console;
+	unsigned int lines = 0;
+
+	log.reserve(64 * 1024);
+	console.reserve(64 * 1024);
+
+	// Writes what has been collected as one write per file.
+	auto write = [&](void) {
+		try {
+			if (not log.empty()) {
+				File::GameLog.Write(log, lines);
+			}
+		} catch (int e) {}
+
+		if (not console.empty()) {
+			fwrite(console.data(), 1, console.size(), stdout);
+			fflush(stdout);
+		}
+
+		if (not log.empty() or not console.empty()) {
+			Writes.fetch_add(1, std::memory_order_relaxed);
+		}
+
+		log.clear();
+		console.clear();
+		lines = 0;
+	};
+
+	while (true) {
+		// Read before draining, so everything pushed before Stop is written.
+		const bool quit = Quit.load();
+		sf::Uint64 count = 0;
+
+		while (Queue.Pop(record)) {
+			count++;
+
+			try {
+				switch (record.Kind) {
+					case Record::Append:
+						log.append(record.Data, record.Size);
+						lines += record.Size > 0 and record.Data[record.Size - 1] is '\n' ? 1 : 0;
+						break;
+					case Record::Console:
+						console.append(record.Data, record.Size);
+						break;
+					case Record::Clear:
+						write();
+						File::Clear();
+						break;
+					case Record::Flush:
+						write();
+						File::Flush();
+						break;
+					case Record::Archive:
+						write();
+						File::Flush();
+						SCG::ArchiveLog(record.Data[0]);
+						break;
+					default: {}
+				}
+			} catch (int e) {}
+
+			if (log.size() + console.size() >= 60 * 1024) {
+				write();
+			}
+		}
+
+		write();
+		File::Tick();
+		Done.fetch_add(count);
+
+		if (count is 0) {
+			if (quit) {
+				break;
+			}
+
+			sf::sleep(sf::microseconds(250));
+		}
+	}
+
+	File::GameLog.Flush();
+}
+
+#endif
@@ -0,0 +1,315 @@
+/*
+ *  loadtest.cpp
+ *  SimpleChess
+ *
+ *  Copyright (c) 2013-2015 Ronak Gajrawala. All rights reserved.
+ */
+
+/*
+ * Plays many games at once against simplechess-server and reports how it kept up: the most games played at once,
+ * moves per second and how long moves took to reach the other player.
+ * Every game ends when a king is captured or after the given number of moves, when a player leaves.
+ * Then the server's archive is replayed as simplechess-validate would, so the games it kept have to be readable too.
+ * Usage: simplechess-loadtest [host] [port] [games] [moves per game] [average milliseconds per move] [archive]
+ */
+
+#include "core.hpp"
+#include "server.hpp"
+
+using namespace SimpleChess;
+
+namespace {
+	/**
+	 * One player, choosing a random move it is allowed to make.
+	 */
+	class Bot {
+	public:
+		int Socket = -1; /**< The connection to the server. */
+		short Side = 0; /**< 1 or 2 once the game started. */
+		SimpleChess::Game Game; /**< The bot's copy of the game. */
+		std::string In, /**< Bytes received but not handled yet. */
+					Out; /**< Bytes not sent yet. */
+		sf::Int64 SentAt = 0; /**< When the last move was sent, in microseconds. */
+		bool Done = false, /**< True once the game is over for this bot. */
+			 Quit = false; /**< True if the bot left after the last move. */
+	};
+
+	/**
+	 * Connects to the server.
+	 * @param address Where the server is.
+	 * @return The non-blocking socket, or -1 if it could not connect.
+	 */
+	int Connect(const struct addrinfo* address) {
+		const int socket = ::socket(address->ai_family, SOCK_STREAM | SOCK_CLOEXEC, 0);
+		if (socket < 0) {
+			return -1;
+		}
+
+		if (connect(socket, address->ai_addr, address->ai_addrlen) != 0) {
+			close(socket);
+			return -1;
+		}
+
+		const int on = 1;
+		setsockopt(socket, IPPROTO_TCP, TCP_NODELAY, &on, sizeof(on));
+		fcntl(socket, F_SETFL, fcntl(socket, F_GETFL) | O_NONBLOCK);
+		return socket;
+	}
+
+	/**
+	 * Sends as much of a bot's Out as its socket takes.
+	 * @param bot The bot.
+	 * @return False if the connection broke.
+	 */
+	bool Flush(Bot& bot) {
+		while (not bot.Out.empty()) {
+			const ssize_t sent = send(bot.Socket, bot.Out.data(), bot.Out.size(), MSG_NOSIGNAL);
+
+			if (sent > 0) {
+				bot.Out.erase(0, static_cast<std::size_t>(sent));
+			} else if (sent < 0 and (errno is EAGAIN or errno is EWOULDBLOCK)) {
+				return true;
+			} else if (not (sent < 0 and errno is EINTR)) {
+				return false;
+			}
+		}
+
+		return true;
+	}
+}
+
+int main(int argc, char* argv[]) {
+	const std::string host = argc > 1 ? argv[1] : "127.0.0.1";
+	std::string port = argc > 2 ? argv[2] : "";
+	const std::size_t games = static_cast<std::size_t>(std::max(argc > 3 ? std::atoi(argv[3]) : 2000, 1));
+	const std::size_t plies = static_cast<std::size_t>(std::max(argc > 4 ? std::atoi(argv[4]) : 100, 1));
+	const sf::Int64 think = std::max(argc > 5 ? std::atoi(argv[5]) : 50, 0) * 1000LL;
+	const std::string archive = argc > 6 ? argv[6] : "log/Server.sca";
+
+	if (port.empty()) {
+		std::ifstream fl(File::Path + "config/connection.chessconf", std::ios::in);
+		std::getline(fl, port);
+		std::getline(fl, port);
+	}
+
+	struct addrinfo hints, *address = nullptr;
+	memset(&hints, 0, sizeof(hints));
+	hints.ai_family = AF_UNSPEC;
+	hints.ai_socktype = SOCK_STREAM;
+
+	if (getaddrinfo(host.c_str(), port.c_str(), &hints, &address) != 0 or address is nullptr) {
+		std::cerr << "Could not find " << host << ":" << port << "." << std::endl;
+		return EXIT_FAILURE;
+	}
+
+	if (Server::RaiseSocketLimit() < games * 2 + 16) {
+		std::cerr << "Too many games for the limit of open files (ulimit -n)." << std::endl;
+		return EXIT_FAILURE;
+	}
+
+	Engine::Zobrist::Initialize();
+	Engine::Position start;
+	try {
+		File::ReadStartPosition("config/default.chessconf", start);
+	} catch (int e) {
+		start.Reset();
+	}
+
+	sf::Clock clock;
+	const auto now = [&clock]() {
+		return clock.getElapsedTime().asMicroseconds();
+	};
+
+	// The server pairs clients in the order they connect, so bots 2n and 2n + 1 play each other.
+	std::vector<Bot> bots(games * 2);
+	const int poller = epoll_create1(EPOLL_CLOEXEC);
+
+	for (std::size_t i = 0; i < bots.size(); i++) {
+		bots[i].Socket = Connect(address);
+		if (bots[i].Socket < 0) {
+			std::cerr << "Could not connect client " << i + 1 << " to " << host << ":" << port << "." << std::endl;
+			return EXIT_FAILURE;
+		}
+
+		struct epoll_event event;
+		memset(&event, 0, sizeof(event));
+		event.events = EPOLLIN;
+		event.data.u64 = i;
+		epoll_ctl(poller, EPOLL_CTL_ADD, bots[i].Socket, &event);
+	}
+	freeaddrinfo(address);
+
+	const double connect_time = clock.restart().asSeconds();
+	std::cout << "Connected " << bots.size() << " clients in " << connect_time << " s." << std::endl;
+
+	typedef std::pair<sf::Int64, std::size_t> Timer;
+	std::priority_queue<Timer, std::vector<Timer>, std::greater<Timer>> timers;
+	std::mt19937 random(1);
+	std::vector<float> latencies;
+	latencies.reserve(games * plies);
+
+	std::size_t done = 0, active = 0, peak = 0, finished = 0, limited = 0, broken = 0;
+	sf::Uint64 played = 0;
+	bool paired = true;
+	File::Information moves;
+
+	const auto end = [&](std::size_t i) {
+		Bot& bot = bots[i];
+		if (bot.Done) {
+			return;
+		}
+
+		// A game is counted once, by whichever of its bots ends first.
+		if (not bots[i ^ 1].Done and bot.Side != 0 and bots[i ^ 1].Side != 0) {
+			active--;
+		}
+
+		bot.Done = true;
+		close(bot.Socket);
+		done++;
+	};
+
+	while (done < bots.size()) {
+		const sf::Int64 wait = timers.empty() ? 1000000 : std::max<sf::Int64>(timers.top().first - now(), 0);
+		struct epoll_event events[Server::MaxEvents];
+		const int count = epoll_wait(poller, events, Server::MaxEvents, static_cast<int>((wait + 999) / 1000));
+
+		for (int e = 0; e < count; e++) {
+			const std::size_t i = static_cast<std::size_t>(events[e].data.u64);
+			Bot& bot = bots[i];
+			if (bot.Done) {
+				continue;
+			}
+
+			char buffer[4096];
+			const ssize_t size = recv(bot.Socket, buffer, sizeof(buffer), 0);
+
+			if (size < 0 and (errno is EAGAIN or errno is EWOULDBLOCK or errno is EINTR)) {
+				continue;
+			}
+
+			if (size <= 0) {
+				// The server lets a player go when its game ends or the other player left; anything else means it dropped the game.
+				const bool over = bot.Game.Winner() != 0 or bots[i ^ 1].Done;
+				broken += over ? 0 : 1;
+				end(i);
+				continue;
+			}
+
+			bot.In.append(buffer, static_cast<std::size_t>(size));
+
+			std::size_t at = 0, length = 0;
+			const unsigned char* data = nullptr;
+
+			while (not bot.Done and Server::NextPacket(bot.In, at, data, length)) {
+				File::Info info;
+
+				if (length is 1 and bot.Side is 0) {
+					bot.Side = data[0];
+					bot.Game.Start(start);
+					paired = paired and bot.Side is static_cast<short>(i % 2 + 1);
+
+					if (bots[i ^ 1].Side != 0) {
+						peak = std::max(peak, ++active);
+					}
+				} else if (length is Server::MoveSize and Server::UnpackMove(data, info) and bot.Game.Turn != bot.Side and bot.Game.Play(info)) {
+					played++;
+					if (paired and bots[i ^ 1].SentAt > 0) {
+						latencies.push_back(static_cast<float>(now() - bots[i ^ 1].SentAt) / 1000.0f);
+					}
+
+					if (bot.Game.Winner() != 0) {
+						finished++;
+						end(i);
+						end(i ^ 1);
+						break;
+					}
+				} else {
+					broken++;
+					end(i);
+					break;
+				}
+
+				if (bot.Game.Turn is bot.Side) {
+					// Thinking times vary around the average, or every game would move at the same moment.
+					timers.push(Timer(now() + (think > 0 ? static_cast<sf::Int64>(random() % (2 * think + 1)) : 0), i));
+				}
+			}
+
+			if (not bot.Done) {
+				bot.In.erase(0, at);
+			}
+		}
+
+		// Bots whose thinking time is up make their move.
+		while (not timers.empty() and timers.top().first <= now()) {
+			const std::size_t i = timers.top().second;
+			timers.pop();
+
+			Bot& bot = bots[i];
+			if (bot.Done) {
+				continue;
+			}
+
+			if (bot.Game.Record.Moves.size() >= plies) {
+				bot.Quit = true;
+				limited++;
+				end(i);
+				continue;
+			}
+
+			bot.Game.Moves(moves);
+			if (moves.empty()) {
+				bot.Quit = true;
+				limited++;
+				end(i);
+				continue;
+			}
+
+			const File::Info& info = moves[random() % moves.size()];
+			unsigned char data[Server::MoveSize];
+			Server::PackMove(info, data);
+			bot.Game.Play(info);
+
+			Server::AppendPacket(bot.Out, data, Server::MoveSize);
+			bot.SentAt = now();
+			if (not Flush(bot)) {
+				broken++;
+				end(i);
+			}
+		}
+	}
+
+	close(poller);
+
+	const double seconds = std::max(clock.getElapsedTime().asSeconds(), 1e-6f);
+	std::sort(latencies.begin(), latencies.end());
+	const auto percentile = [&latencies](double p) {
+		return latencies.empty() ? 0.0f : latencies[std::min(latencies.size() - 1, static_cast<std::size_t>(p * latencies.size()))];
+	};
+
+	std::cout << "Played " << games << " games in " << seconds << " s: " << finished << " won, " << limited << " stopped after " << plies << " moves, " << broken << " broken." << std::endl
+			  << "Most games at once: " << peak << std::endl
+			  << "Throughput: " << played / seconds << " moves/s" << std::endl;
+
+	if (paired) {
+		std::cout << "Move latency: median " << percentile(0.5) << " ms, 99th percentile " << percentile(0.99) << " ms, worst " << percentile(1.0) << " ms" << std::endl;
+	} else {
+		std::cout << "Other clients were paired with these, so the move latency is not known." << std::endl;
+	}
+
+	// The server appends a game as soon as it ends, so every won game is in the archive by now.
+	bool valid = true;
+	if (archive != "-") {
+		try {
+			const Replay::Stats stats = Replay::Run(archive);
+			std::cout << "Validated " << archive << ": " << stats.Games << " games, " << stats.Problems.size() << " with a broken move, " << stats.Windows << " leave a king in check" << std::endl;
+			valid = stats.Problems.empty();
+		} catch (int e) {
+			std::cerr << "Could not validate " << archive << "." << std::endl;
+			valid = false;
+		}
+	}
+
+	return broken is 0 and valid ? 0 : EXIT_FAILURE;
+}
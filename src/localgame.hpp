@@ -17,13 +17,19 @@ namespace SimpleChess {
 	namespace LocalGame {
 		sf::Event Event; /**< Where the window's new event will be stored. */
 		sf::Text PlayerTurn, /**< Stores who's turn it is. */
-				 LastMove; /**< Stores the last move. */
+				 LastMove, /**< Stores the last move. */
+				 SearchStats; /**< Stores the computer's search counters. */
 		sf::Font Font; /**< Stores the font file (sansation.ttf) for the text. */
 		sf::RenderWindow Window; /**< The window for the app. */
 		sf::Image Icon; /**< The icon for the application. */
 		sf::Sprite Sprite; /**< The Sprite that will load the board and pieces. */
-		SimpleChess::Board8 BoardBackground, /**< The board's background. */
-							Board; /**< The board's pieces. */
+		SimpleChess::Game Game; /**< The game: board, turn, moves and log. */
+
+		bool ComputerPlays = false; /**< True if Black (Player 2) is played by the computer (config/engine.chessconf exists). */
+		Engine::Settings ComputerSettings; /**< The computer player's settings. */
+		Engine::Searcher Computer; /**< Searches for the computer player's moves. */
+		Engine::SearchCounters GameStats; /**< Search counters summed over the whole game. */
+		Engine::Position GamePosition; /**< The game as the engine sees it. Keeps the hash history for the draw rules. */
 
 		/**
 		 * Intializes Window.
@@ -80,6 +86,11 @@ namespace SimpleChess {
 		 */
 		void Display(void);
 
+		/**
+		 * Refreshes SearchStats with the computer's live search counters.
+		 */
+		void UpdateSearchStats(void);
+
 		/**
 		 * Intializes the board and window.
 		 */
@@ -116,17 +127,10 @@ namespace SimpleChess {
 		 * Anything to do with the board.
 		 */
 		namespace Move {
-			sf::Vector2i Select, /**< The user's selection coordinates. */
-						 Coord, /**< The user's raw current-click coordinates. */
+			sf::Vector2i Coord, /**< The user's raw current-click coordinates. */
 						 Piece; /**< The user's refined current-click coordinates. @see Coord */
 
-			int PlayerTurn = 1; /**< Which player's turn it is. */
-
-			/**
-			 * Sets PlayerTurn back to 1 (White).
-			 * @see PlayerTurn
-			 */
-			void Initialize(void);
+			bool Thinking = false; /**< True while the computer searches. */
 
 			/**
 			 * Refines the raw clicks (Coord) from the user and stores the new, refined values (Piece).
@@ -136,35 +140,31 @@ namespace SimpleChess {
 			void InitializePiece(void);
 
 			/**
-			 * Sets the user's selection.
-			 * @see Select
-			 * @see Piece
+			 * Handler for a player's turn. Player 2's paths are shown in red.
 			 */
-			void InitializeSelect(void);
+			void OnPlayerTurn(void);
 
 			/**
-			 * Resets the board's background to empty.
-			 * @see Empty
+			 * Handler for the computer's turn. Called every frame while it is Black's turn.
+			 * Starts a search and plays its move once it has finished.
 			 */
-			void InitializeBoard(void);
+			void OnComputerTurn(void);
 
 			/**
-			 * Handler for player 1's turn.
-			 */
-			void OnPlayer1Turn(void);
-
-			/**
-			 * Handler for player 2's turn.
+			 * Handler for player's turn.
 			 */
-			void OnPlayer2Turn(void);
+			void MovePiece(void);
 
 			/**
-			 * Handler for player's turn.
+			 * Plays a move from the board on GamePosition.
+			 * If the engine does not know the move, GamePosition starts over from the board and loses its history.
+			 * @param from The square the piece left.
+			 * @param to The square the piece arrived at.
 			 */
-			void MovePiece(void);
+			void Record(sf::Vector2i, sf::Vector2i);
 
 			/**
-			 * Checks if a king is missing and acts accordingly.
+			 * Checks if a king is missing or the game is drawn by repetition or the fifty-move rule and acts accordingly.
 			 */
 			void IfGameIsOver(void);
 		};
@@ -190,40 +190,36 @@ void SimpleChess::LocalGame::Initialize(void) {
 	LastMove.setPosition(680.0, 40.0);
 	LastMove.setColor(sf::Color::White);
 
-	for (short y = 0; y < 8; y++) {
-		for (short x = 0; x < 8; x++) {
-			BoardBackground[y][x] = Background::Empty;
-		}
+	SearchStats.setFont(Font);
+	SearchStats.setString("");
+	SearchStats.setCharacterSize(11);
+	SearchStats.setPosition(680.0, 100.0);
+	SearchStats.setColor(sf::Color::White);
+
+	try {
+		ComputerPlays = File::ReadEngineSettings("config/engine.chessconf", ComputerSettings);
+	} catch (int e) {
+		ComputerPlays = false;
 	}
 
-	Board[0][0] = SimpleChess::Pieces::Black_Rook;
-	Board[0][1] = SimpleChess::Pieces::Black_Knight;
-	Board[0][2] = SimpleChess::Pieces::Black_Bishop;
-	Board[0][3] = SimpleChess::Pieces::Black_Queen;
-	Board[0][4] = SimpleChess::Pieces::Black_King;
-	Board[0][5] = SimpleChess::Pieces::Black_Bishop;
-	Board[0][6] = SimpleChess::Pieces::Black_Knight;
-	Board[0][7] = SimpleChess::Pieces::Black_Rook;
-
-	for (short x = 0; x < 8; x++) {
-		Board[1][x] = SimpleChess::Pieces::Black_Pawn;
-		Board[6][x] = SimpleChess::Pieces::White_Pawn;
+	if (ComputerPlays) {
+		Computer.SetThreads(ComputerSettings.Threads);
+		Computer.SetHash(ComputerSettings.Hash);
+		GameStats = Engine::SearchCounters();
 	}
 
-	for (short y = 2; y < 6; y++) {
-		for (short x = 0; x < 8; x++) {
-			Board[y][x] = SimpleChess::Pieces::Empty;
-		}
+	// Start from the configured position, or the standard one if there is none.
+	Engine::Position start;
+	try {
+		File::ReadStartPosition("config/default.chessconf", start);
+	} catch (int e) {
+		start.Reset();
 	}
 
-	Board[7][0] = SimpleChess::Pieces::White_Rook;
-	Board[7][1] = SimpleChess::Pieces::White_Knight;
-	Board[7][2] = SimpleChess::Pieces::White_Bishop;
-	Board[7][3] = SimpleChess::Pieces::White_Queen;
-	Board[7][4] = SimpleChess::Pieces::White_King;
-	Board[7][5] = SimpleChess::Pieces::White_Bishop;
-	Board[7][6] = SimpleChess::Pieces::White_Knight;
-	Board[7][7] = SimpleChess::Pieces::White_Rook;
+	Game.Start(start);
+	Game.Log = SimpleChess::IO::Append;
+	PlayerTurn.setString(Game.Turn is 1 ? "Player 1\'s Turn" : "Player 2\'s Turn");
+	GamePosition = start;
 
 	Window.create(sf::VideoMode(900, 640), "SimpleChess - Game", sf::Style::Close);
 	Window.setFramerateLimit(10);
@@ -271,7 +267,7 @@ void SimpleChess::LocalGame::Display(void) {
 		for (int x = 0; x < 8; x++) {
 			bool isNotEmpty = true;
 
-			switch (BoardBackground.at(y).at(x)) {
+			switch (Game.Background.at(y).at(x)) {
 				case Background::Empty: isNotEmpty = false; break;
 				case Background::Enemy_Capture: Sprite.setTexture(SimpleChess::Textures::Enemy_Capture); break;
 				case Background::Enemy_Move: Sprite.setTexture(SimpleChess::Textures::Enemy_Move); break;
@@ -291,7 +287,7 @@ void SimpleChess::LocalGame::Display(void) {
 		for (int x = 0; x < 8; x++) {
 			bool isNotEmpty = true;
 
-			switch (Board.at(y).at(x)) {
+			switch (Game.Board.at(y).at(x)) {
 				case SimpleChess::Pieces::Empty: isNotEmpty = false; break;
 				case SimpleChess::Pieces::Black_Pawn: Sprite.setTexture(SimpleChess::Textures::Black::Pawn); break;
 				case SimpleChess::Pieces::Black_Rook: Sprite.setTexture(SimpleChess::Textures::Black::Rook); break;
@@ -318,9 +314,32 @@ void SimpleChess::LocalGame::Display(void) {
 	Draw(PlayerTurn);
 	Draw(LastMove);
 
+	if (ComputerPlays) {
+		UpdateSearchStats();
+		Draw(SearchStats);
+	}
+
 	Print();
 }
 
+void SimpleChess::LocalGame::UpdateSearchStats(void) {
+	Engine::SearchCounters counters;
+	Computer.Collect(counters);
+
+	std::stringstream ss;
+	ss << "Computer (Player 2)" << (Move::Thinking ? " thinking..." : "")
+	   << "\nDepth: " << counters.Depth << " / " << counters.SelDepth
+	   << "\nNodes: " << counters.Nodes
+	   << "\nQNodes: " << counters.QNodes
+	   << "\nNPS: " << counters.NodesPerSecond()
+	   << "\nCutoffs: " << counters.BetaCutoffs << " (" << (counters.BetaCutoffs > 0 ? counters.FirstMoveCutoffs * 100 / counters.BetaCutoffs : 0) << "% first)"
+	   << "\nTT hits: " << counters.TTHits << " / " << counters.TTProbes
+	   << "\nNull cutoffs: " << counters.NullMoveCutoffs
+	   << "\nEvals: " << counters.EvalCalls;
+
+	SearchStats.setString(ss.str());
+}
+
 void SimpleChess::LocalGame::OnKeyPress(void) {
 	if ((Event.key.code is sf::Keyboard::Escape) or ((Event.key.control is true or Event.key.alt is true) and (Event.key.code is sf::Keyboard::W or Event.key.code is sf::Keyboard::C))) {
 		Close();
@@ -347,8 +366,7 @@ void SimpleChess::LocalGame::OnEvent(void) {
 }
 
 void SimpleChess::LocalGame::Main(void) {
-	SimpleChess::File::Clear();
-	Move::Initialize();
+	SimpleChess::IO::Clear();
 	Initialize();
 
 	while (IsOpen()) {
@@ -358,12 +376,23 @@ void SimpleChess::LocalGame::Main(void) {
 			OnEvent();
 		}
 
+		if (ComputerPlays and Game.Turn is 2 and IsOpen()) {
+			Move::OnComputerTurn();
+		}
+
 		Display();
 	}
-}
 
-void SimpleChess::LocalGame::Move::Initialize(void) {
-	PlayerTurn = 1;
+	SimpleChess::IO::Flush();
+	SimpleChess::IO::Archive(SimpleChess::StartPage::WhoWon);
+	Computer.Halt();
+	Move::Thinking = false;
+
+	if (ComputerPlays) {
+		try {
+			SimpleChess::File::WriteSearchStats("log/SearchStats.json", GameStats);
+		} catch (int e) {}
+	}
 }
 
 void SimpleChess::LocalGame::Move::InitializePiece(void) {
@@ -371,148 +400,112 @@ void SimpleChess::LocalGame::Move::InitializePiece(void) {
 	Piece.y = (Coord.y - (Coord.y % 80)) / 80;
 }
 
-void SimpleChess::LocalGame::Move::InitializeSelect(void) {
-	Select = Piece;
-}
-
-void SimpleChess::LocalGame::Move::InitializeBoard(void) {
-	for (int y = 0; y < 8; y++) {
-		for (int x = 0; x < 8; x++) {
-			LocalGame::BoardBackground[y][x] = Background::Empty;
-		}
-	}
-}
+void SimpleChess::LocalGame::Move::OnPlayerTurn(void) {
+	File::Info info;
 
-void SimpleChess::LocalGame::Move::OnPlayer1Turn(void) {
-	if (LocalGame::Board[Piece.y][Piece.x] > 0 and LocalGame::Board[Piece.y][Piece.x] < 7) {
+	if (Game.SelectPiece(Piece, Game.Turn is 1)) {
 		SimpleChess::Sounds::Music2.play();
-		InitializeSelect();
-		InitializeBoard();
-
-		switch (LocalGame::Board[Piece.y][Piece.x]) {
-			case SimpleChess::Pieces::White_Pawn: SimpleChess::Move::ShowWhitePawnPath(LocalGame::Board, LocalGame::BoardBackground, Piece, true); break;
-			case SimpleChess::Pieces::White_Rook: SimpleChess::Move::ShowWhiteRookPath(LocalGame::Board, LocalGame::BoardBackground, Piece, true); break;
-			case SimpleChess::Pieces::White_Knight: SimpleChess::Move::ShowWhiteKnightPath(LocalGame::Board, LocalGame::BoardBackground, Piece, true); break;
-			case SimpleChess::Pieces::White_Bishop: SimpleChess::Move::ShowWhiteBishopPath(LocalGame::Board, LocalGame::BoardBackground, Piece, true); break;
-			case SimpleChess::Pieces::White_King: SimpleChess::Move::ShowWhiteKingPath(LocalGame::Board, LocalGame::BoardBackground, Piece, true); break;
-			case SimpleChess::Pieces::White_Queen: SimpleChess::Move::ShowWhiteQueenPath(LocalGame::Board, LocalGame::BoardBackground, Piece, true); break;
-			default: {}
-		}
-	} else if (LocalGame::BoardBackground[Piece.y][Piece.x] is Background::Valid_Move or LocalGame::BoardBackground[Piece.y][Piece.x] is Background::Valid_Capture) {
+	} else if (Game.MoveSelected(Piece, info)) {
 		SimpleChess::Sounds::Music1.play();
-		std::stringstream ss, dss;
-		short omove = LocalGame::BoardBackground[Piece.y][Piece.x];
-		InitializeBoard();
-		short opp = LocalGame::Board[Piece.y][Piece.x];
-
-		if (Select.y != Piece.y or Select.x != Piece.x) {
-			LocalGame::Board[Piece.y][Piece.x] = LocalGame::Board[Select.y][Select.x];
+		LocalGame::PlayerTurn.setString(Game.Turn is 1 ? "Player 1\'s Turn" : "Player 2\'s Turn");
+		Record(sf::Vector2i(info.Piece1Loc.x, info.Piece1Loc.y), Piece);
 
-			if (LocalGame::Board[Piece.y][Piece.x] is SimpleChess::Pieces::White_Pawn and Piece.y is 0) {
-				LocalGame::Board[Piece.y][Piece.x] = SimpleChess::Pieces::White_Queen;
-			}
-
-			LocalGame::Board[Select.y][Select.x] = SimpleChess::Pieces::Empty;
-			PlayerTurn = PlayerTurn is 1 ? 2 : 1;
-			LocalGame::PlayerTurn.setString("Player 2\'s Turn");
-		}
-
-		if (omove is Background::Valid_Capture) {
-			ss << Utils::PStringify(LocalGame::Board[Piece.y][Piece.x]) << " (" << Select.x << ", " << Select.y << ") captured " << Utils::PStringify(opp) << " (" << Piece.x << ", " << Piece.y << ").";
-		} else {
-			ss << Utils::PStringify(LocalGame::Board[Piece.y][Piece.x]) << " (" << Select.x << ", " << Select.y << ") moved to (" << Piece.x << ", " << Piece.y << ").";
-		}
+		const std::string move = Game.Describe(info);
 
 #ifdef __CPP_DEBUG__
-		FLog("%s", ss.str().c_str());
+		FLog("%s", move.c_str());
 #endif
 
-		dss << LocalGame::Board[Piece.y][Piece.x] << " " << Select.x << " " << Select.y << " " << (omove is Background::Valid_Capture ? 1 : 0) << " " << opp << " " << Piece.x << " " << Piece.y;
-
-		SimpleChess::File::Append(dss.str() + "\n");
-		LocalGame::LastMove.setString("Last move:\n" + ss.str());
+		LocalGame::LastMove.setString("Last move:\n" + move);
 	}
 }
 
-void SimpleChess::LocalGame::Move::OnPlayer2Turn(void) {
-	if (LocalGame::Board[Piece.y][Piece.x] > 6) {
-		SimpleChess::Sounds::Music2.play();
-		InitializeSelect();
-		InitializeBoard();
-
-		switch (LocalGame::Board[Piece.y][Piece.x]) {
-			case SimpleChess::Pieces::Black_Pawn: SimpleChess::Move::ShowBlackPawnPath(LocalGame::Board, LocalGame::BoardBackground, Piece, false); break;
-			case SimpleChess::Pieces::Black_Rook: SimpleChess::Move::ShowBlackRookPath(LocalGame::Board, LocalGame::BoardBackground, Piece, false); break;
-			case SimpleChess::Pieces::Black_Knight: SimpleChess::Move::ShowBlackKnightPath(LocalGame::Board, LocalGame::BoardBackground, Piece, false); break;
-			case SimpleChess::Pieces::Black_Bishop: SimpleChess::Move::ShowBlackBishopPath(LocalGame::Board, LocalGame::BoardBackground, Piece, false); break;
-			case SimpleChess::Pieces::Black_King: SimpleChess::Move::ShowBlackKingPath(LocalGame::Board, LocalGame::BoardBackground, Piece, false); break;
-			case SimpleChess::Pieces::Black_Queen: SimpleChess::Move::ShowBlackQueenPath(LocalGame::Board, LocalGame::BoardBackground, Piece, false); break;
-			default: {}
-		}
-	} else if (LocalGame::BoardBackground[Piece.y][Piece.x] is Background::Enemy_Move or LocalGame::BoardBackground[Piece.y][Piece.x] is Background::Enemy_Capture) {
-		SimpleChess::Sounds::Music1.play();
-		std::stringstream ss, dss;
-		short omove = LocalGame::BoardBackground[Piece.y][Piece.x];
-		InitializeBoard();
-		short opp = LocalGame::Board[Piece.y][Piece.x];
+void SimpleChess::LocalGame::Move::OnComputerTurn(void) {
+	if (not Thinking) {
+		Engine::SearchLimits limits;
+		limits.Depth = ComputerSettings.Depth;
+		limits.MoveTime = ComputerSettings.MoveTime;
 
-		if (Select.y != Piece.y or Select.x != Piece.x) {
-			LocalGame::Board[Piece.y][Piece.x] = LocalGame::Board[Select.y][Select.x];
-
-			if (LocalGame::Board[Piece.y][Piece.x] is SimpleChess::Pieces::Black_Pawn and Piece.y is 7) {
-				LocalGame::Board[Piece.y][Piece.x] = SimpleChess::Pieces::Black_Queen;
-			}
+		Computer.Start(GamePosition, limits);
+		Thinking = true;
+		return;
+	}
 
-			LocalGame::Board[Select.y][Select.x] = SimpleChess::Pieces::Empty;
-			PlayerTurn = PlayerTurn is 1 ? 2 : 1;
-			LocalGame::PlayerTurn.setString("Player 1\'s Turn");
-		}
+	if (Computer.IsRunning()) {
+		return;
+	}
 
-		if (omove is Background::Enemy_Capture) {
-			ss << Utils::PStringify(LocalGame::Board[Piece.y][Piece.x]) << " (" << Select.x << ", " << Select.y << ") captured " << Utils::PStringify(opp) << " (" << Piece.x << ", " << Piece.y << ").";
-		} else {
-			ss << Utils::PStringify(LocalGame::Board[Piece.y][Piece.x]) << " (" << Select.x << ", " << Select.y << ") moved to (" << Piece.x << ", " << Piece.y << ").";
-		}
+	Computer.Wait();
+	Thinking = false;
 
-#ifdef __CPP_DEBUG__
-		FLog("%s", ss.str().c_str());
-#endif
+	Engine::SearchCounters counters;
+	Computer.Collect(counters);
+	GameStats.Add(counters);
 
-		dss << LocalGame::Board[Piece.y][Piece.x] << " " << Select.x << " " << Select.y << " " << (omove is Background::Enemy_Capture ? 1 : 0) << " " << opp << " " << Piece.x << " " << Piece.y;
+	const Engine::Move16 best = Computer.BestMove;
+	if (best is Engine::NoMove) {
+		// Checkmate or stalemate.
+		SimpleChess::StartPage::SetWhoWon(GamePosition.InCheck() ? 1 : 3);
 
-		SimpleChess::File::Append(dss.str() + "\n");
-		LocalGame::LastMove.setString("Last move:\n" + ss.str());
+		LocalGame::Close();
+		return;
 	}
+
+	SimpleChess::Sounds::Music1.play();
+
+	Engine::Undo undo;
+	File::Info info;
+	GamePosition.DoMove(best, undo);
+	Game.Play(best, info);
+	LocalGame::PlayerTurn.setString("Player 1\'s Turn");
+
+	const std::string move = Game.Describe(info);
+	FLog("%s", move.c_str());
+	LocalGame::LastMove.setString("Last move:\n" + move);
+
+	IfGameIsOver();
 }
 
 void SimpleChess::LocalGame::Move::MovePiece(void) {
+	if (ComputerPlays and Game.Turn is 2) {
+		return;
+	}
+
 	InitializePiece();
-	PlayerTurn is 1 ? OnPlayer1Turn() : OnPlayer2Turn();
+	OnPlayerTurn();
 	IfGameIsOver();
 }
 
-void SimpleChess::LocalGame::Move::IfGameIsOver(void) {
-	bool WhiteKingExists = false,
-		 BlackKingExists = false;
+void SimpleChess::LocalGame::Move::Record(sf::Vector2i from, sf::Vector2i to) {
+	Engine::MoveList list;
+	GamePosition.GenerateLegalMoves(list);
 
-	for (int y = 0; y < 8; y++) {
-		for (int x = 0; x < 8; x++) {
-			if (WhiteKingExists and BlackKingExists) {
+	for (unsigned short i = 0; i < list.Size; i++) {
+		const Engine::Move16 move = list.Moves[i];
+		if (Engine::FromSquare(move) is from.y * 8 + from.x and Engine::ToSquare(move) is to.y * 8 + to.x and (Engine::FlagOf(move) != Engine::MoveFlag::Promotion or Engine::TypeOf(Engine::PromotionOf(move, 1)) is SimpleChess::Pieces::White_Queen)) {
+			Engine::Undo undo;
+			GamePosition.DoMove(move, undo);
+
+			if (GamePosition.Board is Game.Board) {
 				return;
 			}
 
-			if (LocalGame::Board[y][x] is SimpleChess::Pieces::Black_King) {
-				BlackKingExists = true;
-			} else if (LocalGame::Board[y][x] is SimpleChess::Pieces::White_King) {
-				WhiteKingExists = true;
-			}
+			break;
 		}
 	}
 
-	if (not BlackKingExists) {
-		SimpleChess::StartPage::SetWhoWon(1);
-	} else if (not WhiteKingExists) {
-		SimpleChess::StartPage::SetWhoWon(2);
+	GamePosition.FromBoard(Game.Board, Game.Turn);
+}
+
+void SimpleChess::LocalGame::Move::IfGameIsOver(void) {
+	const short winner = Game.Winner();
+
+	if (winner != 0) {
+		SimpleChess::StartPage::SetWhoWon(winner);
+	} else if (GamePosition.IsRepetition(2) or GamePosition.IsFiftyMoves()) {
+		SimpleChess::StartPage::SetWhoWon(3);
+	} else {
+		return;
 	}
 
 	LocalGame::Close();
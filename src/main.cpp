@@ -24,6 +24,14 @@ ChessMain
 
 	SimpleChess::Textures::Initialize();
 	SimpleChess::Sounds::Initialize();
+	SimpleChess::Engine::Zobrist::Initialize();
+	// If the last run crashed in the middle of a write, drop the broken record before anything reads the log.
+	try {
+		SimpleChess::File::Recover("log/SimpleChess.log");
+	} catch (int e) {}
+	// A game cut off by a crash was never archived, and the next game would clear it from the log.
+	SimpleChess::SCG::ArchiveLeftoverLog();
+	SimpleChess::IO::Start();
 
 	while (true) {
 		switch (SimpleChess::StartPage::Main()) {
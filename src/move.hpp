@@ -111,6 +111,15 @@ namespace SimpleChess {
 		 * @param piece The location of the piece to show the paths of.
 		 */
 		void ShowBlackKingPath(SimpleChess::Board8&, SimpleChess::Board8&, sf::Vector2i, bool);
+
+		/**
+		 * Shows the paths the piece on a square can take, whichever piece it is.
+		 * @param board The board to edit.
+		 * @param boardbackground The board's background to edit.
+		 * @param piece The location of the piece to show the paths of. Nothing is shown for an empty square.
+		 * @param isFriendly True if show green paths, false if show red paths.
+		 */
+		void ShowPath(SimpleChess::Board8&, SimpleChess::Board8&, sf::Vector2i, bool);
 	};
 };
 
@@ -792,4 +801,22 @@ void SimpleChess::Move::ShowBlackQueenPath(SimpleChess::Board8& board, SimpleChe
 	}
 }
 
+void SimpleChess::Move::ShowPath(SimpleChess::Board8& board, SimpleChess::Board8& boardbackground, sf::Vector2i piece, bool isFriendly) {
+	switch (board[piece.y][piece.x]) {
+		case SimpleChess::Pieces::White_Pawn: ShowWhitePawnPath(board, boardbackground, piece, isFriendly); break;
+		case SimpleChess::Pieces::White_Rook: ShowWhiteRookPath(board, boardbackground, piece, isFriendly); break;
+		case SimpleChess::Pieces::White_Knight: ShowWhiteKnightPath(board, boardbackground, piece, isFriendly); break;
+		case SimpleChess::Pieces::White_Bishop: ShowWhiteBishopPath(board, boardbackground, piece, isFriendly); break;
+		case SimpleChess::Pieces::White_King: ShowWhiteKingPath(board, boardbackground, piece, isFriendly); break;
+		case SimpleChess::Pieces::White_Queen: ShowWhiteQueenPath(board, boardbackground, piece, isFriendly); break;
+		case SimpleChess::Pieces::Black_Pawn: ShowBlackPawnPath(board, boardbackground, piece, isFriendly); break;
+		case SimpleChess::Pieces::Black_Rook: ShowBlackRookPath(board, boardbackground, piece, isFriendly); break;
+		case SimpleChess::Pieces::Black_Knight: ShowBlackKnightPath(board, boardbackground, piece, isFriendly); break;
+		case SimpleChess::Pieces::Black_Bishop: ShowBlackBishopPath(board, boardbackground, piece, isFriendly); break;
+		case SimpleChess::Pieces::Black_King: ShowBlackKingPath(board, boardbackground, piece, isFriendly); break;
+		case SimpleChess::Pieces::Black_Queen: ShowBlackQueenPath(board, boardbackground, piece, isFriendly); break;
+		default: {}
+	}
+}
+
 #endif
@@ -22,11 +22,14 @@ namespace SimpleChess {
 		sf::RenderWindow Window; /**< The window for the app. */
 		sf::Image Icon; /**< The icon for the application. */
 		sf::Sprite Sprite; /**< The Sprite that will load the board and pieces. */
-		SimpleChess::Board8 BoardBackground, /**< The board's background. */
-							Board; /**< The board's pieces. */
+		SimpleChess::Game Game; /**< The game: board, turn, moves and log. */
 
 		sf::TcpListener Listener; /**< Listener for client socket. */
 		sf::TcpSocket Client; /**< Client socket. */
+		sf::SocketSelector Selector; /**< Tells if Listener or Client has something to read. */
+		sf::Packet Outgoing; /**< The last move sent to the client. */
+		bool Connected = false, /**< True once the client connected. */
+			 Sending = false; /**< True while part of Outgoing is still to be sent. */
 
 		/**
 		 * Intializes Window.
@@ -109,6 +112,16 @@ namespace SimpleChess {
 		 */
 		void OnEvent(void);
 
+		/**
+		 * Checks the sockets without waiting: connects the client, sends the rest of Outgoing and plays the client's move when it arrives.
+		 */
+		void Poll(void);
+
+		/**
+		 * Sends the rest of Outgoing, waiting for the socket, so the other side gets the last move before the game ends.
+		 */
+		void SendRest(void);
+
 		/**
 		 * Main function for game.
 		 */
@@ -119,18 +132,9 @@ namespace SimpleChess {
 		 * Anything to do with the board.
 		 */
 		namespace Move {
-			sf::Vector2i Select, /**< The user's selection coordinates. */
-						 Coord, /**< The user's raw current-click coordinates. */
+			sf::Vector2i Coord, /**< The user's raw current-click coordinates. */
 						 Piece; /**< The user's refined current-click coordinates. @see Coord */
 
-			int PlayerTurn = 1; /**< Which player's turn it is. */
-
-			/**
-			 * Sets PlayerTurn back to 1 (White).
-			 * @see PlayerTurn
-			 */
-			void Initialize(void);
-
 			/**
 			 * Refines the raw clicks (Coord) from the user and stores the new, refined values (Piece).
 			 * @see Piece
@@ -138,28 +142,16 @@ namespace SimpleChess {
 			 */
 			void InitializePiece(void);
 
-			/**
-			 * Sets the user's selection.
-			 * @see Select
-			 * @see Piece
-			 */
-			void InitializeSelect(void);
-
-			/**
-			 * Resets the board's background to empty.
-			 * @see Empty
-			 */
-			void InitializeBoard(void);
-
 			/**
 			 * Handler for player 1's turn.
 			 */
 			void OnPlayer1Turn(void);
 
 			/**
-			 * Handler for player 2's turn.
+			 * Checks the move player 2 sent and plays it.
+			 * @param packet The packet with the move.
 			 */
-			void OnPlayer2Turn(void);
+			void OnPlayer2Turn(sf::Packet&);
 
 			/**
 			 * Handler for player's turn.
@@ -199,14 +191,12 @@ void SimpleChess::NewGame::Initialize(void) {
 		return;
 	}
 
-	if (Listener.accept(Client) != sf::Socket::Done) {
-		FError(false, "ERROR: Could not connect to client.");
-
-		Listener.close();
-		StartPage::WhoWon = -1;
-		Close();
-		return;
-	}
+	// The client is accepted by Poll, so the window is up while waiting for it.
+	Listener.setBlocking(false);
+	Client.setBlocking(false);
+	Selector.clear();
+	Selector.add(Listener);
+	Connected = Sending = false;
 
 	fl.close();
 
@@ -226,40 +216,10 @@ void SimpleChess::NewGame::Initialize(void) {
 	LastMove.setPosition(680.0, 40.0);
 	LastMove.setColor(sf::Color::White);
 
-	for (short y = 0; y < 8; y++) {
-		for (short x = 0; x < 8; x++) {
-			BoardBackground[y][x] = Background::Empty;
-		}
-	}
-
-	Board[0][0] = SimpleChess::Pieces::Black_Rook;
-	Board[0][1] = SimpleChess::Pieces::Black_Knight;
-	Board[0][2] = SimpleChess::Pieces::Black_Bishop;
-	Board[0][3] = SimpleChess::Pieces::Black_Queen;
-	Board[0][4] = SimpleChess::Pieces::Black_King;
-	Board[0][5] = SimpleChess::Pieces::Black_Bishop;
-	Board[0][6] = SimpleChess::Pieces::Black_Knight;
-	Board[0][7] = SimpleChess::Pieces::Black_Rook;
-
-	for (short x = 0; x < 8; x++) {
-		Board[1][x] = SimpleChess::Pieces::Black_Pawn;
-		Board[6][x] = SimpleChess::Pieces::White_Pawn;
-	}
-
-	for (short y = 2; y < 6; y++) {
-		for (short x = 0; x < 8; x++) {
-			Board[y][x] = SimpleChess::Pieces::Empty;
-		}
-	}
-
-	Board[7][0] = SimpleChess::Pieces::White_Rook;
-	Board[7][1] = SimpleChess::Pieces::White_Knight;
-	Board[7][2] = SimpleChess::Pieces::White_Bishop;
-	Board[7][3] = SimpleChess::Pieces::White_Queen;
-	Board[7][4] = SimpleChess::Pieces::White_King;
-	Board[7][5] = SimpleChess::Pieces::White_Bishop;
-	Board[7][6] = SimpleChess::Pieces::White_Knight;
-	Board[7][7] = SimpleChess::Pieces::White_Rook;
+	// Start from the configured position, or the standard one if there is none.
+	Game.Start();
+	Game.Log = SimpleChess::IO::Append;
+	PlayerTurn.setString("Waiting for Player 2...");
 
 	Window.create(sf::VideoMode(900, 640), "SimpleChess - Game", sf::Style::Close);
 	Window.setFramerateLimit(10);
@@ -307,7 +267,7 @@ void SimpleChess::NewGame::Display(void) {
 		for (int x = 0; x < 8; x++) {
 			bool isNotEmpty = true;
 
-			switch (BoardBackground.at(y).at(x)) {
+			switch (Game.Background.at(y).at(x)) {
 				case Background::Empty: isNotEmpty = false; break;
 				case Background::Enemy_Capture: Sprite.setTexture(SimpleChess::Textures::Enemy_Capture); break;
 				case Background::Enemy_Move: Sprite.setTexture(SimpleChess::Textures::Enemy_Move); break;
@@ -327,7 +287,7 @@ void SimpleChess::NewGame::Display(void) {
 		for (int x = 0; x < 8; x++) {
 			bool isNotEmpty = true;
 
-			switch (Board.at(y).at(x)) {
+			switch (Game.Board.at(y).at(x)) {
 				case SimpleChess::Pieces::Empty: isNotEmpty = false; break;
 				case SimpleChess::Pieces::Black_Pawn: Sprite.setTexture(SimpleChess::Textures::Black::Pawn); break;
 				case SimpleChess::Pieces::Black_Rook: Sprite.setTexture(SimpleChess::Textures::Black::Rook); break;
@@ -382,13 +342,99 @@ void SimpleChess::NewGame::OnEvent(void) {
 	}
 }
 
+void SimpleChess::NewGame::Poll(void) {
+	// Nothing to read, but part of a move may still have to be sent.
+	if (not Selector.wait(sf::microseconds(1)) and not Sending) {
+		return;
+	}
+
+	if (not Connected) {
+		if (Selector.isReady(Listener) and Listener.accept(Client) is sf::Socket::Done) {
+			Client.setBlocking(false);
+			Selector.remove(Listener);
+			Selector.add(Client);
+			Listener.close();
+
+			Connected = true;
+			PlayerTurn.setString(Game.Turn is 1 ? "Player 1\'s Turn" : "Player 2\'s Turn");
+		}
+		return;
+	}
+
+	if (Sending) {
+		const sf::Socket::Status status = Client.send(Outgoing);
+
+		if (status is sf::Socket::Done) {
+			Sending = false;
+		} else if (status != sf::Socket::Partial) {
+			FError(false, "ERROR: Could not send packet.");
+
+			Client.disconnect();
+			Listener.close();
+			StartPage::Go = -1;
+			Close();
+			return;
+		}
+	}
+
+	if (not Selector.isReady(Client)) {
+		return;
+	}
+
+	sf::Packet packet;
+	const sf::Socket::Status status = Client.receive(packet);
+
+	if (status is sf::Socket::NotReady or status is sf::Socket::Partial) {
+		// The rest of the packet comes with a later call.
+		return;
+	}
+
+	if (status != sf::Socket::Done) {
+		FError(false, "ERROR: Did not receive packet.");
+
+		Client.disconnect();
+		Listener.close();
+		StartPage::Go = -1;
+		Close();
+		return;
+	}
+
+	if (Game.Turn != 2) {
+		FError(false, "ERROR: Received a move out of turn.");
+
+		Client.disconnect();
+		Listener.close();
+		StartPage::Go = -1;
+		Close();
+		return;
+	}
+
+	Move::OnPlayer2Turn(packet);
+	if (IsOpen()) {
+		Move::IfGameIsOver();
+	}
+}
+
+void SimpleChess::NewGame::SendRest(void) {
+	if (not Sending) {
+		return;
+	}
+
+	Client.setBlocking(true);
+	if (Client.send(Outgoing) != sf::Socket::Done) {
+		FError(false, "ERROR: Could not send packet.");
+	}
+	Client.setBlocking(false);
+	Sending = false;
+}
+
 void SimpleChess::NewGame::Main(void) {
-	SimpleChess::File::Clear();
-	Move::Initialize();
+	SimpleChess::IO::Clear();
 	Initialize();
 
 	while (IsOpen()) {
 		Clear();
+		Poll();
 
 		while (GetEvent(Event)) {
 			OnEvent();
@@ -397,81 +443,40 @@ void SimpleChess::NewGame::Main(void) {
 		Display();
 	}
 
+	SimpleChess::IO::Flush();
+	SimpleChess::IO::Archive(SimpleChess::StartPage::WhoWon);
+	SendRest();
+	Selector.clear();
 	Client.disconnect();
 	Listener.close();
 }
 
-void SimpleChess::NewGame::Move::Initialize(void) {
-	PlayerTurn = 1;
-}
-
 void SimpleChess::NewGame::Move::InitializePiece(void) {
 	Piece.x = (Coord.x - (Coord.x % 80)) / 80;
 	Piece.y = (Coord.y - (Coord.y % 80)) / 80;
 }
 
-void SimpleChess::NewGame::Move::InitializeSelect(void) {
-	Select = Piece;
-}
-
-void SimpleChess::NewGame::Move::InitializeBoard(void) {
-	for (int y = 0; y < 8; y++) {
-		for (int x = 0; x < 8; x++) {
-			NewGame::BoardBackground[y][x] = Background::Empty;
-		}
-	}
-}
-
 void SimpleChess::NewGame::Move::OnPlayer1Turn(void) {
-	if (NewGame::Board[Piece.y][Piece.x] > 0 and NewGame::Board[Piece.y][Piece.x] < 7) {
+	File::Info info;
+
+	if (Game.SelectPiece(Piece)) {
 		SimpleChess::Sounds::Music2.play();
-		InitializeSelect();
-		InitializeBoard();
-
-		switch (NewGame::Board[Piece.y][Piece.x]) {
-			case SimpleChess::Pieces::White_Pawn: SimpleChess::Move::ShowWhitePawnPath(NewGame::Board, NewGame::BoardBackground, Piece, true); break;
-			case SimpleChess::Pieces::White_Rook: SimpleChess::Move::ShowWhiteRookPath(NewGame::Board, NewGame::BoardBackground, Piece, true); break;
-			case SimpleChess::Pieces::White_Knight: SimpleChess::Move::ShowWhiteKnightPath(NewGame::Board, NewGame::BoardBackground, Piece, true); break;
-			case SimpleChess::Pieces::White_Bishop: SimpleChess::Move::ShowWhiteBishopPath(NewGame::Board, NewGame::BoardBackground, Piece, true); break;
-			case SimpleChess::Pieces::White_King: SimpleChess::Move::ShowWhiteKingPath(NewGame::Board, NewGame::BoardBackground, Piece, true); break;
-			case SimpleChess::Pieces::White_Queen: SimpleChess::Move::ShowWhiteQueenPath(NewGame::Board, NewGame::BoardBackground, Piece, true); break;
-			default: {}
-		}
-	} else if (NewGame::BoardBackground[Piece.y][Piece.x] is Background::Valid_Move or NewGame::BoardBackground[Piece.y][Piece.x] is Background::Valid_Capture) {
+	} else if (Game.MoveSelected(Piece, info)) {
 		SimpleChess::Sounds::Music1.play();
-		std::stringstream ss, dss;
-		short omove = NewGame::BoardBackground[Piece.y][Piece.x];
-		InitializeBoard();
-		short opp = NewGame::Board[Piece.y][Piece.x];
-
-		if (Select.y != Piece.y or Select.x != Piece.x) {
-			NewGame::Board[Piece.y][Piece.x] = NewGame::Board[Select.y][Select.x];
-
-			if (NewGame::Board[Piece.y][Piece.x] is SimpleChess::Pieces::White_Pawn and Piece.y is 0) {
-				NewGame::Board[Piece.y][Piece.x] = SimpleChess::Pieces::White_Queen;
-			}
-
-			NewGame::Board[Select.y][Select.x] = SimpleChess::Pieces::Empty;
-			PlayerTurn = PlayerTurn is 1 ? 2 : 1;
-			NewGame::PlayerTurn.setString("Player 2\'s Turn");
-		}
-
-		if (omove is Background::Valid_Capture) {
-			ss << Utils::PStringify(NewGame::Board[Piece.y][Piece.x]) << " (" << Select.x << ", " << Select.y << ") captured " << Utils::PStringify(opp) << " (" << Piece.x << ", " << Piece.y << ").";
-		} else {
-			ss << Utils::PStringify(NewGame::Board[Piece.y][Piece.x]) << " (" << Select.x << ", " << Select.y << ") moved to (" << Piece.x << ", " << Piece.y << ").";
-		}
+		NewGame::PlayerTurn.setString("Player 2\'s Turn");
 
-		FLog("%s", ss.str().c_str());
+		const std::string move = Game.Describe(info);
+		FLog("%s", move.c_str());
+		NewGame::LastMove.setString("Last move:\n" + move);
 
-		dss << NewGame::Board[Piece.y][Piece.x] << ' ' << Select.x << ' ' << Select.y << ' ' << (omove is Background::Valid_Capture ? 1 : 0) << ' ' << opp << ' ' << Piece.x << ' ' << Piece.y;
+		Outgoing.clear();
+		Outgoing << info.Piece1 << info.Piece1Loc.x << info.Piece1Loc.y << info.Move << info.Piece2 << info.Piece2Loc.x << info.Piece2Loc.y;
 
-		SimpleChess::File::Append(dss.str() + "\n");
-		NewGame::LastMove.setString("Last move:\n" + ss.str());
+		// Whatever the socket cannot take now is sent by Poll.
+		const sf::Socket::Status status = Client.send(Outgoing);
+		Sending = status is sf::Socket::Partial;
 
-		sf::Packet packet;
-		packet << (sf::Uint8)NewGame::Board[Piece.y][Piece.x] << (sf::Uint8)Select.x << (sf::Uint8)Select.y << (sf::Uint8)0 << (sf::Uint8)opp << (sf::Uint8)Piece.x << (sf::Uint8)Piece.y;
-		if (Client.send(packet) != sf::Socket::Done) {
+		if (status != sf::Socket::Done and not Sending) {
 			FError(false, "ERROR: Could not send packet.");
 
 			Client.disconnect();
@@ -483,13 +488,10 @@ void SimpleChess::NewGame::Move::OnPlayer1Turn(void) {
 	}
 }
 
-void SimpleChess::NewGame::Move::OnPlayer2Turn(void) {
-	InitializeBoard();
-
-	sf::Packet packet;
-
-	if (Client.receive(packet) != sf::Socket::Done) {
-		FError(false, "ERROR: Did not receive packet.");
+void SimpleChess::NewGame::Move::OnPlayer2Turn(sf::Packet& packet) {
+	File::Info info;
+	if (not (packet >> info.Piece1 >> info.Piece1Loc.x >> info.Piece1Loc.y >> info.Move >> info.Piece2 >> info.Piece2Loc.x >> info.Piece2Loc.y)) {
+		FError(false, "ERROR: Packet is not formatted correctly.");
 
 		Client.disconnect();
 		Listener.close();
@@ -498,9 +500,8 @@ void SimpleChess::NewGame::Move::OnPlayer2Turn(void) {
 		return;
 	}
 
-	File::Info info;
-	if (not (packet >> info.Piece1 >> info.Piece1Loc.x >> info.Piece1Loc.y >> info.Move >> info.Piece2 >> info.Piece2Loc.x >> info.Piece2Loc.y)) {
-		FError(false, "ERROR: Packet is not formatted correctly.");
+	if (not Game.Play(info)) {
+		FError(false, "ERROR: Received a move that is not allowed.");
 
 		Client.disconnect();
 		Listener.close();
@@ -510,64 +511,37 @@ void SimpleChess::NewGame::Move::OnPlayer2Turn(void) {
 	}
 
 	SimpleChess::Sounds::Music1.play();
-
-	NewGame::Board[info.Piece2Loc.y][info.Piece2Loc.x] = NewGame::Board[info.Piece1Loc.y][info.Piece1Loc.x];
-
-	if (NewGame::Board[info.Piece2Loc.y][info.Piece2Loc.x] is SimpleChess::Pieces::Black_Pawn and info.Piece2Loc.y is 7) {
-		NewGame::Board[info.Piece2Loc.y][info.Piece2Loc.x] = SimpleChess::Pieces::Black_Queen;
-	}
-
-	NewGame::Board[info.Piece1Loc.y][info.Piece1Loc.x] = SimpleChess::Pieces::Empty;
-
-	PlayerTurn = PlayerTurn is 1 ? 2 : 1;
 	NewGame::PlayerTurn.setString("Player 1\'s Turn");
 
-	std::stringstream ss, dss;
-
-	if (info.Move is 1) {
-		ss << Utils::PStringify(info.Piece1) << " (" << info.Piece1Loc.x << ", " << info.Piece1Loc.y << ") captured " << Utils::PStringify(info.Piece2) << " (" << info.Piece2Loc.x << ", " << info.Piece2Loc.y << ").";
-	} else {
-		ss << Utils::PStringify(info.Piece1) << " (" << info.Piece1Loc.x << ", " << info.Piece1Loc.y << ") moved to (" << info.Piece2Loc.x << ", " << info.Piece2Loc.y << ").";
-	}
-
-	FLog("%s", ss.str().c_str());
-
-	dss << (unsigned short)info.Piece1 << ' ' << (unsigned short)info.Piece1Loc.x << ' ' << (unsigned short)info.Piece1Loc.y << ' ' << (unsigned short)info.Move << ' ' << (unsigned short)info.Piece2 << ' ' << (unsigned short)info.Piece2Loc.x << ' ' << (unsigned short)info.Piece2Loc.y;
-
-	SimpleChess::File::Append(dss.str() + "\n");
-	NewGame::LastMove.setString("Last move:\n" + ss.str());
+	const std::string move = Game.Describe(info);
+	FLog("%s", move.c_str());
+	NewGame::LastMove.setString("Last move:\n" + move);
 }
 
 void SimpleChess::NewGame::Move::MovePiece(void) {
+	// Player 2's moves come from Poll.
+	if (not Connected or Game.Turn != 1) {
+		return;
+	}
+
 	InitializePiece();
-	PlayerTurn is 1 ? OnPlayer1Turn() : OnPlayer2Turn();
-	IfGameIsOver();
+	OnPlayer1Turn();
+
+	if (IsOpen()) {
+		IfGameIsOver();
+	}
 }
 
 void SimpleChess::NewGame::Move::IfGameIsOver(void) {
-	bool WhiteKingExists = false,
-		 BlackKingExists = false;
+	const short winner = Game.Winner();
 
-	for (int y = 0; y < 8; y++) {
-		for (int x = 0; x < 8; x++) {
-			if (WhiteKingExists and BlackKingExists) {
-				return;
-			}
-
-			if (NewGame::Board[y][x] is SimpleChess::Pieces::Black_King) {
-				BlackKingExists = true;
-			} else if (NewGame::Board[y][x] is SimpleChess::Pieces::White_King) {
-				WhiteKingExists = true;
-			}
-		}
-	}
-
-	if (not BlackKingExists) {
-		SimpleChess::StartPage::SetWhoWon(1);
-	} else if (not WhiteKingExists) {
-		SimpleChess::StartPage::SetWhoWon(2);
+	if (winner is 0) {
+		return;
 	}
 
+	// The winning move may still be partly unsent, and the other side has to see it to end its game too.
+	SendRest();
+	SimpleChess::StartPage::SetWhoWon(winner);
 	NewGame::Close();
 }
 
@@ -0,0 +1,61 @@
+/*
+ *  openings.cpp
+ *  SimpleChess
+ *
+ *  Copyright (c) 2013-2015 Ronak Gajrawala. All rights reserved.
+ */
+
+/*
+ * Builds the opening tree of a game archive and times lookups in it.
+ * Usage: simplechess-openings [archive] [plies] [minimum games] [threads]
+ */
+
+#include "core.hpp"
+
+int main(int argc, char* argv[]) {
+	const std::string archive = argc > 1 ? argv[1] : "log/Games.sca";
+	const int plies = argc > 2 ? std::atoi(argv[2]) : SimpleChess::Openings::DefaultPlies;
+	const sf::Uint32 minimum = argc > 3 ? static_cast<sf::Uint32>(std::max(std::atoi(argv[3]), 1)) : 1;
+	const int threads = argc > 4 ? std::atoi(argv[4]) : 0;
+	const std::size_t lookups = 100000;
+
+	SimpleChess::Engine::Zobrist::Initialize();
+	sf::Clock clock;
+	std::size_t nodes = 0;
+	SimpleChess::Openings::Table tree;
+
+	try {
+		nodes = SimpleChess::Openings::Build(archive, plies, minimum, threads);
+		tree.Open(archive);
+	} catch (int e) {
+		std::cerr << "Could not build the opening tree of " << archive << "." << std::endl;
+		return EXIT_FAILURE;
+	}
+
+	const double seconds = std::max(clock.getElapsedTime().asSeconds(), 1e-6f);
+	std::cout << "Added " << tree.Games() << " games (" << nodes << " lines) to " << archive << ".tree in " << seconds << " s." << std::endl;
+
+	SimpleChess::Openings::Node root;
+	SimpleChess::Engine::Position start;
+	start.Reset();
+	if (not tree.Root(start.Hash, root)) {
+		return 0;
+	}
+
+	// Walk random lines down the tree, listing the continuations at every step like the Reader does.
+	std::mt19937 random(1);
+	std::vector<SimpleChess::Openings::Node> children;
+	std::size_t steps = 0;
+	clock.restart();
+	for (std::size_t i = 0; i < lookups; i++) {
+		SimpleChess::Openings::Node node = root;
+		while (tree.Children(node, children) > 0) {
+			tree.Child(node, children[random() % children.size()].Move, node);
+			steps++;
+		}
+	}
+
+	const double micros = clock.getElapsedTime().asMicroseconds();
+	std::cout << "Lookups: " << micros / std::max<std::size_t>(steps, 1) << " us per move (" << steps << " moves in " << lookups << " lines)" << std::endl;
+	return 0;
+}
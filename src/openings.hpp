@@ -0,0 +1,523 @@
+/*
+ *  openings.hpp
+ *  SimpleChess
+ *
+ *  Copyright (c) 2013-2015 Ronak Gajrawala. All rights reserved.
+ */
+
+#ifndef SimpleChess_openings_hpp
+#define SimpleChess_openings_hpp
+
+namespace SimpleChess {
+	/**
+	 * The Openings class.
+	 * The opening tree of a game archive: every line played in its first moves, with how many games went that way and how they ended.
+	 * It is kept next to the archive (<archive>.tree) as a trie whose nodes are moves, one root for each start position.
+	 * The children of a node are stored together, most played first, so a lookup follows one move per level through the mapped file.
+	 * All numbers are little-endian.
+	 *
+	 *   offset  size  field
+	 *        0     4  magic "SCT" 0x1A
+	 *        4     2  version
+	 *        6     2  moves kept per game
+	 *        8     4  number of roots (r)
+	 *       12     4  number of nodes (n)
+	 *       16     8  number of games in the tree
+	 *       24  16*r  roots, by hash: start position hash (8), node (4), reserved (4)
+	 *        .  24*n  nodes: move (2), number of children (2), first child (4), games (4), White wins (4), draws (4), Black wins (4)
+	 */
+	namespace Openings {
+		const char Magic[4] = { 'S', 'C', 'T', 0x1A }; /**< The first bytes of every opening tree. */
+		const sf::Uint16 Version = 1; /**< The version this code writes and reads. */
+		const std::size_t HeaderSize = 24; /**< Bytes before the first root. */
+		const std::size_t RootSize = 16; /**< Bytes per root. */
+		const std::size_t NodeSize = 24; /**< Bytes per node. */
+		const std::size_t BatchSize = 64; /**< Games each thread takes at a time while building. */
+		const int DefaultPlies = 30; /**< How many moves of each game are kept by default. */
+
+		/**
+		 * A line in the tree: the move that ends it and the games that followed it.
+		 */
+		class Node {
+		public:
+			Engine::Move16 Move = Engine::NoMove; /**< The last move of the line, or NoMove for a root. */
+			sf::Uint32 Games = 0, /**< Games that played the line, including unfinished ones. */
+					   White = 0, /**< Of those, games White won. */
+					   Draws = 0, /**< Of those, games drawn. */
+					   Black = 0; /**< Of those, games Black won. */
+			sf::Uint32 First = 0; /**< The node of the first continuation. */
+			sf::Uint16 Children = 0; /**< The number of continuations. */
+		};
+
+		/**
+		 * A read-only view of an opening tree mapped into memory.
+		 */
+		class Table {
+		public:
+			/**
+			 * Maps the opening tree of an archive. An open tree is closed first.
+			 * @param archive The name of the archive.
+			 * @return False if the archive has no opening tree yet.
+			 */
+			bool Open(std::string);
+
+			/**
+			 * Unmaps the tree.
+			 */
+			void Close(void);
+
+			/**
+			 * Checks if a tree is open.
+			 * @return True if a tree is open.
+			 */
+			bool IsOpen(void) const;
+
+			/**
+			 * Counts the nodes.
+			 * @return The number of nodes.
+			 */
+			std::size_t Size(void) const;
+
+			/**
+			 * Counts the games that were added to the tree. Fewer than the archive holds means the tree is out of date.
+			 * @return The number of games.
+			 */
+			std::size_t Games(void) const;
+
+			/**
+			 * Tells how many moves of each game were kept.
+			 * @return The number of moves.
+			 */
+			int Plies(void) const;
+
+			/**
+			 * Gets a node without checking the index.
+			 * @param index The node, from 0.
+			 * @return The node.
+			 */
+			Node operator[](std::size_t) const;
+
+			/**
+			 * Finds the games that started from a position.
+			 * @param hash The start position's hash.
+			 * @param root Where the root is dumped.
+			 * @return False if no game started there.
+			 */
+			bool Root(sf::Uint64, Node&) const;
+
+			/**
+			 * Follows a move from a line.
+			 * @param node The line.
+			 * @param move The move.
+			 * @param child Where the longer line is dumped.
+			 * @return False if the move was not played there (or too few times to be kept).
+			 */
+			bool Child(const Node&, Engine::Move16, Node&) const;
+
+			/**
+			 * Lists the continuations of a line, most played first.
+			 * @param node The line.
+			 * @param children Where the continuations will be dumped.
+			 * @return The number of continuations.
+			 */
+			std::size_t Children(const Node&, std::vector<Node>&) const;
+
+		private:
+			File::Mapping Map; /**< The mapped tree. */
+			std::size_t RootCount = 0, /**< The number of roots. */
+						NodeCount = 0, /**< The number of nodes. */
+						GameCount = 0; /**< The number of games in the tree. */
+			int PlyCount = 0; /**< Moves kept per game. */
+		};
+
+		/**
+		 * Builds the opening tree of an archive, replacing the old one.
+		 * Every thread adds its share of the games to a tree of its own, the trees are merged and the result is written out a level at a time.
+		 * @param archive The name of the archive.
+		 * @param plies How many moves of each game to keep.
+		 * @param minimum Lines played by fewer games are left out, which keeps the tree small for big archives.
+		 * @param threads The number of threads, 0 for one per core.
+		 * @return The number of nodes written.
+		 */
+		std::size_t Build(std::string, int = DefaultPlies, sf::Uint32 = 1, int = 0);
+	};
+};
+
+////////// SOURCE //////////
+
+namespace SimpleChess {
+	namespace Openings {
+		const sf::Uint32 None = 0xFFFFFFFF; /**< No node. */
+
+		/**
+		 * A node of a tree being built. Children are a linked list, so adding a game never moves a node.
+		 */
+		class Branch {
+		public:
+			Node Counts; /**< The move and the games. */
+			sf::Uint32 First = None, /**< The first child. */
+					   Next = None; /**< The next sibling. */
+		};
+
+		/**
+		 * A tree being built in memory.
+		 */
+		class Trie {
+		public:
+			std::vector<Branch> Nodes; /**< Every node. */
+			std::map<sf::Uint64, sf::Uint32> Roots; /**< The root of each start position. */
+
+			/**
+			 * Finds or adds the root of a start position.
+			 * @param hash The start position's hash.
+			 * @return The root.
+			 */
+			sf::Uint32 Root(sf::Uint64 hash) {
+				auto found = Roots.find(hash);
+				if (found != Roots.end()) {
+					return found->second;
+				}
+
+				Nodes.push_back(Branch());
+				Roots[hash] = static_cast<sf::Uint32>(Nodes.size() - 1);
+				return static_cast<sf::Uint32>(Nodes.size() - 1);
+			}
+
+			/**
+			 * Finds or adds a child.
+			 * @param parent The parent.
+			 * @param move The child's move.
+			 * @return The child.
+			 */
+			sf::Uint32 Child(sf::Uint32 parent, Engine::Move16 move) {
+				for (sf::Uint32 child = Nodes[parent].First; child != None; child = Nodes[child].Next) {
+					if (Nodes[child].Counts.Move is move) {
+						return child;
+					}
+				}
+
+				Branch branch;
+				branch.Counts.Move = move;
+				branch.Next = Nodes[parent].First;
+				Nodes.push_back(branch);
+				Nodes[parent].First = static_cast<sf::Uint32>(Nodes.size() - 1);
+				return Nodes[parent].First;
+			}
+
+			/**
+			 * Adds one game to a node.
+			 * @param node The node.
+			 * @param result The game's result, as in SCG::Entry.
+			 */
+			void Count(sf::Uint32 node, sf::Uint8 result) {
+				Node& counts = Nodes[node].Counts;
+				counts.Games++;
+				counts.White += result is 1;
+				counts.Black += result is 2;
+				counts.Draws += result is 3;
+			}
+
+			/**
+			 * Adds a node of another tree and everything under it to a node of this one.
+			 * @param other The other tree.
+			 * @param from The node in the other tree.
+			 * @param to The node in this tree.
+			 */
+			void Merge(const Trie& other, sf::Uint32 from, sf::Uint32 to) {
+				const Node& counts = other.Nodes[from].Counts;
+				Nodes[to].Counts.Games += counts.Games;
+				Nodes[to].Counts.White += counts.White;
+				Nodes[to].Counts.Draws += counts.Draws;
+				Nodes[to].Counts.Black += counts.Black;
+
+				for (sf::Uint32 child = other.Nodes[from].First; child != None; child = other.Nodes[child].Next) {
+					Merge(other, child, Child(to, other.Nodes[child].Counts.Move));
+				}
+			}
+		};
+
+		/**
+		 * Reads a node.
+		 * @param data The node in the file.
+		 * @return The node.
+		 */
+		inline Node ReadNode(const unsigned char* data) {
+			Node node;
+			node.Move = static_cast<Engine::Move16>(SCG::ReadLE(data, 2));
+			node.Children = static_cast<sf::Uint16>(SCG::ReadLE(data + 2, 2));
+			node.First = static_cast<sf::Uint32>(SCG::ReadLE(data + 4, 4));
+			node.Games = static_cast<sf::Uint32>(SCG::ReadLE(data + 8, 4));
+			node.White = static_cast<sf::Uint32>(SCG::ReadLE(data + 12, 4));
+			node.Draws = static_cast<sf::Uint32>(SCG::ReadLE(data + 16, 4));
+			node.Black = static_cast<sf::Uint32>(SCG::ReadLE(data + 20, 4));
+			return node;
+		}
+	};
+};
+
+bool SimpleChess::Openings::Table::Open(std::string archive) {
+	Close();
+
+	try {
+		Map.Open(archive + ".tree");
+	} catch (int e) {
+		return false;
+	}
+
+	if (Map.Size() < HeaderSize or memcmp(Map.Data(), Magic, 4) != 0 or SCG::ReadLE(Map.Data() + 4, 2) != Version) {
+		Close();
+		FError(false, "ERROR: %s.tree is not a version %d opening tree!", archive.c_str(), Version);
+
+		throw 2;
+		return false;
+	}
+
+	PlyCount = static_cast<int>(SCG::ReadLE(Map.Data() + 6, 2));
+	RootCount = static_cast<std::size_t>(SCG::ReadLE(Map.Data() + 8, 4));
+	NodeCount = static_cast<std::size_t>(SCG::ReadLE(Map.Data() + 12, 4));
+	GameCount = static_cast<std::size_t>(SCG::ReadLE(Map.Data() + 16, 8));
+
+	if (HeaderSize + RootCount * RootSize + NodeCount * NodeSize > Map.Size()) {
+		Close();
+		FError(false, "ERROR: %s.tree is cut short!", archive.c_str());
+
+		throw 2;
+		return false;
+	}
+
+	return true;
+}
+
+void SimpleChess::Openings::Table::Close(void) {
+	Map.Close();
+	RootCount = NodeCount = GameCount = 0;
+	PlyCount = 0;
+}
+
+bool SimpleChess::Openings::Table::IsOpen(void) const {
+	return Map.IsOpen();
+}
+
+std::size_t SimpleChess::Openings::Table::Size(void) const {
+	return NodeCount;
+}
+
+std::size_t SimpleChess::Openings::Table::Games(void) const {
+	return GameCount;
+}
+
+int SimpleChess::Openings::Table::Plies(void) const {
+	return PlyCount;
+}
+
+SimpleChess::Openings::Node SimpleChess::Openings::Table::operator[](std::size_t index) const {
+	return ReadNode(Map.Data() + HeaderSize + RootCount * RootSize + index * NodeSize);
+}
+
+bool SimpleChess::Openings::Table::Root(sf::Uint64 hash, Node& root) const {
+	const unsigned char* roots = Map.Data() + HeaderSize;
+	std::size_t low = 0, high = RootCount;
+
+	while (low < high) {
+		const std::size_t middle = low + (high - low) / 2;
+		if (SCG::ReadLE(roots + middle * RootSize, 8) < hash) {
+			low = middle + 1;
+		} else {
+			high = middle;
+		}
+	}
+
+	if (low is RootCount or SCG::ReadLE(roots + low * RootSize, 8) != hash) {
+		return false;
+	}
+
+	root = (*this)[static_cast<std::size_t>(SCG::ReadLE(roots + low * RootSize + 8, 4))];
+	return true;
+}
+
+bool SimpleChess::Openings::Table::Child(const Node& node, Engine::Move16 move, Node& child) const {
+	for (std::size_t i = node.First; i < node.First + node.Children; i++) {
+		const unsigned char* data = Map.Data() + HeaderSize + RootCount * RootSize + i * NodeSize;
+		if (SCG::ReadLE(data, 2) is move) {
+			child = ReadNode(data);
+			return true;
+		}
+	}
+
+	return false;
+}
+
+std::size_t SimpleChess::Openings::Table::Children(const Node& node, std::vector<Node>& children) const {
+	children.clear();
+
+	for (std::size_t i = node.First; i < node.First + node.Children; i++) {
+		children.push_back((*this)[i]);
+	}
+
+	return children.size();
+}
+
+std::size_t SimpleChess::Openings::Build(std::string archive, int plies, sf::Uint32 minimum, int threads) {
+	SCG::Directory directory;
+	File::Mapping map;
+
+	if (not directory.Open(archive)) {
+		FError(false, "ERROR: %s has no directory!", archive.c_str());
+
+		throw 1;
+		return 0;
+	}
+	map.Open(archive);
+
+	// Check every game first, since the threads that replay them cannot throw.
+	std::vector<SCG::Game> starts(directory.Size());
+	std::vector<SCG::Entry> entries(directory.Size());
+	for (std::size_t i = 0; i < entries.size(); i++) {
+		entries[i] = directory[i];
+		if (entries[i].Offset + SCG::HeaderSize > map.Size()) {
+			FError(false, "ERROR: %s is cut short!", archive.c_str());
+
+			throw 2;
+			return 0;
+		}
+
+		entries[i].Plies = SCG::ReadHeader(map.Data() + entries[i].Offset, archive, starts[i]);
+		if (entries[i].Offset + SCG::HeaderSize + static_cast<sf::Uint64>(entries[i].Plies) * 2 > map.Size()) {
+			FError(false, "ERROR: %s is cut short!", archive.c_str());
+
+			throw 2;
+			return 0;
+		}
+	}
+
+	plies = std::min(std::max(plies, 0), 0xFFFF);
+
+	// Map: every thread adds batches of games to its own tree.
+	threads = threads > 0 ? threads : std::max<int>(1, std::thread::hardware_concurrency());
+	std::vector<Trie> tries(static_cast<std::size_t>(threads));
+	std::atomic<std::size_t> next(0);
+
+	const auto worker = [&](std::size_t id) {
+		Trie& trie = tries[id];
+		Engine::Position position;
+
+		for (std::size_t first = next.fetch_add(BatchSize); first < entries.size(); first = next.fetch_add(BatchSize)) {
+			for (std::size_t i = first; i < std::min(first + BatchSize, entries.size()); i++) {
+				const unsigned char* moves = map.Data() + entries[i].Offset + SCG::HeaderSize;
+				const auto move = [moves](std::size_t ply) {
+					return static_cast<Engine::Move16>(SCG::ReadLE(moves + ply * 2, 2));
+				};
+
+				// Nothing after a broken move is counted, since the Reader never shows it.
+				std::size_t chess;
+				const sf::Uint32 length = static_cast<sf::Uint32>(Replay::FirstBroken(starts[i], move, std::min(entries[i].Plies, static_cast<sf::Uint32>(plies)), chess));
+
+				// Only the start needs a position; the moves themselves are the keys.
+				Codec::StartPosition(starts[i], position);
+				sf::Uint32 node = trie.Root(position.Hash);
+				trie.Count(node, entries[i].Result);
+
+				for (sf::Uint32 ply = 0; ply < length; ply++) {
+					node = trie.Child(node, move(ply));
+					trie.Count(node, entries[i].Result);
+				}
+			}
+		}
+	};
+
+	std::vector<std::thread> workers;
+	for (int t = 1; t < threads; t++) {
+		workers.emplace_back(worker, static_cast<std::size_t>(t));
+	}
+	worker(0);
+
+	for (auto& thread : workers) {
+		thread.join();
+	}
+
+	// Reduce: fold every tree into the first.
+	Trie& tree = tries[0];
+	for (std::size_t t = 1; t < tries.size(); t++) {
+		for (const auto& root : tries[t].Roots) {
+			tree.Merge(tries[t], root.second, tree.Root(root.first));
+		}
+		Trie().Nodes.swap(tries[t].Nodes);
+	}
+
+	// Lay the nodes out a level at a time, so the children of every node are next to each other.
+	std::vector<sf::Uint32> order;
+	for (const auto& root : tree.Roots) {
+		order.push_back(root.second);
+	}
+
+	std::vector<unsigned char> nodes;
+	std::vector<sf::Uint32> children;
+	for (std::size_t i = 0; i < order.size(); i++) {
+		const Branch& branch = tree.Nodes[order[i]];
+
+		children.clear();
+		for (sf::Uint32 child = branch.First; child != None; child = tree.Nodes[child].Next) {
+			if (tree.Nodes[child].Counts.Games >= minimum) {
+				children.push_back(child);
+			}
+		}
+		// Ties go by move, so the file is the same for any number of threads.
+		std::sort(children.begin(), children.end(), [&](sf::Uint32 a, sf::Uint32 b) {
+			const Node& first = tree.Nodes[a].Counts;
+			const Node& second = tree.Nodes[b].Counts;
+			return first.Games != second.Games ? first.Games > second.Games : first.Move < second.Move;
+		});
+
+		unsigned char data[NodeSize];
+		SCG::WriteLE(data, branch.Counts.Move, 2);
+		SCG::WriteLE(data + 2, children.size(), 2);
+		SCG::WriteLE(data + 4, order.size(), 4);
+		SCG::WriteLE(data + 8, branch.Counts.Games, 4);
+		SCG::WriteLE(data + 12, branch.Counts.White, 4);
+		SCG::WriteLE(data + 16, branch.Counts.Draws, 4);
+		SCG::WriteLE(data + 20, branch.Counts.Black, 4);
+		nodes.insert(nodes.end(), data, data + NodeSize);
+
+		order.insert(order.end(), children.begin(), children.end());
+	}
+
+	std::ofstream fl(File::Path + archive + ".tree", std::ios::out | std::ios::binary | std::ios::trunc);
+	if (not fl.is_open()) {
+		FError(false, "ERROR: %s.tree could not be opened!", archive.c_str());
+
+		throw 1;
+		return 0;
+	}
+
+	unsigned char header[HeaderSize] = { 0 };
+	memcpy(header, Magic, 4);
+	SCG::WriteLE(header + 4, Version, 2);
+	SCG::WriteLE(header + 6, static_cast<sf::Uint64>(plies), 2);
+	SCG::WriteLE(header + 8, tree.Roots.size(), 4);
+	SCG::WriteLE(header + 12, order.size(), 4);
+	SCG::WriteLE(header + 16, entries.size(), 8);
+	fl.write(reinterpret_cast<const char*>(header), HeaderSize);
+
+	// The roots are the first nodes, in the same order.
+	sf::Uint32 index = 0;
+	for (const auto& root : tree.Roots) {
+		unsigned char data[RootSize] = { 0 };
+		SCG::WriteLE(data, root.first, 8);
+		SCG::WriteLE(data + 8, index++, 4);
+		fl.write(reinterpret_cast<const char*>(data), RootSize);
+	}
+
+	fl.write(reinterpret_cast<const char*>(nodes.data()), nodes.size());
+	fl.flush();
+
+	if (not fl) {
+		FError(false, "ERROR: %s.tree could not be written!", archive.c_str());
+
+		throw 1;
+		return 0;
+	}
+
+	return order.size();
+}
+
+#endif
@@ -0,0 +1,109 @@
+/*
+ *  pack.cpp
+ *  SimpleChess
+ *
+ *  Copyright (c) 2013-2015 Ronak Gajrawala. All rights reserved.
+ */
+
+/*
+ * Packs a game archive into the compressed .scz format, checks that every game comes back the same and
+ * compares the two formats: bytes per move, decode speed and the time to open one game.
+ * Usage: simplechess-pack [input] [output] [games per block]
+ */
+
+#include "core.hpp"
+
+using namespace SimpleChess;
+
+int main(int argc, char* argv[]) {
+	const std::string input = argc > 1 ? argv[1] : "log/Games.sca",
+					  output = argc > 2 ? argv[2] : "log/Games.scz";
+	const int games_per_block = argc > 3 ? std::atoi(argv[3]) : Codec::DefaultGamesPerBlock;
+
+	SCG::Directory directory;
+	File::Mapping plain;
+	Codec::Archive packed;
+	sf::Clock clock;
+
+	try {
+		Codec::Pack(input, output, static_cast<sf::Uint16>(std::min(std::max(games_per_block, 1), 65535)));
+		const double pack_time = clock.restart().asSeconds();
+
+		directory.Open(input);
+		plain.Open(input);
+		packed.Open(output);
+
+		std::cout << "Packed " << packed.Size() << " games in " << packed.Blocks() << " blocks in " << pack_time << " s." << std::endl;
+
+		// Plain: one header and two bytes a move, straight from the mapping.
+		std::vector<SCG::Game> games(directory.Size());
+		sf::Uint64 moves = 0;
+
+		clock.restart();
+		for (std::size_t i = 0; i < directory.Size(); i++) {
+			const unsigned char* data = plain.Data() + directory[i].Offset;
+			games[i].Moves.resize(SCG::ReadHeader(data, input, games[i]));
+
+			for (std::size_t ply = 0; ply < games[i].Moves.size(); ply++) {
+				games[i].Moves[ply] = static_cast<Engine::Move16>(SCG::ReadLE(data + SCG::HeaderSize + ply * 2, 2));
+			}
+
+			moves += games[i].Moves.size();
+		}
+		const double plain_time = clock.restart().asSeconds();
+
+		// Packed: every block, checking each game against the plain one.
+		std::vector<SCG::Game> block;
+		std::vector<SCG::Entry> entries;
+		std::size_t index = 0, mismatches = 0;
+		double packed_time = 0.0;
+
+		for (std::size_t b = 0; b < packed.Blocks(); b++) {
+			clock.restart();
+			packed.ReadBlock(b, block, entries);
+			packed_time += clock.getElapsedTime().asSeconds();
+
+			for (std::size_t i = 0; i < block.size(); i++, index++) {
+				const SCG::Entry entry = directory[index];
+				if (block[i].Moves != games[index].Moves or block[i].Start != games[index].Start or entries[i].Result != entry.Result or entries[i].Date != entry.Date) {
+					mismatches++;
+				}
+			}
+		}
+
+		// Random access: one game at a time.
+		std::mt19937 random(1);
+		SCG::Game game;
+		SCG::Entry entry;
+		const int lookups = packed.Size() > 0 ? 1000 : 0;
+
+		clock.restart();
+		for (int i = 0; i < lookups; i++) {
+			packed.Read(random() % packed.Size(), game, entry);
+		}
+		const double lookup_time = clock.restart().asSeconds();
+
+		File::Mapping compressed;
+		compressed.Open(output);
+
+		const double count = static_cast<double>(std::max<sf::Uint64>(moves, 1));
+		std::cout << "Moves:  " << moves << std::endl
+				  << "Plain:  " << plain.Size() << " bytes, " << plain.Size() / count << " bytes/move, " << moves / std::max(plain_time, 1e-9) / 1e6 << "M moves/s decoded" << std::endl
+				  << "Packed: " << compressed.Size() << " bytes, " << compressed.Size() / count << " bytes/move, " << moves / std::max(packed_time, 1e-9) / 1e6 << "M moves/s decoded" << std::endl
+				  << "Ratio:  " << static_cast<double>(plain.Size()) / std::max<std::size_t>(compressed.Size(), 1) << "x smaller" << std::endl;
+
+		if (lookups > 0) {
+			std::cout << "One game from the packed archive takes " << lookup_time / lookups * 1e6 << " us on average." << std::endl;
+		}
+
+		if (mismatches > 0) {
+			std::cerr << mismatches << " games did not decode the same!" << std::endl;
+			return EXIT_FAILURE;
+		}
+	} catch (int e) {
+		std::cerr << "Could not pack " << input << " to " << output << "." << std::endl;
+		return EXIT_FAILURE;
+	}
+
+	return 0;
+}
@@ -0,0 +1,1259 @@
+/*
+ *  pgn.hpp
+ *  SimpleChess
+ *
+ *  Copyright (c) 2013-2015 Ronak Gajrawala. All rights reserved.
+ */
+
+#ifndef SimpleChess_pgn_hpp
+#define SimpleChess_pgn_hpp
+
+namespace SimpleChess {
+	/**
+	 * The PGN class.
+	 * Imports Portable Game Notation into a game archive (.sca) and exports games and positions back out.
+	 * The input is memory-mapped and cut into chunks on game boundaries, so every chunk is parsed on its own thread.
+	 * The Result, Date and FEN tags are kept; comments, variations and annotations are skipped.
+	 * Games that leave a king in check, which the game windows allow, are written and read with the tag [Variant "SimpleChess"].
+	 * Exports go through a Writer, so writing a move never allocates.
+	 */
+	namespace PGN {
+		const std::size_t DefaultChunkSize = 1 << 22; /**< Bytes of PGN in each chunk. */
+		const std::size_t ExportBatchSize = 256; /**< Games in each batch of an export. */
+		const std::size_t MaxSAN = 8; /**< The longest a move in SAN can be (e.g. "Qa1xb2+" or "exd8=Q#"). */
+		const std::size_t MaxFEN = 96; /**< The longest a FEN string can be, with its null character. */
+		const std::size_t LineLength = 79; /**< The longest a line of moves is made. */
+
+		/**
+		 * Counts what an import did.
+		 */
+		class Stats {
+		public:
+			sf::Uint64 Games = 0, /**< Games added to the archive. */
+					   Moves = 0, /**< Moves in those games. */
+					   Skipped = 0; /**< Games left out because a move could not be read or they had no moves. */
+
+			/**
+			 * Adds another count to this one.
+			 * @param other The other count.
+			 */
+			void Add(const Stats&);
+		};
+
+		/**
+		 * Writes a file through a buffer that is reused until the file is closed.
+		 * Without a file the buffer only grows, so games can be written on other threads and copied into the file in order.
+		 */
+		class Writer {
+		public:
+			/**
+			 * Starts a buffer with no file behind it.
+			 */
+			Writer(void);
+
+			/**
+			 * Opens a file, replacing what was in it.
+			 * @param filename The name of the file.
+			 * @param capacity The size of the buffer in bytes.
+			 */
+			Writer(std::string, std::size_t = 1 << 20);
+
+			/**
+			 * Writes out what is left in the buffer.
+			 */
+			~Writer(void);
+
+			Writer(const Writer&) = delete;
+			Writer& operator=(const Writer&) = delete;
+
+			/**
+			 * Adds a character.
+			 * @param c The character.
+			 */
+			void Put(char);
+
+			/**
+			 * Adds characters.
+			 * @param str The characters.
+			 * @param size How many there are.
+			 */
+			void Put(const char*, std::size_t);
+
+			/**
+			 * Adds a string.
+			 * @param str The string, ending with a null character.
+			 */
+			void Put(const char*);
+
+			/**
+			 * Writes the buffer to the file and empties it. Does nothing without a file.
+			 */
+			void Flush(void);
+
+			/**
+			 * Empties the buffer without writing it. Its memory is kept.
+			 */
+			void Clear(void);
+
+			/**
+			 * Gets what is in the buffer.
+			 * @return The characters, not null-terminated.
+			 */
+			const char* Contents(void) const;
+
+			/**
+			 * Counts what is in the buffer.
+			 * @return The number of characters.
+			 */
+			std::size_t Size(void) const;
+
+		private:
+			/**
+			 * Makes room for more characters, by writing the buffer out or by growing it.
+			 * @param size How many characters are about to be added.
+			 */
+			void Reserve(std::size_t);
+
+			std::string Filename; /**< The name of the file, for errors. Empty without a file. */
+			std::ofstream Out; /**< The file. */
+			std::vector<char> Buffer; /**< The buffer. */
+			std::size_t Used = 0; /**< How much of Buffer is filled. */
+		};
+
+		/**
+		 * The games parsed from one chunk, laid out as they will be in the archive.
+		 */
+		class Batch {
+		public:
+			std::vector<unsigned char> Data; /**< The games in the binary format, one after another. */
+			std::vector<SCG::Entry> Entries; /**< Their entries. Offsets are from the start of Data. */
+			Stats Counts; /**< What the chunk held. */
+		};
+
+		/**
+		 * Finds the first game that starts at or after a point: a tag line that does not follow another tag line.
+		 * @param begin The start of the text.
+		 * @param from Where to start looking.
+		 * @param end The end of the text.
+		 * @return The start of the game or end if there is none.
+		 */
+		const char* NextGame(const char*, const char*, const char*);
+
+		/**
+		 * Reads a move in Standard Algebraic Notation (e.g. "Nbd7", "exd8=Q+" or "O-O") and plays it.
+		 * Check marks and annotations (+, #, !, ?) are ignored.
+		 * @param position The position to play it in.
+		 * @param begin The start of the move.
+		 * @param end The end of the move.
+		 * @param undo Where the information to take the move back will be stored.
+		 * @param windows True to also take a move that leaves the king in check, as the game windows do.
+		 * @return The move played or Engine::NoMove if it is not a legal move (the position is then unchanged).
+		 */
+		Engine::Move16 PlaySAN(Engine::Position&, const char*, const char*, Engine::Undo&, bool = false);
+
+		/**
+		 * Parses every game in a piece of PGN.
+		 * @param begin The start of the first game.
+		 * @param end The end of the last game.
+		 * @param batch Where the games will be dumped.
+		 */
+		void Parse(const char*, const char*, Batch&);
+
+		/**
+		 * Imports a PGN file, appending its games to an archive.
+		 * @param input The name of the PGN file.
+		 * @param archive The name of the archive.
+		 * @param threads The number of threads, 0 for one per core.
+		 * @return What was imported.
+		 */
+		Stats Import(std::string, std::string, int = 0);
+
+		/**
+		 * Writes a move in Standard Algebraic Notation and plays it.
+		 * @param position The position to play it in.
+		 * @param move The move, which must be legal.
+		 * @param undo Where the information to take the move back will be stored.
+		 * @param out Where the move is written, at least MaxSAN characters. It is not null-terminated.
+		 * @param windows True for a game by the window rules: a move may leave the king in check, so a pinned piece that
+		 *                could go to the same square is told apart too, and a check is never marked as mate.
+		 * @return The number of characters written.
+		 */
+		std::size_t WriteSAN(Engine::Position&, Engine::Move16, Engine::Undo&, char*, bool = false);
+
+		/**
+		 * Writes a position in Forsyth-Edwards Notation.
+		 * @param position The position.
+		 * @param out Where the FEN is written, at least MaxFEN characters. It is null-terminated.
+		 * @return The number of characters written, without the null character.
+		 */
+		std::size_t WriteFEN(const Engine::Position&, char*);
+
+		/**
+		 * Writes a game in PGN: the seven standard tags (and the FEN tags if it did not start from the standard position), then its moves.
+		 * A game that leaves a king in check gets the tag [Variant "SimpleChess"], and a broken game is only written up to
+		 * its first broken move, with the result "*".
+		 * @param writer Where the game is written.
+		 * @param game Where the game started. Its moves are not used.
+		 * @param entry The result, date and number of moves.
+		 * @param moves The moves.
+		 */
+		void WriteGame(Writer&, const SCG::Game&, const SCG::Entry&, const SCG::MoveSource&);
+
+		/**
+		 * Exports games to a PGN file: every game of an archive (when it has a directory), or the one game in a log or .scg file.
+		 * The games of an archive are written in batches on several threads and copied into the file in order.
+		 * @param input The name of the archive or game.
+		 * @param output The name of the PGN file.
+		 * @param threads The number of threads, 0 for one per core.
+		 * @return What was exported. Skipped is always 0.
+		 */
+		Stats Export(std::string, std::string, int = 0);
+	};
+};
+
+////////// SOURCE //////////
+
+namespace SimpleChess {
+	namespace Replay {
+		// Defined in replay.hpp, which needs MovesTo from here.
+		std::size_t FirstBroken(const SCG::Game&, const SCG::MoveSource&, std::size_t, std::size_t&);
+	};
+
+	namespace PGN {
+		/**
+		 * Checks if a character ends a move or move number.
+		 * @param c The character.
+		 * @return True for spaces, control characters and . { } ( ) ; [
+		 */
+		inline bool IsDelimiter(char c) {
+			return static_cast<unsigned char>(c) <= ' ' or c is '.' or c is '{' or c is '}' or c is '(' or c is ')' or c is ';' or c is '[';
+		}
+
+		/**
+		 * Finds the end of a token, 16 bytes at a time where SSE2 is available.
+		 * @param p The start of the token.
+		 * @param end The end of the text.
+		 * @return The first delimiter at or after p, or end.
+		 * @see IsDelimiter
+		 */
+		inline const char* NextDelimiter(const char* p, const char* end) {
+			#ifdef __SSE2__
+				const __m128i space = _mm_set1_epi8(' '), dot = _mm_set1_epi8('.'), open = _mm_set1_epi8('{'), close = _mm_set1_epi8('}'),
+							  left = _mm_set1_epi8('('), right = _mm_set1_epi8(')'), semicolon = _mm_set1_epi8(';'), tag = _mm_set1_epi8('[');
+
+				for (; end - p >= 16; p += 16) {
+					const __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+					// A byte is a space or control character when the unsigned minimum with ' ' is the byte itself.
+					__m128i hits = _mm_cmpeq_epi8(_mm_min_epu8(bytes, space), bytes);
+					hits = _mm_or_si128(hits, _mm_or_si128(_mm_cmpeq_epi8(bytes, dot), _mm_cmpeq_epi8(bytes, open)));
+					hits = _mm_or_si128(hits, _mm_or_si128(_mm_cmpeq_epi8(bytes, close), _mm_cmpeq_epi8(bytes, left)));
+					hits = _mm_or_si128(hits, _mm_or_si128(_mm_cmpeq_epi8(bytes, right), _mm_cmpeq_epi8(bytes, semicolon)));
+					hits = _mm_or_si128(hits, _mm_cmpeq_epi8(bytes, tag));
+
+					const int mask = _mm_movemask_epi8(hits);
+					if (mask != 0) {
+						return p + __builtin_ctz(static_cast<unsigned int>(mask));
+					}
+				}
+			#endif
+
+			while (p < end and not IsDelimiter(*p)) {
+				p++;
+			}
+			return p;
+		}
+
+		/**
+		 * Finds a character.
+		 * @param p Where to start looking.
+		 * @param end The end of the text.
+		 * @param c The character.
+		 * @return The character or end if it is not there.
+		 */
+		inline const char* Find(const char* p, const char* end, char c) {
+			const void* found = p < end ? memchr(p, c, static_cast<std::size_t>(end - p)) : nullptr;
+			return found ? static_cast<const char*>(found) : end;
+		}
+
+		/**
+		 * Reads a Date tag ("1992.11.04", with ?? for anything unknown).
+		 * @param begin The start of the value.
+		 * @param end The end of the value.
+		 * @return Local midnight of that day in seconds since 1970, or 0 if the year is unknown.
+		 */
+		inline sf::Int64 ParseDate(const char* begin, const char* end) {
+			int fields[3] = { 0, 1, 1 };
+
+			for (int i = 0; i < 3 and begin < end; i++) {
+				int value = 0;
+				const char* start = begin;
+				for (; begin < end and *begin >= '0' and *begin <= '9'; begin++) {
+					value = value * 10 + (*begin - '0');
+				}
+
+				if (begin > start) {
+					fields[i] = value;
+				} else if (i is 0) {
+					return 0;
+				}
+
+				begin = Find(begin, end, '.');
+				begin += begin < end ? 1 : 0;
+			}
+
+			std::tm day = std::tm();
+			day.tm_year = fields[0] - 1900;
+			day.tm_mon = std::min(std::max(fields[1], 1), 12) - 1;
+			day.tm_mday = std::min(std::max(fields[2], 1), 31);
+			day.tm_isdst = -1;
+
+			const std::time_t date = std::mktime(&day);
+			return date is static_cast<std::time_t>(-1) ? 0 : static_cast<sf::Int64>(date);
+		}
+
+		/**
+		 * Finds the moves of one kind of piece that land on a square, by looking outwards from the square.
+		 * Much faster than generating every move when the square is already known, as it is in SAN.
+		 * Castling is left out. The moves follow the piece rules but may leave the king in check.
+		 * @param position The position.
+		 * @param type The white piece of the kind that moves.
+		 * @param to The square (y * 8 + x).
+		 * @param list Where the moves will be stored.
+		 */
+		inline void MovesTo(const Engine::Position& position, short type, int to, Engine::MoveList& list) {
+			const short us = position.SideToMove, piece = Engine::MakePiece(type, us), target = position.At(to);
+			const int ty = to >> 3, tx = to & 7;
+
+			if (Engine::SideOf(target) is us) {
+				return;
+			}
+
+			const auto on_board = [](int x, int y) {
+				return x >= 0 and x < 8 and y >= 0 and y < 8;
+			};
+
+			if (type is Pieces::White_Pawn) {
+				// A white pawn moves towards row 0, so it comes from the row below.
+				const int forward = us is 1 ? -1 : 1, fy = ty - forward;
+				const bool last = ty is (us is 1 ? 0 : 7);
+				int froms[4], count = 0;
+
+				if (not on_board(tx, fy)) {
+					return;
+				}
+
+				if (target is Pieces::Empty) {
+					if (position.Board[fy][tx] is piece) {
+						froms[count++] = fy * 8 + tx;
+					} else if (position.Board[fy][tx] is Pieces::Empty and ty is (us is 1 ? 4 : 3) and position.Board[fy - forward][tx] is piece) {
+						froms[count++] = (fy - forward) * 8 + tx;
+					}
+				}
+
+				if (target != Pieces::Empty or to is position.EnPassant) {
+					for (int dx = -1; dx <= 1; dx += 2) {
+						if (on_board(tx + dx, fy) and position.Board[fy][tx + dx] is piece) {
+							froms[count++] = fy * 8 + tx + dx;
+						}
+					}
+				}
+
+				for (int i = 0; i < count; i++) {
+					if (last) {
+						list.Push(Engine::CreateMove(froms[i], to, Engine::MoveFlag::Promotion, Pieces::White_Queen));
+						list.Push(Engine::CreateMove(froms[i], to, Engine::MoveFlag::Promotion, Pieces::White_Rook));
+						list.Push(Engine::CreateMove(froms[i], to, Engine::MoveFlag::Promotion, Pieces::White_Bishop));
+						list.Push(Engine::CreateMove(froms[i], to, Engine::MoveFlag::Promotion, Pieces::White_Knight));
+					} else {
+						list.Push(Engine::CreateMove(froms[i], to, to is position.EnPassant and (froms[i] & 7) != tx ? Engine::MoveFlag::EnPassant : Engine::MoveFlag::Normal));
+					}
+				}
+			} else if (type is Pieces::White_Knight or type is Pieces::White_King) {
+				const sf::Int8 (*steps)[2] = type is Pieces::White_Knight ? Engine::KnightSteps : Engine::KingSteps;
+
+				for (int i = 0; i < 8; i++) {
+					const int x = tx + steps[i][0], y = ty + steps[i][1];
+					if (on_board(x, y) and position.Board[y][x] is piece) {
+						list.Push(Engine::CreateMove(y * 8 + x, to));
+					}
+				}
+			} else {
+				for (int i = 0; i < 8; i++) {
+					const sf::Int8* step = i < 4 ? Engine::RookSteps[i] : Engine::BishopSteps[i - 4];
+					if ((i < 4 and type is Pieces::White_Bishop) or (i >= 4 and type is Pieces::White_Rook)) {
+						continue;
+					}
+
+					for (int x = tx + step[0], y = ty + step[1]; on_board(x, y); x += step[0], y += step[1]) {
+						if (position.Board[y][x] != Pieces::Empty) {
+							if (position.Board[y][x] is piece) {
+								list.Push(Engine::CreateMove(y * 8 + x, to));
+							}
+							break;
+						}
+					}
+				}
+			}
+		}
+
+		/**
+		 * Breaks a time into its parts in the local time zone. Safe to call from any thread.
+		 * @param time The time.
+		 * @param parts Where the parts will be dumped.
+		 */
+		inline void LocalTime(std::time_t time, std::tm& parts) {
+			#ifdef _WIN32
+				localtime_s(&parts, &time);
+			#else
+				localtime_r(&time, &parts);
+			#endif
+		}
+
+		/**
+		 * Finds the first piece along a line.
+		 * @param position The position.
+		 * @param square Where the line starts (not included).
+		 * @param dx The step along x.
+		 * @param dy The step along y.
+		 * @return The square of the first piece or -1 if the line reaches the edge.
+		 */
+		inline int FirstPiece(const Engine::Position& position, int square, int dx, int dy) {
+			for (int x = (square & 7) + dx, y = (square >> 3) + dy; x >= 0 and x < 8 and y >= 0 and y < 8; x += dx, y += dy) {
+				if (position.Board[y][x] != Pieces::Empty) {
+					return y * 8 + x;
+				}
+			}
+			return -1;
+		}
+
+		/**
+		 * Checks if a piece attacks a square.
+		 * @param position The position.
+		 * @param square The piece's square.
+		 * @param target The square that might be attacked.
+		 * @return True if the piece attacks target.
+		 */
+		inline bool Attacks(const Engine::Position& position, int square, int target) {
+			const short piece = position.At(square), type = Engine::TypeOf(piece);
+			const int dx = (target & 7) - (square & 7), dy = (target >> 3) - (square >> 3);
+			const int ax = std::abs(dx), ay = std::abs(dy);
+
+			if (type is Pieces::White_Pawn) {
+				// A white pawn attacks towards row 0.
+				return ax is 1 and dy is (Engine::SideOf(piece) is 1 ? -1 : 1);
+			} else if (type is Pieces::White_Knight) {
+				return (ax is 1 and ay is 2) or (ax is 2 and ay is 1);
+			} else if (type is Pieces::White_King) {
+				return std::max(ax, ay) is 1;
+			}
+
+			const bool straight = dx is 0 or dy is 0, diagonal = ax is ay;
+			if ((dx is 0 and dy is 0) or (not straight and not diagonal) or (straight and type is Pieces::White_Bishop) or (diagonal and type is Pieces::White_Rook)) {
+				return false;
+			}
+
+			return FirstPiece(position, square, (dx > 0) - (dx < 0), (dy > 0) - (dy < 0)) is target;
+		}
+
+		/**
+		 * Checks if the move just played gives check, only looking at the lines the move could have changed.
+		 * @param position The position after the move.
+		 * @param move The move.
+		 * @return True if the side to move is in check.
+		 */
+		inline bool GaveCheck(const Engine::Position& position, Engine::Move16 move) {
+			const int king = position.Kings[position.SideToMove], from = Engine::FromSquare(move), to = Engine::ToSquare(move);
+			const short us = 3 - position.SideToMove;
+
+			if (king < 0) {
+				return false;
+			}
+
+			// The piece that moved, or the rook that castled.
+			if (Attacks(position, to, king)) {
+				return true;
+			}
+			if (Engine::FlagOf(move) is Engine::MoveFlag::Castling and Attacks(position, to > from ? to - 1 : to + 1, king)) {
+				return true;
+			}
+
+			// A line opened by the square the piece left, or by the pawn taken en passant.
+			const int victim = Engine::FlagOf(move) is Engine::MoveFlag::EnPassant ? (us is 1 ? to + 8 : to - 8) : -1;
+			for (const int square : { from, victim }) {
+				const int dx = (square & 7) - (king & 7), dy = (square >> 3) - (king >> 3);
+				if (square < 0 or (dx is 0 and dy is 0) or (dx != 0 and dy != 0 and std::abs(dx) != std::abs(dy))) {
+					continue;
+				}
+
+				const int found = FirstPiece(position, king, (dx > 0) - (dx < 0), (dy > 0) - (dy < 0));
+				if (found >= 0 and Engine::SideOf(position.At(found)) is us and Attacks(position, found, king)) {
+					return true;
+				}
+			}
+
+			return false;
+		}
+
+		/**
+		 * Checks if the side to move has a legal move, stopping at the first one.
+		 * @param position The position.
+		 * @return False for checkmate or stalemate.
+		 */
+		inline bool HasLegalMove(Engine::Position& position) {
+			Engine::MoveList list;
+			Engine::Undo undo;
+
+			// Most checks can be stepped out of, so the king's steps are tried before generating every move.
+			const int king = position.Kings[position.SideToMove];
+			if (king >= 0) {
+				for (int i = 0; i < 8; i++) {
+					const int x = (king & 7) + Engine::KingSteps[i][0], y = (king >> 3) + Engine::KingSteps[i][1];
+					if (x < 0 or x > 7 or y < 0 or y > 7 or Engine::SideOf(position.Board[y][x]) is position.SideToMove) {
+						continue;
+					}
+
+					const bool legal = position.DoMove(Engine::CreateMove(king, y * 8 + x), undo);
+					position.UndoMove(undo);
+
+					if (legal) {
+						return true;
+					}
+				}
+			}
+
+			position.GenerateMoves(list);
+
+			for (unsigned short i = 0; i < list.Size; i++) {
+				const bool legal = position.DoMove(list.Moves[i], undo);
+				position.UndoMove(undo);
+
+				if (legal) {
+					return true;
+				}
+			}
+			return false;
+		}
+
+		/**
+		 * Skips a variation, along with any variations and comments inside it.
+		 * @param p Just after the opening parenthesis.
+		 * @param end The end of the text.
+		 * @return Just after the closing parenthesis, or end.
+		 */
+		inline const char* SkipVariation(const char* p, const char* end) {
+			for (int depth = 1; p < end and depth > 0; p++) {
+				if (*p is '(') {
+					depth++;
+				} else if (*p is ')') {
+					depth--;
+				} else if (*p is '{') {
+					p = Find(p, end, '}');
+				} else if (*p is ';') {
+					p = Find(p, end, '\n');
+				}
+
+				if (p is end) {
+					break;
+				}
+			}
+			return p;
+		}
+	};
+};
+
+void SimpleChess::PGN::Stats::Add(const Stats& other) {
+	Games += other.Games;
+	Moves += other.Moves;
+	Skipped += other.Skipped;
+}
+
+SimpleChess::PGN::Writer::Writer(void) : Buffer(1 << 16) {}
+
+SimpleChess::PGN::Writer::Writer(std::string filename, std::size_t capacity) : Filename(filename), Buffer(std::max<std::size_t>(capacity, MaxFEN)) {
+	Out.open(File::Path + filename, std::ios::out | std::ios::binary | std::ios::trunc);
+	if (not Out.is_open()) {
+		FError(false, "ERROR: %s could not be opened!", filename.c_str());
+
+		throw 1;
+		return;
+	}
+}
+
+SimpleChess::PGN::Writer::~Writer(void) {
+	try {
+		Flush();
+	} catch (int e) {}
+}
+
+void SimpleChess::PGN::Writer::Put(char c) {
+	if (Used is Buffer.size()) {
+		Reserve(1);
+	}
+	Buffer[Used++] = c;
+}
+
+void SimpleChess::PGN::Writer::Put(const char* str, std::size_t size) {
+	if (Used + size > Buffer.size()) {
+		Reserve(size);
+	}
+
+	memcpy(&Buffer[Used], str, size);
+	Used += size;
+}
+
+void SimpleChess::PGN::Writer::Put(const char* str) {
+	Put(str, strlen(str));
+}
+
+void SimpleChess::PGN::Writer::Flush(void) {
+	if (not Out.is_open()) {
+		return;
+	}
+
+	Out.write(Buffer.data(), static_cast<std::streamsize>(Used));
+	Used = 0;
+
+	if (not Out) {
+		FError(false, "ERROR: %s could not be written!", Filename.c_str());
+
+		throw 1;
+		return;
+	}
+}
+
+void SimpleChess::PGN::Writer::Clear(void) {
+	Used = 0;
+}
+
+const char* SimpleChess::PGN::Writer::Contents(void) const {
+	return Buffer.data();
+}
+
+std::size_t SimpleChess::PGN::Writer::Size(void) const {
+	return Used;
+}
+
+void SimpleChess::PGN::Writer::Reserve(std::size_t size) {
+	Flush();
+
+	if (Used + size > Buffer.size()) {
+		Buffer.resize(std::max(Buffer.size() * 2, Used + size));
+	}
+}
+
+const char* SimpleChess::PGN::NextGame(const char* begin, const char* from, const char* end) {
+	// Start at the line holding from, knowing whether the line before it is a tag.
+	const char* line = from;
+	while (line > begin and line[-1] != '\n') {
+		line--;
+	}
+
+	bool tags = false;
+	if (line > begin) {
+		const char* previous = line - 1;
+		while (previous > begin and previous[-1] != '\n') {
+			previous--;
+		}
+		tags = *previous is '[';
+	}
+
+	while (line < end) {
+		const bool tag = *line is '[';
+		if (tag and not tags and line >= from) {
+			return line;
+		}
+		tags = tag;
+
+		line = Find(line, end, '\n');
+		line += line < end ? 1 : 0;
+	}
+
+	return end;
+}
+
+SimpleChess::Engine::Move16 SimpleChess::PGN::PlaySAN(Engine::Position& position, const char* begin, const char* end, Engine::Undo& undo, bool windows) {
+	while (end > begin and (end[-1] is '+' or end[-1] is '#' or end[-1] is '!' or end[-1] is '?')) {
+		end--;
+	}
+
+	// A captured king ends the game.
+	if (end - begin < 2 or position.Kings[1] < 0 or position.Kings[2] < 0) {
+		return Engine::NoMove;
+	}
+
+	Engine::MoveList list;
+
+	// Castling: O-O or O-O-O, also written with zeros.
+	if (*begin is 'O' or *begin is '0') {
+		const std::size_t length = static_cast<std::size_t>(end - begin);
+		const int file = length is 3 ? 6 : 2;
+		if ((length != 3 and length != 5) or begin[1] != '-') {
+			return Engine::NoMove;
+		}
+
+		position.GenerateMoves(list);
+		for (unsigned short i = 0; i < list.Size; i++) {
+			const Engine::Move16 move = list.Moves[i];
+			if (Engine::FlagOf(move) is Engine::MoveFlag::Castling and (Engine::ToSquare(move) & 7) is file) {
+				if (position.DoMove(move, undo) or windows) {
+					return move;
+				}
+				position.UndoMove(undo);
+			}
+		}
+
+		return Engine::NoMove;
+	}
+
+	short type = Pieces::White_Pawn, promotion = Pieces::Empty;
+	switch (*begin) {
+		case 'K': type = Pieces::White_King; begin++; break;
+		case 'Q': type = Pieces::White_Queen; begin++; break;
+		case 'R': type = Pieces::White_Rook; begin++; break;
+		case 'B': type = Pieces::White_Bishop; begin++; break;
+		case 'N': type = Pieces::White_Knight; begin++; break;
+	}
+
+	// Promotions: e8=Q or e8Q.
+	switch (end - begin >= 3 ? end[-1] : ' ') {
+		case 'Q': promotion = Pieces::White_Queen; break;
+		case 'R': promotion = Pieces::White_Rook; break;
+		case 'B': promotion = Pieces::White_Bishop; break;
+		case 'N': promotion = Pieces::White_Knight; break;
+	}
+
+	if (promotion != Pieces::Empty) {
+		end -= end[-2] is '=' ? 2 : 1;
+	}
+
+	if (end - begin < 2 or end[-2] < 'a' or end[-2] > 'h' or end[-1] < '1' or end[-1] > '8') {
+		return Engine::NoMove;
+	}
+
+	const int to = ('8' - end[-1]) * 8 + (end[-2] - 'a');
+	int from_file = -1, from_rank = -1;
+
+	// Anything between the piece and the square says where it came from (a file, a rank or both); captures and dashes are skipped.
+	for (const char* c = begin; c < end - 2; c++) {
+		if (*c >= 'a' and *c <= 'h') {
+			from_file = *c - 'a';
+		} else if (*c >= '1' and *c <= '8') {
+			from_rank = '8' - *c;
+		} else if (*c != 'x' and *c != '-' and *c != ':') {
+			return Engine::NoMove;
+		}
+	}
+
+	MovesTo(position, type, to, list);
+
+	for (unsigned short i = 0; i < list.Size; i++) {
+		const Engine::Move16 move = list.Moves[i];
+		const int from = Engine::FromSquare(move);
+
+		if ((from_file >= 0 and (from & 7) != from_file) or (from_rank >= 0 and (from >> 3) != from_rank)) {
+			continue;
+		}
+
+		if (Engine::FlagOf(move) is Engine::MoveFlag::Promotion) {
+			// A promotion without a piece is taken to be a queen.
+			if (Engine::TypeOf(Engine::PromotionOf(move, 1)) != (promotion is Pieces::Empty ? Pieces::White_Queen : promotion)) {
+				continue;
+			}
+		} else if (promotion != Pieces::Empty) {
+			continue;
+		}
+
+		if (position.DoMove(move, undo) or windows) {
+			return move;
+		}
+		position.UndoMove(undo);
+	}
+
+	return Engine::NoMove;
+}
+
+void SimpleChess::PGN::Parse(const char* begin, const char* end, Batch& batch) {
+	Engine::Position position;
+	Engine::Undo undo;
+	SCG::Game game;
+	SCG::Entry entry;
+	std::vector<unsigned char> data;
+	// Whether a game has started, whether its moves have started, whether one of them could not be read and whether it is by the window rules.
+	bool open = false, movetext = false, broken = false, windows = false;
+
+	const auto start = [&](void) {
+		position.Reset();
+		game.Moves.clear();
+		entry = SCG::Entry();
+		open = true;
+		movetext = broken = windows = false;
+	};
+
+	const auto finish = [&](void) {
+		if (not open) {
+			return;
+		}
+		open = false;
+
+		if (broken or game.Moves.empty()) {
+			batch.Counts.Skipped++;
+			return;
+		}
+
+		SCG::Encode(game, data);
+		entry.Offset = batch.Data.size();
+		entry.Length = static_cast<sf::Uint32>(data.size());
+		entry.Plies = static_cast<sf::Uint32>(game.Moves.size());
+
+		batch.Data.insert(batch.Data.end(), data.begin(), data.end());
+		batch.Entries.push_back(entry);
+		batch.Counts.Games++;
+		batch.Counts.Moves += game.Moves.size();
+	};
+
+	for (const char* p = begin; p < end;) {
+		const char c = *p;
+
+		if (static_cast<unsigned char>(c) <= ' ' or c is '.') {
+			p++;
+		} else if (c is '[') {
+			// A tag pair: [Name "Value"]
+			const char* line = Find(p, end, '\n');
+			if (not open or movetext) {
+				finish();
+				start();
+			}
+
+			const char* name = p + 1;
+			const char* value = Find(name, line, '"');
+			const char* value_end = Find(value + (value < line ? 1 : 0), line, '"');
+			const std::size_t length = static_cast<std::size_t>(NextDelimiter(name, line) - name);
+
+			if (value < line) {
+				value++;
+
+				if (length is 6 and memcmp(name, "Result", 6) is 0) {
+					entry.Result = static_cast<sf::Uint8>(*value is '1' and value[1] is '-' ? 1 : *value is '0' ? 2 : *value is '1' ? 3 : 0);
+				} else if (length is 4 and memcmp(name, "Date", 4) is 0) {
+					entry.Date = ParseDate(value, value_end);
+				} else if (length is 3 and memcmp(name, "FEN", 3) is 0) {
+					broken = not position.FromFEN(value);
+				} else if (length is 7 and memcmp(name, "Variant", 7) is 0) {
+					windows = value_end - value is 11 and memcmp(value, "SimpleChess", 11) is 0;
+				}
+			}
+
+			p = line;
+		} else if (c is '{') {
+			p = Find(p, end, '}');
+		} else if (c is ';' or (c is '%' and (p is begin or p[-1] is '\n'))) {
+			p = Find(p, end, '\n');
+		} else if (c is '(') {
+			p = SkipVariation(p + 1, end);
+		} else if (c is ')' or c is '}') {
+			p++;
+		} else if (c is '$') {
+			for (p++; p < end and *p >= '0' and *p <= '9'; p++);
+		} else {
+			const char* token = p;
+			p = NextDelimiter(p, end);
+
+			if (not open) {
+				start();
+			}
+
+			if (not movetext) {
+				// The tags are over, so the game starts from here.
+				movetext = true;
+				game.Start = position.Board;
+				game.SideToMove = position.SideToMove;
+				game.CastlingRights = position.CastlingRights;
+				game.EnPassant = position.EnPassant;
+			}
+
+			const std::size_t length = static_cast<std::size_t>(p - token);
+			if (c is '*' or (length is 3 and (memcmp(token, "1-0", 3) is 0 or memcmp(token, "0-1", 3) is 0)) or (length is 7 and memcmp(token, "1/2-1/2", 7) is 0)) {
+				// A result ends the game.
+				entry.Result = static_cast<sf::Uint8>(c is '*' ? 0 : length is 7 ? 3 : c is '1' ? 1 : 2);
+				finish();
+			} else if (c >= '1' and c <= '9') {
+				// A move number.
+			} else if (not broken) {
+				const Engine::Move16 move = PlaySAN(position, token, p, undo, windows);
+				if (move is Engine::NoMove) {
+					broken = true;
+				} else {
+					game.Moves.push_back(move);
+				}
+			}
+		}
+	}
+
+	finish();
+}
+
+SimpleChess::PGN::Stats SimpleChess::PGN::Import(std::string input, std::string archive, int threads) {
+	File::Mapping map;
+	map.Open(input);
+
+	const char* text = reinterpret_cast<const char*>(map.Data());
+	const char* end = text + map.Size();
+
+	// A UTF-8 byte order mark is not part of the first game.
+	if (map.Size() >= 3 and memcmp(text, "\xEF\xBB\xBF", 3) is 0) {
+		text += 3;
+	}
+
+	std::vector<const char*> bounds(1, text);
+	for (std::size_t offset = DefaultChunkSize; offset < static_cast<std::size_t>(end - text); offset += DefaultChunkSize) {
+		const char* bound = NextGame(text, text + offset, end);
+		if (bound > bounds.back() and bound < end) {
+			bounds.push_back(bound);
+		}
+	}
+	bounds.push_back(end);
+
+	std::ofstream fl, dir;
+	SCG::OpenArchive(archive, fl, dir);
+	sf::Uint64 offset = static_cast<sf::Uint64>(fl.tellp());
+
+	threads = threads > 0 ? threads : std::max<int>(1, std::thread::hardware_concurrency());
+	const std::size_t chunks = bounds.size() - 1, round_size = static_cast<std::size_t>(threads) * 4;
+	Stats stats;
+
+	// A few chunks per thread at a time, so memory use does not grow with the input and the games keep their order.
+	for (std::size_t first = 0; first < chunks; first += round_size) {
+		std::vector<Batch> batches(std::min(round_size, chunks - first));
+		std::atomic<std::size_t> next(0);
+
+		const auto worker = [&](void) {
+			for (std::size_t i = next++; i < batches.size(); i = next++) {
+				Parse(bounds[first + i], bounds[first + i + 1], batches[i]);
+			}
+		};
+
+		std::vector<std::thread> workers;
+		for (int t = 1; t < std::min<int>(threads, static_cast<int>(batches.size())); t++) {
+			workers.emplace_back(worker);
+		}
+		worker();
+
+		for (auto& thread : workers) {
+			thread.join();
+		}
+
+		for (auto& batch : batches) {
+			std::vector<unsigned char> entries(batch.Entries.size() * SCG::EntrySize);
+			for (std::size_t i = 0; i < batch.Entries.size(); i++) {
+				batch.Entries[i].Offset += offset;
+				SCG::EncodeEntry(batch.Entries[i], &entries[i * SCG::EntrySize]);
+			}
+
+			// The games go in first, so a directory entry never points past the end of the archive.
+			fl.write(reinterpret_cast<const char*>(batch.Data.data()), batch.Data.size());
+			fl.flush();
+			dir.write(reinterpret_cast<const char*>(entries.data()), entries.size());
+			dir.flush();
+
+			if (not fl or not dir) {
+				FError(false, "ERROR: %s could not be written!", archive.c_str());
+
+				throw 1;
+				return stats;
+			}
+
+			offset += batch.Data.size();
+			stats.Add(batch.Counts);
+		}
+	}
+
+	return stats;
+}
+
+std::size_t SimpleChess::PGN::WriteSAN(Engine::Position& position, Engine::Move16 move, Engine::Undo& undo, char* out, bool windows) {
+	static const char letters[] = " PRNBQK";
+	const int from = Engine::FromSquare(move), to = Engine::ToSquare(move);
+	const short type = Engine::TypeOf(position.At(from));
+	std::size_t size = 0;
+
+	if (Engine::FlagOf(move) is Engine::MoveFlag::Castling) {
+		memcpy(out, (to & 7) is 6 ? "O-O" : "O-O-O", (to & 7) is 6 ? 3 : 5);
+		size = (to & 7) is 6 ? 3 : 5;
+	} else {
+		const bool capture = position.At(to) != Pieces::Empty or Engine::FlagOf(move) is Engine::MoveFlag::EnPassant;
+
+		if (type is Pieces::White_Pawn) {
+			if (capture) {
+				out[size++] = static_cast<char>('a' + (from & 7));
+			}
+		} else {
+			out[size++] = letters[type];
+
+			// Name the file, the rank or both only when another piece of the same kind could legally go to the same square,
+			// which by the window rules includes a piece pinned to its king.
+			Engine::MoveList list;
+			MovesTo(position, type, to, list);
+			bool ambiguous = false, same_file = false, same_rank = false;
+
+			for (unsigned short i = 0; i < list.Size; i++) {
+				const int other = Engine::FromSquare(list.Moves[i]);
+				if (other is from) {
+					continue;
+				}
+
+				const bool legal = position.DoMove(list.Moves[i], undo) or windows;
+				position.UndoMove(undo);
+
+				if (legal) {
+					ambiguous = true;
+					same_file = same_file or (other & 7) is (from & 7);
+					same_rank = same_rank or (other >> 3) is (from >> 3);
+				}
+			}
+
+			if (ambiguous and (not same_file or same_rank)) {
+				out[size++] = static_cast<char>('a' + (from & 7));
+			}
+			if (ambiguous and same_file) {
+				out[size++] = static_cast<char>('8' - (from >> 3));
+			}
+		}
+
+		if (capture) {
+			out[size++] = 'x';
+		}
+
+		out[size++] = static_cast<char>('a' + (to & 7));
+		out[size++] = static_cast<char>('8' - (to >> 3));
+
+		if (Engine::FlagOf(move) is Engine::MoveFlag::Promotion) {
+			out[size++] = '=';
+			out[size++] = letters[Engine::TypeOf(Engine::PromotionOf(move, 1))];
+		}
+	}
+
+	position.DoMove(move, undo);
+
+	if (GaveCheck(position, move)) {
+		// By the window rules a king in check is only lost once it is captured.
+		out[size++] = windows or HasLegalMove(position) ? '+' : '#';
+	}
+
+	return size;
+}
+
+std::size_t SimpleChess::PGN::WriteFEN(const Engine::Position& position, char* out) {
+	static const char pieces[] = ".PRNBQKprnbqk";
+	std::size_t size = 0;
+
+	for (int y = 0; y < 8; y++) {
+		int empty = 0;
+
+		for (int x = 0; x < 8; x++) {
+			const short piece = position.Board[y][x];
+			if (piece is Pieces::Empty) {
+				empty++;
+				continue;
+			}
+
+			if (empty > 0) {
+				out[size++] = static_cast<char>('0' + empty);
+				empty = 0;
+			}
+			out[size++] = pieces[piece];
+		}
+
+		if (empty > 0) {
+			out[size++] = static_cast<char>('0' + empty);
+		}
+		out[size++] = y < 7 ? '/' : ' ';
+	}
+
+	out[size++] = position.SideToMove is 1 ? 'w' : 'b';
+	out[size++] = ' ';
+
+	if (position.CastlingRights is 0) {
+		out[size++] = '-';
+	} else {
+		const char rights[] = "KQkq";
+		for (int bit = 0; bit < 4; bit++) {
+			if (position.CastlingRights & (1 << bit)) {
+				out[size++] = rights[bit];
+			}
+		}
+	}
+
+	out[size++] = ' ';
+
+	if (position.EnPassant >= 0) {
+		out[size++] = static_cast<char>('a' + (position.EnPassant & 7));
+		out[size++] = static_cast<char>('8' - (position.EnPassant >> 3));
+	} else {
+		out[size++] = '-';
+	}
+
+	size += static_cast<std::size_t>(snprintf(out + size, MaxFEN - size, " %d %d", position.HalfMoves, position.FullMoves));
+	return size;
+}
+
+void SimpleChess::PGN::WriteGame(Writer& writer, const SCG::Game& game, const SCG::Entry& entry, const SCG::MoveSource& moves) {
+	static const char* results[] = { "*", "1-0", "0-1", "1/2-1/2" };
+	std::size_t chess;
+	const std::size_t plies = Replay::FirstBroken(game, moves, entry.Plies, chess);
+	const bool windows = chess < plies;
+	// Nothing after a broken move could be read back, so the game is left unfinished there.
+	const char* result = plies < entry.Plies or entry.Result > 3 ? results[0] : results[entry.Result];
+
+	Engine::Position position, standard;
+	Engine::Undo undo;
+	Codec::StartPosition(game, position);
+	standard.Reset();
+
+	char date[16] = "????.??.??";
+	if (entry.Date != 0) {
+		std::tm parts;
+		LocalTime(static_cast<std::time_t>(entry.Date), parts);
+		std::strftime(date, sizeof(date), "%Y.%m.%d", &parts);
+	}
+
+	writer.Put("[Event \"SimpleChess game\"]\n[Site \"?\"]\n[Date \"");
+	writer.Put(date);
+	writer.Put("\"]\n[Round \"-\"]\n[White \"?\"]\n[Black \"?\"]\n[Result \"");
+	writer.Put(result);
+	writer.Put("\"]\n");
+
+	if (windows) {
+		writer.Put("[Variant \"SimpleChess\"]\n");
+	}
+
+	if (position.Board != standard.Board or position.SideToMove != 1 or position.CastlingRights != standard.CastlingRights or position.EnPassant != -1) {
+		char fen[MaxFEN];
+		writer.Put("[SetUp \"1\"]\n[FEN \"");
+		writer.Put(fen, WriteFEN(position, fen));
+		writer.Put("\"]\n");
+	}
+
+	writer.Put('\n');
+
+	char token[32];
+	std::size_t column = 0;
+
+	for (std::size_t ply = 0; ply <= plies; ply++) {
+		std::size_t size = 0;
+
+		if (ply is plies) {
+			size = strlen(result);
+			memcpy(token, result, size);
+		} else {
+			// A move number before each of White's moves, and before the first move if Black starts.
+			if (position.SideToMove is 1 or ply is 0) {
+				size = static_cast<std::size_t>(snprintf(token, sizeof(token), position.SideToMove is 1 ? "%d. " : "%d... ", position.FullMoves));
+			}
+			size += WriteSAN(position, moves(ply), undo, token + size, windows);
+		}
+
+		if (column > 0 and column + 1 + size > LineLength) {
+			writer.Put('\n');
+			column = 0;
+		} else if (column > 0) {
+			writer.Put(' ');
+			column++;
+		}
+
+		writer.Put(token, size);
+		column += size;
+	}
+
+	writer.Put("\n\n");
+}
+
+SimpleChess::PGN::Stats SimpleChess::PGN::Export(std::string input, std::string output, int threads) {
+	SCG::Directory directory;
+	Writer writer(output);
+	Stats stats;
+
+	if (not directory.Open(input)) {
+		SCG::Game game;
+		SCG::Load(input, game);
+
+		SCG::Entry entry;
+		entry.Plies = static_cast<sf::Uint32>(game.Moves.size());
+		WriteGame(writer, game, entry, [&game](std::size_t ply) {
+			return game.Moves[ply];
+		});
+
+		writer.Flush();
+		stats.Games++;
+		stats.Moves += entry.Plies;
+		return stats;
+	}
+
+	File::Mapping map;
+	map.Open(input);
+
+	// Check every game first, since the threads that write them cannot throw.
+	std::vector<SCG::Game> starts(directory.Size());
+	std::vector<SCG::Entry> entries(directory.Size());
+	for (std::size_t i = 0; i < entries.size(); i++) {
+		entries[i] = directory[i];
+		if (entries[i].Offset + SCG::HeaderSize > map.Size()) {
+			FError(false, "ERROR: %s is cut short!", input.c_str());
+
+			throw 2;
+			return stats;
+		}
+
+		entries[i].Plies = SCG::ReadHeader(map.Data() + entries[i].Offset, input, starts[i]);
+		if (entries[i].Offset + SCG::HeaderSize + static_cast<sf::Uint64>(entries[i].Plies) * 2 > map.Size()) {
+			FError(false, "ERROR: %s is cut short!", input.c_str());
+
+			throw 2;
+			return stats;
+		}
+
+		stats.Games++;
+		stats.Moves += entries[i].Plies;
+	}
+
+	threads = threads > 0 ? threads : std::max<int>(1, std::thread::hardware_concurrency());
+	const std::size_t batches = (entries.size() + ExportBatchSize - 1) / ExportBatchSize, round_size = static_cast<std::size_t>(threads) * 4;
+	std::vector<Writer> buffers(std::min(round_size, batches));
+
+	for (std::size_t first = 0; first < batches; first += round_size) {
+		const std::size_t count = std::min(round_size, batches - first);
+		std::atomic<std::size_t> next(0);
+
+		const auto worker = [&](void) {
+			for (std::size_t b = next++; b < count; b = next++) {
+				buffers[b].Clear();
+
+				const std::size_t begin = (first + b) * ExportBatchSize, end = std::min(begin + ExportBatchSize, entries.size());
+				for (std::size_t i = begin; i < end; i++) {
+					const unsigned char* moves = map.Data() + entries[i].Offset + SCG::HeaderSize;
+					WriteGame(buffers[b], starts[i], entries[i], [moves](std::size_t ply) {
+						return static_cast<Engine::Move16>(SCG::ReadLE(moves + ply * 2, 2));
+					});
+				}
+			}
+		};
+
+		std::vector<std::thread> workers;
+		for (int t = 1; t < std::min<int>(threads, static_cast<int>(count)); t++) {
+			workers.emplace_back(worker);
+		}
+		worker();
+
+		for (auto& thread : workers) {
+			thread.join();
+		}
+
+		for (std::size_t b = 0; b < count; b++) {
+			writer.Put(buffers[b].Contents(), buffers[b].Size());
+		}
+	}
+
+	writer.Flush();
+	return stats;
+}
+
+#endif
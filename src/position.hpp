@@ -0,0 +1,988 @@
+/*
+ *  position.hpp
+ *  SimpleChess
+ *
+ *  Copyright (c) 2013-2015 Ronak Gajrawala. All rights reserved.
+ */
+
+#ifndef SimpleChess_position_hpp
+#define SimpleChess_position_hpp
+
+namespace SimpleChess {
+	/**
+	 * The Engine class.
+	 * Everything the computer player needs: positions, move generation and search.
+	 * Unlike the game pages, the engine keeps its state in objects so that several searches can run at once.
+	 */
+	namespace Engine {
+		typedef sf::Uint16 Move16; /**< A move packed into 16 bits: from square (6), to square (6), promotion (2), flag (2). */
+
+		static const Move16 NoMove = 0; /**< Not a move (a1 to a1 can never be played). */
+
+		/**
+		 * Flags stored in the top two bits of a Move16.
+		 */
+		namespace MoveFlag {
+			static const sf::Uint16 Normal = 0 << 14, /**< A plain move or capture. */
+									Promotion = 1 << 14, /**< A pawn reaching the last rank. */
+									EnPassant = 2 << 14, /**< A pawn capturing en passant. */
+									Castling = 3 << 14; /**< A king castling (stored as the king's move). */
+		};
+
+		/**
+		 * Castling right bits.
+		 */
+		namespace Castling {
+			static const sf::Uint8 WhiteKingSide = 1, /**< White may castle short. */
+								   WhiteQueenSide = 2, /**< White may castle long. */
+								   BlackKingSide = 4, /**< Black may castle short. */
+								   BlackQueenSide = 8, /**< Black may castle long. */
+								   All = 15; /**< Every right. */
+		};
+
+		/**
+		 * Random keys used to hash positions.
+		 * Zobrist::Initialize must be called before any position is hashed.
+		 */
+		namespace Zobrist {
+			sf::Uint64 PieceSquare[13][64], /**< Key for each piece on each square. */
+					   CastlingRights[16], /**< Key for each castling right combination. */
+					   EnPassant[8], /**< Key for each en passant file. */
+					   SideToMove; /**< Key toggled when Black is to move. */
+
+			/**
+			 * Fills the key tables. The keys are always the same so hashes can be stored on disk.
+			 */
+			void Initialize(void);
+		};
+
+		/**
+		 * A fixed-size list of moves so move generation never allocates.
+		 */
+		class MoveList {
+		public:
+			std::array<Move16, 256> Moves; /**< The moves. */
+			unsigned short Size = 0; /**< How many moves are in the list. */
+
+			/**
+			 * Adds a move to the end of the list.
+			 * @param move The move to add.
+			 */
+			void Push(Move16 move) {
+				Moves[Size++] = move;
+			}
+		};
+
+		/**
+		 * Everything needed to take a move back.
+		 * @see Position::DoMove
+		 */
+		class Undo {
+		public:
+			Move16 Played; /**< The move that was played. */
+			short Captured; /**< The piece that was captured or Pieces::Empty. */
+			sf::Uint8 CastlingRights; /**< Castling rights before the move. */
+			sf::Int8 EnPassant; /**< En passant square before the move. */
+			short HalfMoves; /**< Half-move clock before the move. */
+			sf::Uint64 Hash; /**< Hash before the move. */
+		};
+
+		/**
+		 * Creates a move.
+		 * @param from The square the piece leaves (y * 8 + x).
+		 * @param to The square the piece arrives at (y * 8 + x).
+		 * @param flag One of MoveFlag.
+		 * @param promotion The white piece a pawn promotes to (Knight, Bishop, Rook or Queen).
+		 * @return The packed move.
+		 */
+		Move16 CreateMove(int, int, sf::Uint16 = MoveFlag::Normal, short = Pieces::White_Queen);
+
+		/**
+		 * Gets the square a move starts from.
+		 * @param move The move.
+		 * @return The square (y * 8 + x).
+		 */
+		int FromSquare(Move16);
+
+		/**
+		 * Gets the square a move ends on.
+		 * @param move The move.
+		 * @return The square (y * 8 + x).
+		 */
+		int ToSquare(Move16);
+
+		/**
+		 * Gets the flag of a move.
+		 * @see MoveFlag
+		 * @param move The move.
+		 * @return The flag.
+		 */
+		sf::Uint16 FlagOf(Move16);
+
+		/**
+		 * Gets the piece a promotion creates.
+		 * @param move The move.
+		 * @param side 1 for White, 2 for Black.
+		 * @return The promoted piece.
+		 */
+		short PromotionOf(Move16, short);
+
+		/**
+		 * Gets the type of a piece, ignoring its color.
+		 * @param piece The piece.
+		 * @return The white piece of the same type or Pieces::Empty.
+		 */
+		short TypeOf(short);
+
+		/**
+		 * Gets the side a piece belongs to.
+		 * @param piece The piece.
+		 * @return 1 for White, 2 for Black, 0 for Empty.
+		 */
+		short SideOf(short);
+
+		/**
+		 * Gets a piece of a certain type and side.
+		 * @param type The white piece of the wanted type.
+		 * @param side 1 for White, 2 for Black.
+		 * @return The piece.
+		 */
+		short MakePiece(short, short);
+
+		/**
+		 * Writes a move in coordinate notation (e.g. "e2e4" or "e7e8q").
+		 * @param move The move.
+		 * @return The move as a string.
+		 */
+		std::string MoveToString(Move16);
+
+		class Position;
+
+		/**
+		 * Reads a move in coordinate notation.
+		 * @param position The position the move is played in.
+		 * @param str The move (e.g. "e2e4" or "e7e8q").
+		 * @return The legal move or NoMove if there is none.
+		 */
+		Move16 ParseMove(Position&, const std::string&);
+
+		/**
+		 * A chess position with the full rules (castling, en passant, promotion).
+		 * The board uses the same layout as the game pages: Board[y][x] with Black on row 0.
+		 */
+		class Position {
+		public:
+			Board8 Board; /**< The board's pieces. */
+			short SideToMove; /**< 1 if White is to move, 2 if Black is. */
+			sf::Uint8 CastlingRights; /**< Castling rights. @see Castling */
+			sf::Int8 EnPassant; /**< Square a pawn can be captured on en passant or -1. */
+			short HalfMoves; /**< Half moves since the last capture or pawn move. */
+			short FullMoves; /**< The move number. */
+			sf::Uint64 Hash; /**< The Zobrist hash of the position. */
+			std::array<sf::Int8, 3> Kings; /**< King squares indexed by side (1 or 2), -1 if missing. */
+			std::vector<sf::Uint64> HashHistory; /**< Hashes of the positions before this one, oldest first. */
+
+			/**
+			 * Sets up the standard starting position.
+			 */
+			void Reset(void);
+
+			/**
+			 * Sets up a position from a game board.
+			 * Castling rights are given where the king and rook are still on their starting squares.
+			 * @param board The board's pieces.
+			 * @param side The side to move (1 or 2).
+			 */
+			void FromBoard(const Board8&, short);
+
+			/**
+			 * Sets up a position from Forsyth-Edwards Notation.
+			 * Reads the string in place without allocating. The clocks may be left out.
+			 * @param fen The FEN string.
+			 * @return False if the string is not valid FEN (the position is then undefined).
+			 */
+			bool FromFEN(const char*);
+
+			/**
+			 * Gets the piece on a square.
+			 * @param square The square (y * 8 + x).
+			 * @return The piece.
+			 */
+			short At(int) const;
+
+			/**
+			 * Recomputes the hash from scratch.
+			 * @return The hash.
+			 */
+			sf::Uint64 ComputeHash(void) const;
+
+			/**
+			 * Checks if a square is attacked.
+			 * @param square The square (y * 8 + x).
+			 * @param side The attacking side (1 or 2).
+			 * @return True if a piece of side attacks the square.
+			 */
+			bool IsAttacked(int, short) const;
+
+			/**
+			 * Checks if the side to move is in check.
+			 * @return True if in check.
+			 */
+			bool InCheck(void) const;
+
+			/**
+			 * Generates moves that follow the piece rules but may leave the king in check.
+			 * @param list Where the moves will be stored.
+			 * @param captures_only True to only generate captures and promotions.
+			 */
+			void GenerateMoves(MoveList&, bool = false) const;
+
+			/**
+			 * Generates every legal move.
+			 * @param list Where the moves will be stored.
+			 */
+			void GenerateLegalMoves(MoveList&);
+
+			/**
+			 * Plays a move. The move must come from GenerateMoves.
+			 * @param move The move.
+			 * @param undo Where the information to take the move back will be stored.
+			 * @return False if the move left the mover's king in check. It must still be taken back.
+			 */
+			bool DoMove(Move16, Undo&);
+
+			/**
+			 * Takes back a move.
+			 * @param undo The information from DoMove.
+			 */
+			void UndoMove(const Undo&);
+
+			/**
+			 * Passes the turn to the other side.
+			 * @param undo Where the information to take the pass back will be stored.
+			 */
+			void DoNullMove(Undo&);
+
+			/**
+			 * Takes back a pass.
+			 * @param undo The information from DoNullMove.
+			 */
+			void UndoNullMove(const Undo&);
+
+			/**
+			 * Checks if the position has been seen before with the same side to move.
+			 * Only the positions since the last capture or pawn move are looked at, since nothing before it can come back.
+			 * @param times How many earlier occurrences count (1 inside a search, 2 for a threefold repetition).
+			 * @return True if the position occurred at least times before.
+			 */
+			bool IsRepetition(int) const;
+
+			/**
+			 * Checks the fifty-move rule.
+			 * @return True if fifty moves have been played by each side without a capture or pawn move.
+			 */
+			bool IsFiftyMoves(void) const;
+
+			/**
+			 * Counts the leaf nodes of the legal move tree. Used to check the move generator.
+			 * @param depth The depth.
+			 * @return The number of leaf nodes.
+			 */
+			sf::Uint64 Perft(int);
+
+		private:
+			/**
+			 * Puts a piece on a square and updates the hash.
+			 * @param square The square.
+			 * @param piece The piece.
+			 */
+			void Put(int, short);
+
+			/**
+			 * Removes the piece on a square and updates the hash.
+			 * @param square The square.
+			 */
+			void Remove(int);
+		};
+	};
+};
+
+////////// SOURCE //////////
+
+namespace SimpleChess {
+	namespace Engine {
+		static const sf::Int8 KnightSteps[8][2] = { { 1, 2 }, { 2, 1 }, { 2, -1 }, { 1, -2 }, { -1, -2 }, { -2, -1 }, { -2, 1 }, { -1, 2 } },
+							  KingSteps[8][2] = { { 1, 0 }, { 1, 1 }, { 0, 1 }, { -1, 1 }, { -1, 0 }, { -1, -1 }, { 0, -1 }, { 1, -1 } },
+							  RookSteps[4][2] = { { 1, 0 }, { -1, 0 }, { 0, 1 }, { 0, -1 } },
+							  BishopSteps[4][2] = { { 1, 1 }, { -1, 1 }, { 1, -1 }, { -1, -1 } };
+
+		/**
+		 * Castling rights that survive a move touching each square.
+		 */
+		static const sf::Uint8 CastlingMask[64] = {
+			static_cast<sf::Uint8>(~Castling::BlackQueenSide & 15), 15, 15, 15, static_cast<sf::Uint8>(~(Castling::BlackKingSide | Castling::BlackQueenSide) & 15), 15, 15, static_cast<sf::Uint8>(~Castling::BlackKingSide & 15),
+			15, 15, 15, 15, 15, 15, 15, 15,
+			15, 15, 15, 15, 15, 15, 15, 15,
+			15, 15, 15, 15, 15, 15, 15, 15,
+			15, 15, 15, 15, 15, 15, 15, 15,
+			15, 15, 15, 15, 15, 15, 15, 15,
+			15, 15, 15, 15, 15, 15, 15, 15,
+			static_cast<sf::Uint8>(~Castling::WhiteQueenSide & 15), 15, 15, 15, static_cast<sf::Uint8>(~(Castling::WhiteKingSide | Castling::WhiteQueenSide) & 15), 15, 15, static_cast<sf::Uint8>(~Castling::WhiteKingSide & 15)
+		};
+	};
+};
+
+void SimpleChess::Engine::Zobrist::Initialize(void) {
+	sf::Uint64 state = 0x9E3779B97F4A7C15ULL;
+	auto next = [&state]() {
+		// SplitMix64, so the keys never change between runs.
+		sf::Uint64 z = (state += 0x9E3779B97F4A7C15ULL);
+		z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+		z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+		return z ^ (z >> 31);
+	};
+
+	for (short piece = 0; piece < 13; piece++) {
+		for (short square = 0; square < 64; square++) {
+			PieceSquare[piece][square] = piece is Pieces::Empty ? 0 : next();
+		}
+	}
+
+	CastlingRights[0] = 0;
+	for (short rights = 1; rights < 16; rights++) {
+		CastlingRights[rights] = next();
+	}
+
+	for (short file = 0; file < 8; file++) {
+		EnPassant[file] = next();
+	}
+
+	SideToMove = next();
+}
+
+SimpleChess::Engine::Move16 SimpleChess::Engine::CreateMove(int from, int to, sf::Uint16 flag, short promotion) {
+	sf::Uint16 promo = 0;
+
+	switch (promotion) {
+		case Pieces::White_Knight: promo = 0; break;
+		case Pieces::White_Bishop: promo = 1; break;
+		case Pieces::White_Rook: promo = 2; break;
+		default: promo = 3;
+	}
+
+	return static_cast<Move16>(from | (to << 6) | (promo << 12) | flag);
+}
+
+int SimpleChess::Engine::FromSquare(Move16 move) {
+	return move & 63;
+}
+
+int SimpleChess::Engine::ToSquare(Move16 move) {
+	return (move >> 6) & 63;
+}
+
+sf::Uint16 SimpleChess::Engine::FlagOf(Move16 move) {
+	return move & (3 << 14);
+}
+
+short SimpleChess::Engine::PromotionOf(Move16 move, short side) {
+	static const short types[4] = { Pieces::White_Knight, Pieces::White_Bishop, Pieces::White_Rook, Pieces::White_Queen };
+	return MakePiece(types[(move >> 12) & 3], side);
+}
+
+short SimpleChess::Engine::TypeOf(short piece) {
+	return piece > 6 ? piece - 6 : piece;
+}
+
+short SimpleChess::Engine::SideOf(short piece) {
+	return piece is Pieces::Empty ? 0 : (piece > 6 ? 2 : 1);
+}
+
+short SimpleChess::Engine::MakePiece(short type, short side) {
+	return side is 2 ? type + 6 : type;
+}
+
+void SimpleChess::Engine::Position::Reset(void) {
+	static const short back[8] = { Pieces::White_Rook, Pieces::White_Knight, Pieces::White_Bishop, Pieces::White_Queen, Pieces::White_King, Pieces::White_Bishop, Pieces::White_Knight, Pieces::White_Rook };
+	Board8 board;
+
+	for (short x = 0; x < 8; x++) {
+		board[0][x] = MakePiece(back[x], 2);
+		board[1][x] = Pieces::Black_Pawn;
+		board[6][x] = Pieces::White_Pawn;
+		board[7][x] = back[x];
+
+		for (short y = 2; y < 6; y++) {
+			board[y][x] = Pieces::Empty;
+		}
+	}
+
+	FromBoard(board, 1);
+}
+
+void SimpleChess::Engine::Position::FromBoard(const Board8& board, short side) {
+	Board = board;
+	SideToMove = side;
+	EnPassant = -1;
+	HalfMoves = 0;
+	FullMoves = 1;
+	Kings = { { -1, -1, -1 } };
+	HashHistory.clear();
+	CastlingRights = 0;
+
+	for (int square = 0; square < 64; square++) {
+		if (At(square) is Pieces::White_King) {
+			Kings[1] = square;
+		} else if (At(square) is Pieces::Black_King) {
+			Kings[2] = square;
+		}
+	}
+
+	if (At(60) is Pieces::White_King) {
+		CastlingRights |= At(63) is Pieces::White_Rook ? Castling::WhiteKingSide : 0;
+		CastlingRights |= At(56) is Pieces::White_Rook ? Castling::WhiteQueenSide : 0;
+	}
+
+	if (At(4) is Pieces::Black_King) {
+		CastlingRights |= At(7) is Pieces::Black_Rook ? Castling::BlackKingSide : 0;
+		CastlingRights |= At(0) is Pieces::Black_Rook ? Castling::BlackQueenSide : 0;
+	}
+
+	Hash = ComputeHash();
+}
+
+bool SimpleChess::Engine::Position::FromFEN(const char* fen) {
+	static const char pieces[] = ".PRNBQKprnbqk";
+	Board8 board;
+	int y = 0, x = 0;
+
+	while (*fen is ' ') {
+		fen++;
+	}
+
+	for (; *fen and *fen != ' '; fen++) {
+		if (*fen is '/') {
+			if (x != 8 or ++y > 7) {
+				return false;
+			}
+			x = 0;
+		} else if (*fen >= '1' and *fen <= '8') {
+			for (int empty = *fen - '0'; empty > 0; empty--) {
+				if (x > 7) {
+					return false;
+				}
+				board[y][x++] = Pieces::Empty;
+			}
+		} else {
+			const char* found = strchr(pieces + 1, *fen);
+			if (found is NULL or x > 7) {
+				return false;
+			}
+			board[y][x++] = static_cast<short>(found - pieces);
+		}
+	}
+
+	if (y != 7 or x != 8 or *fen++ != ' ') {
+		return false;
+	}
+
+	for (x = 0; x < 8; x++) {
+		if (TypeOf(board[0][x]) is Pieces::White_Pawn or TypeOf(board[7][x]) is Pieces::White_Pawn) {
+			return false;
+		}
+	}
+
+	if (*fen != 'w' and *fen != 'b') {
+		return false;
+	}
+
+	FromBoard(board, *fen++ is 'w' ? 1 : 2);
+
+	if (*fen++ != ' ') {
+		return false;
+	}
+
+	// Rights the pieces on the board cannot back up are dropped.
+	const sf::Uint8 possible = CastlingRights;
+	CastlingRights = 0;
+	for (; *fen and *fen != ' '; fen++) {
+		switch (*fen) {
+			case 'K': CastlingRights |= Castling::WhiteKingSide; break;
+			case 'Q': CastlingRights |= Castling::WhiteQueenSide; break;
+			case 'k': CastlingRights |= Castling::BlackKingSide; break;
+			case 'q': CastlingRights |= Castling::BlackQueenSide; break;
+			case '-': break;
+			default: return false;
+		}
+	}
+
+	CastlingRights &= possible;
+
+	if (*fen++ != ' ') {
+		return false;
+	}
+
+	EnPassant = -1;
+	if (*fen >= 'a' and *fen <= 'h' and (fen[1] is '3' or fen[1] is '6')) {
+		EnPassant = static_cast<sf::Int8>(('8' - fen[1]) * 8 + (fen[0] - 'a'));
+		fen += 2;
+	} else if (*fen++ != '-') {
+		return false;
+	}
+
+	HalfMoves = 0;
+	FullMoves = 1;
+
+	while (*fen is ' ') {
+		fen++;
+	}
+
+	if (*fen >= '0' and *fen <= '9') {
+		for (HalfMoves = 0; *fen >= '0' and *fen <= '9'; fen++) {
+			HalfMoves = static_cast<short>(HalfMoves * 10 + (*fen - '0'));
+		}
+
+		while (*fen is ' ') {
+			fen++;
+		}
+
+		for (FullMoves = 0; *fen >= '0' and *fen <= '9'; fen++) {
+			FullMoves = static_cast<short>(FullMoves * 10 + (*fen - '0'));
+		}
+
+		FullMoves = std::max<short>(FullMoves, 1);
+	}
+
+	Hash = ComputeHash();
+	return Kings[1] >= 0 and Kings[2] >= 0;
+}
+
+short SimpleChess::Engine::Position::At(int square) const {
+	return Board[square >> 3][square & 7];
+}
+
+sf::Uint64 SimpleChess::Engine::Position::ComputeHash(void) const {
+	sf::Uint64 hash = 0;
+
+	for (int square = 0; square < 64; square++) {
+		hash ^= Zobrist::PieceSquare[At(square)][square];
+	}
+
+	hash ^= Zobrist::CastlingRights[CastlingRights];
+
+	if (EnPassant >= 0) {
+		hash ^= Zobrist::EnPassant[EnPassant & 7];
+	}
+
+	if (SideToMove is 2) {
+		hash ^= Zobrist::SideToMove;
+	}
+
+	return hash;
+}
+
+bool SimpleChess::Engine::Position::IsAttacked(int square, short side) const {
+	const int sy = square >> 3, sx = square & 7;
+
+	// A white pawn attacks upwards (towards row 0), so it sits one row below the square.
+	const int py = side is 1 ? sy + 1 : sy - 1;
+	const short pawn = MakePiece(Pieces::White_Pawn, side);
+	if (py >= 0 and py < 8) {
+		if ((sx - 1 >= 0 and Board[py][sx - 1] is pawn) or (sx + 1 < 8 and Board[py][sx + 1] is pawn)) {
+			return true;
+		}
+	}
+
+	const short knight = MakePiece(Pieces::White_Knight, side),
+				king = MakePiece(Pieces::White_King, side),
+				rook = MakePiece(Pieces::White_Rook, side),
+				bishop = MakePiece(Pieces::White_Bishop, side),
+				queen = MakePiece(Pieces::White_Queen, side);
+
+	for (short i = 0; i < 8; i++) {
+		int x = sx + KnightSteps[i][0], y = sy + KnightSteps[i][1];
+		if (x >= 0 and x < 8 and y >= 0 and y < 8 and Board[y][x] is knight) {
+			return true;
+		}
+
+		x = sx + KingSteps[i][0];
+		y = sy + KingSteps[i][1];
+		if (x >= 0 and x < 8 and y >= 0 and y < 8 and Board[y][x] is king) {
+			return true;
+		}
+	}
+
+	for (short i = 0; i < 4; i++) {
+		for (int x = sx + RookSteps[i][0], y = sy + RookSteps[i][1]; x >= 0 and x < 8 and y >= 0 and y < 8; x += RookSteps[i][0], y += RookSteps[i][1]) {
+			if (Board[y][x] is Pieces::Empty) {
+				continue;
+			}
+
+			if (Board[y][x] is rook or Board[y][x] is queen) {
+				return true;
+			}
+			break;
+		}
+
+		for (int x = sx + BishopSteps[i][0], y = sy + BishopSteps[i][1]; x >= 0 and x < 8 and y >= 0 and y < 8; x += BishopSteps[i][0], y += BishopSteps[i][1]) {
+			if (Board[y][x] is Pieces::Empty) {
+				continue;
+			}
+
+			if (Board[y][x] is bishop or Board[y][x] is queen) {
+				return true;
+			}
+			break;
+		}
+	}
+
+	return false;
+}
+
+bool SimpleChess::Engine::Position::InCheck(void) const {
+	return Kings[SideToMove] >= 0 and IsAttacked(Kings[SideToMove], 3 - SideToMove);
+}
+
+void SimpleChess::Engine::Position::GenerateMoves(MoveList& list, bool captures_only) const {
+	const short us = SideToMove, them = 3 - us;
+
+	for (int from = 0; from < 64; from++) {
+		const short piece = At(from);
+		if (SideOf(piece) != us) {
+			continue;
+		}
+
+		const int fy = from >> 3, fx = from & 7;
+
+		switch (TypeOf(piece)) {
+			case Pieces::White_Pawn: {
+				const int dir = us is 1 ? -1 : 1, start = us is 1 ? 6 : 1, last = us is 1 ? 0 : 7;
+				const int ty = fy + dir;
+
+				if (Board[ty][fx] is Pieces::Empty) {
+					if (ty is last) {
+						list.Push(CreateMove(from, ty * 8 + fx, MoveFlag::Promotion, Pieces::White_Queen));
+						if (not captures_only) {
+							list.Push(CreateMove(from, ty * 8 + fx, MoveFlag::Promotion, Pieces::White_Knight));
+							list.Push(CreateMove(from, ty * 8 + fx, MoveFlag::Promotion, Pieces::White_Rook));
+							list.Push(CreateMove(from, ty * 8 + fx, MoveFlag::Promotion, Pieces::White_Bishop));
+						}
+					} else if (not captures_only) {
+						list.Push(CreateMove(from, ty * 8 + fx));
+
+						if (fy is start and Board[ty + dir][fx] is Pieces::Empty) {
+							list.Push(CreateMove(from, (ty + dir) * 8 + fx));
+						}
+					}
+				}
+
+				for (int tx = fx - 1; tx <= fx + 1; tx += 2) {
+					if (tx < 0 or tx > 7) {
+						continue;
+					}
+
+					const int to = ty * 8 + tx;
+					if (SideOf(Board[ty][tx]) is them) {
+						if (ty is last) {
+							list.Push(CreateMove(from, to, MoveFlag::Promotion, Pieces::White_Queen));
+							list.Push(CreateMove(from, to, MoveFlag::Promotion, Pieces::White_Knight));
+							list.Push(CreateMove(from, to, MoveFlag::Promotion, Pieces::White_Rook));
+							list.Push(CreateMove(from, to, MoveFlag::Promotion, Pieces::White_Bishop));
+						} else {
+							list.Push(CreateMove(from, to));
+						}
+					} else if (to is EnPassant) {
+						list.Push(CreateMove(from, to, MoveFlag::EnPassant));
+					}
+				}
+			} break;
+			case Pieces::White_Knight:
+			case Pieces::White_King: {
+				const sf::Int8 (*steps)[2] = TypeOf(piece) is Pieces::White_Knight ? KnightSteps : KingSteps;
+
+				for (short i = 0; i < 8; i++) {
+					const int tx = fx + steps[i][0], ty = fy + steps[i][1];
+					if (tx < 0 or tx > 7 or ty < 0 or ty > 7) {
+						continue;
+					}
+
+					const short target = SideOf(Board[ty][tx]);
+					if (target is them or (target is 0 and not captures_only)) {
+						list.Push(CreateMove(from, ty * 8 + tx));
+					}
+				}
+			} break;
+			default: {
+				const short type = TypeOf(piece);
+
+				for (short i = 0; i < 8; i++) {
+					const sf::Int8* step = i < 4 ? RookSteps[i] : BishopSteps[i - 4];
+					if ((i < 4 and type is Pieces::White_Bishop) or (i >= 4 and type is Pieces::White_Rook)) {
+						continue;
+					}
+
+					for (int tx = fx + step[0], ty = fy + step[1]; tx >= 0 and tx < 8 and ty >= 0 and ty < 8; tx += step[0], ty += step[1]) {
+						const short target = SideOf(Board[ty][tx]);
+
+						if (target is 0) {
+							if (not captures_only) {
+								list.Push(CreateMove(from, ty * 8 + tx));
+							}
+							continue;
+						}
+
+						if (target is them) {
+							list.Push(CreateMove(from, ty * 8 + tx));
+						}
+						break;
+					}
+				}
+			}
+		}
+	}
+
+	if (captures_only or Kings[us] < 0) {
+		return;
+	}
+
+	// Castling: the squares between must be empty and the king may not pass through check.
+	if (us is 1 and Kings[1] is 60) {
+		if ((CastlingRights & Castling::WhiteKingSide) and At(61) is Pieces::Empty and At(62) is Pieces::Empty and not IsAttacked(60, them) and not IsAttacked(61, them) and not IsAttacked(62, them)) {
+			list.Push(CreateMove(60, 62, MoveFlag::Castling));
+		}
+
+		if ((CastlingRights & Castling::WhiteQueenSide) and At(59) is Pieces::Empty and At(58) is Pieces::Empty and At(57) is Pieces::Empty and not IsAttacked(60, them) and not IsAttacked(59, them) and not IsAttacked(58, them)) {
+			list.Push(CreateMove(60, 58, MoveFlag::Castling));
+		}
+	} else if (us is 2 and Kings[2] is 4) {
+		if ((CastlingRights & Castling::BlackKingSide) and At(5) is Pieces::Empty and At(6) is Pieces::Empty and not IsAttacked(4, them) and not IsAttacked(5, them) and not IsAttacked(6, them)) {
+			list.Push(CreateMove(4, 6, MoveFlag::Castling));
+		}
+
+		if ((CastlingRights & Castling::BlackQueenSide) and At(3) is Pieces::Empty and At(2) is Pieces::Empty and At(1) is Pieces::Empty and not IsAttacked(4, them) and not IsAttacked(3, them) and not IsAttacked(2, them)) {
+			list.Push(CreateMove(4, 2, MoveFlag::Castling));
+		}
+	}
+}
+
+void SimpleChess::Engine::Position::GenerateLegalMoves(MoveList& list) {
+	MoveList pseudo;
+	GenerateMoves(pseudo);
+
+	list.Size = 0;
+	for (unsigned short i = 0; i < pseudo.Size; i++) {
+		Undo undo;
+		if (DoMove(pseudo.Moves[i], undo)) {
+			list.Push(pseudo.Moves[i]);
+		}
+		UndoMove(undo);
+	}
+}
+
+void SimpleChess::Engine::Position::Put(int square, short piece) {
+	Board[square >> 3][square & 7] = piece;
+	Hash ^= Zobrist::PieceSquare[piece][square];
+
+	if (TypeOf(piece) is Pieces::White_King) {
+		Kings[SideOf(piece)] = square;
+	}
+}
+
+void SimpleChess::Engine::Position::Remove(int square) {
+	const short piece = At(square);
+	Board[square >> 3][square & 7] = Pieces::Empty;
+	Hash ^= Zobrist::PieceSquare[piece][square];
+
+	if (TypeOf(piece) is Pieces::White_King) {
+		Kings[SideOf(piece)] = -1;
+	}
+}
+
+bool SimpleChess::Engine::Position::DoMove(Move16 move, Undo& undo) {
+	const int from = FromSquare(move), to = ToSquare(move);
+	const sf::Uint16 flag = FlagOf(move);
+	const short us = SideToMove, piece = At(from);
+
+	undo.Played = move;
+	undo.Captured = At(to);
+	undo.CastlingRights = CastlingRights;
+	undo.EnPassant = EnPassant;
+	undo.HalfMoves = HalfMoves;
+	undo.Hash = Hash;
+	HashHistory.push_back(Hash);
+
+	if (EnPassant >= 0) {
+		Hash ^= Zobrist::EnPassant[EnPassant & 7];
+		EnPassant = -1;
+	}
+
+	HalfMoves++;
+
+	if (flag is MoveFlag::EnPassant) {
+		const int victim = us is 1 ? to + 8 : to - 8;
+		undo.Captured = At(victim);
+		Remove(victim);
+	} else if (undo.Captured != Pieces::Empty) {
+		Remove(to);
+	}
+
+	if (undo.Captured != Pieces::Empty or TypeOf(piece) is Pieces::White_Pawn) {
+		HalfMoves = 0;
+	}
+
+	Remove(from);
+	Put(to, flag is MoveFlag::Promotion ? PromotionOf(move, us) : piece);
+
+	if (flag is MoveFlag::Castling) {
+		const int rook_from = to > from ? to + 1 : to - 2, rook_to = to > from ? to - 1 : to + 1;
+		const short rook = At(rook_from);
+		Remove(rook_from);
+		Put(rook_to, rook);
+	}
+
+	if (TypeOf(piece) is Pieces::White_Pawn and (to - from is 16 or from - to is 16)) {
+		EnPassant = static_cast<sf::Int8>((from + to) / 2);
+		Hash ^= Zobrist::EnPassant[EnPassant & 7];
+	}
+
+	Hash ^= Zobrist::CastlingRights[CastlingRights];
+	CastlingRights &= CastlingMask[from] & CastlingMask[to];
+	Hash ^= Zobrist::CastlingRights[CastlingRights];
+
+	if (us is 2) {
+		FullMoves++;
+	}
+
+	SideToMove = 3 - us;
+	Hash ^= Zobrist::SideToMove;
+
+	return Kings[us] < 0 or not IsAttacked(Kings[us], SideToMove);
+}
+
+void SimpleChess::Engine::Position::UndoMove(const Undo& undo) {
+	const int from = FromSquare(undo.Played), to = ToSquare(undo.Played);
+	const sf::Uint16 flag = FlagOf(undo.Played);
+
+	SideToMove = 3 - SideToMove;
+	const short us = SideToMove;
+
+	if (us is 2) {
+		FullMoves--;
+	}
+
+	if (flag is MoveFlag::Castling) {
+		const int rook_from = to > from ? to + 1 : to - 2, rook_to = to > from ? to - 1 : to + 1;
+		const short rook = At(rook_to);
+		Remove(rook_to);
+		Put(rook_from, rook);
+	}
+
+	const short piece = flag is MoveFlag::Promotion ? MakePiece(Pieces::White_Pawn, us) : At(to);
+	Remove(to);
+	Put(from, piece);
+
+	if (flag is MoveFlag::EnPassant) {
+		Put(us is 1 ? to + 8 : to - 8, undo.Captured);
+	} else if (undo.Captured != Pieces::Empty) {
+		Put(to, undo.Captured);
+	}
+
+	CastlingRights = undo.CastlingRights;
+	EnPassant = undo.EnPassant;
+	HalfMoves = undo.HalfMoves;
+	Hash = undo.Hash;
+	HashHistory.pop_back();
+}
+
+void SimpleChess::Engine::Position::DoNullMove(Undo& undo) {
+	undo.Played = NoMove;
+	undo.Captured = Pieces::Empty;
+	undo.CastlingRights = CastlingRights;
+	undo.EnPassant = EnPassant;
+	undo.HalfMoves = HalfMoves;
+	undo.Hash = Hash;
+	HashHistory.push_back(Hash);
+
+	if (EnPassant >= 0) {
+		Hash ^= Zobrist::EnPassant[EnPassant & 7];
+		EnPassant = -1;
+	}
+
+	// A pass is not a real move, so repetitions may not reach across it.
+	HalfMoves = 0;
+	SideToMove = 3 - SideToMove;
+	Hash ^= Zobrist::SideToMove;
+}
+
+void SimpleChess::Engine::Position::UndoNullMove(const Undo& undo) {
+	SideToMove = 3 - SideToMove;
+	EnPassant = undo.EnPassant;
+	HalfMoves = undo.HalfMoves;
+	Hash = undo.Hash;
+	HashHistory.pop_back();
+}
+
+bool SimpleChess::Engine::Position::IsRepetition(int times) const {
+	const int size = static_cast<int>(HashHistory.size()),
+			  end = std::max(size - HalfMoves, 0);
+	int count = 0;
+
+	for (int i = size - 2; i >= end; i -= 2) {
+		if (HashHistory[i] is Hash and ++count >= times) {
+			return true;
+		}
+	}
+
+	return false;
+}
+
+bool SimpleChess::Engine::Position::IsFiftyMoves(void) const {
+	return HalfMoves >= 100;
+}
+
+sf::Uint64 SimpleChess::Engine::Position::Perft(int depth) {
+	MoveList list;
+	GenerateMoves(list);
+
+	sf::Uint64 nodes = 0;
+	for (unsigned short i = 0; i < list.Size; i++) {
+		Undo undo;
+		if (DoMove(list.Moves[i], undo)) {
+			nodes += depth <= 1 ? 1 : Perft(depth - 1);
+		}
+		UndoMove(undo);
+	}
+
+	return nodes;
+}
+
+std::string SimpleChess::Engine::MoveToString(Move16 move) {
+	static const char promotions[] = "nbrq";
+	std::string str;
+
+	str += static_cast<char>('a' + (FromSquare(move) & 7));
+	str += static_cast<char>('8' - (FromSquare(move) >> 3));
+	str += static_cast<char>('a' + (ToSquare(move) & 7));
+	str += static_cast<char>('8' - (ToSquare(move) >> 3));
+
+	if (FlagOf(move) is MoveFlag::Promotion) {
+		str += promotions[(move >> 12) & 3];
+	}
+
+	return str;
+}
+
+SimpleChess::Engine::Move16 SimpleChess::Engine::ParseMove(Position& position, const std::string& str) {
+	MoveList list;
+	position.GenerateLegalMoves(list);
+
+	for (unsigned short i = 0; i < list.Size; i++) {
+		if (MoveToString(list.Moves[i]) is str) {
+			return list.Moves[i];
+		}
+	}
+
+	return NoMove;
+}
+
+#endif
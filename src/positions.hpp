@@ -0,0 +1,360 @@
+/*
+ *  positions.hpp
+ *  SimpleChess
+ *
+ *  Copyright (c) 2013-2015 Ronak Gajrawala. All rights reserved.
+ */
+
+#ifndef SimpleChess_positions_hpp
+#define SimpleChess_positions_hpp
+
+namespace SimpleChess {
+	/**
+	 * The Positions class.
+	 * An index of every position reached in a game archive, to find the games that reached a position.
+	 * It is kept next to the archive (<archive>.pos) as postings sorted by hash, so a lookup is a binary search in the mapped file.
+	 * All numbers are little-endian.
+	 *
+	 *   offset  size  field
+	 *        0     4  magic "SCP" 0x1A
+	 *        4     2  version
+	 *        6     2  reserved (0)
+	 *        8     8  number of postings
+	 *       16     8  number of games indexed
+	 *       24  16*p  postings: position hash (8), game in the archive (4), moves played to reach it (4)
+	 */
+	namespace Positions {
+		const char Magic[4] = { 'S', 'C', 'P', 0x1A }; /**< The first bytes of every position index. */
+		const sf::Uint16 Version = 1; /**< The version this code writes and reads. */
+		const std::size_t HeaderSize = 24; /**< Bytes before the first posting. */
+		const std::size_t PostingSize = 16; /**< Bytes per posting. */
+		const std::size_t BatchSize = 64; /**< Games each thread takes at a time while building. */
+
+		/**
+		 * A position reached in a game.
+		 */
+		class Posting {
+		public:
+			sf::Uint64 Hash = 0; /**< The position's Zobrist hash. */
+			sf::Uint32 Game = 0; /**< The game, as its number in the archive's directory. */
+			sf::Uint32 Ply = 0; /**< The number of moves played to reach the position (0 for the start). */
+
+			/**
+			 * Orders postings by hash, then game, then ply.
+			 * @param other The other posting.
+			 * @return True if this posting comes first.
+			 */
+			bool operator<(const Posting&) const;
+		};
+
+		/**
+		 * A read-only view of a position index mapped into memory.
+		 */
+		class Table {
+		public:
+			/**
+			 * Maps the position index of an archive. An open table is closed first.
+			 * @param archive The name of the archive.
+			 * @return False if the archive has no position index yet.
+			 */
+			bool Open(std::string);
+
+			/**
+			 * Unmaps the index.
+			 */
+			void Close(void);
+
+			/**
+			 * Checks if an index is open.
+			 * @return True if an index is open.
+			 */
+			bool IsOpen(void) const;
+
+			/**
+			 * Counts the postings.
+			 * @return The number of postings.
+			 */
+			std::size_t Size(void) const;
+
+			/**
+			 * Counts the games that were indexed. Fewer than the archive holds means the index is out of date.
+			 * @return The number of games.
+			 */
+			std::size_t Games(void) const;
+
+			/**
+			 * Gets a posting without checking the index.
+			 * @param index The posting, from 0.
+			 * @return The posting.
+			 */
+			Posting operator[](std::size_t) const;
+
+			/**
+			 * Finds where a position was reached.
+			 * @param hash The position's hash.
+			 * @param found Where the postings will be dumped, by game and then ply.
+			 * @return The number of postings found.
+			 */
+			std::size_t Find(sf::Uint64, std::vector<Posting>&) const;
+
+		private:
+			/**
+			 * Reads the hash of a posting.
+			 * @param index The posting, from 0.
+			 * @return The hash.
+			 */
+			sf::Uint64 HashAt(std::size_t) const;
+
+			File::Mapping Map; /**< The mapped index. */
+			std::size_t Count = 0, /**< The number of postings. */
+						GameCount = 0; /**< The number of games indexed. */
+		};
+
+		/**
+		 * Builds the position index of an archive, replacing the old one.
+		 * Games are replayed on several threads, each thread sorts its own postings and the sorted runs are merged into the file.
+		 * @param archive The name of the archive.
+		 * @param threads The number of threads, 0 for one per core.
+		 * @return The number of postings written.
+		 */
+		sf::Uint64 Build(std::string, int = 0);
+	};
+};
+
+////////// SOURCE //////////
+
+bool SimpleChess::Positions::Posting::operator<(const Posting& other) const {
+	if (Hash != other.Hash) {
+		return Hash < other.Hash;
+	}
+	return Game != other.Game ? Game < other.Game : Ply < other.Ply;
+}
+
+bool SimpleChess::Positions::Table::Open(std::string archive) {
+	Close();
+
+	try {
+		Map.Open(archive + ".pos");
+	} catch (int e) {
+		return false;
+	}
+
+	if (Map.Size() < HeaderSize or memcmp(Map.Data(), Magic, 4) != 0 or SCG::ReadLE(Map.Data() + 4, 2) != Version) {
+		Close();
+		FError(false, "ERROR: %s.pos is not a version %d position index!", archive.c_str(), Version);
+
+		throw 2;
+		return false;
+	}
+
+	Count = static_cast<std::size_t>(SCG::ReadLE(Map.Data() + 8, 8));
+	GameCount = static_cast<std::size_t>(SCG::ReadLE(Map.Data() + 16, 8));
+
+	if (Count > (Map.Size() - HeaderSize) / PostingSize) {
+		Close();
+		FError(false, "ERROR: %s.pos is cut short!", archive.c_str());
+
+		throw 2;
+		return false;
+	}
+
+	return true;
+}
+
+void SimpleChess::Positions::Table::Close(void) {
+	Map.Close();
+	Count = GameCount = 0;
+}
+
+bool SimpleChess::Positions::Table::IsOpen(void) const {
+	return Map.IsOpen();
+}
+
+std::size_t SimpleChess::Positions::Table::Size(void) const {
+	return Count;
+}
+
+std::size_t SimpleChess::Positions::Table::Games(void) const {
+	return GameCount;
+}
+
+SimpleChess::Positions::Posting SimpleChess::Positions::Table::operator[](std::size_t index) const {
+	const unsigned char* data = Map.Data() + HeaderSize + index * PostingSize;
+	Posting posting;
+	posting.Hash = SCG::ReadLE(data, 8);
+	posting.Game = static_cast<sf::Uint32>(SCG::ReadLE(data + 8, 4));
+	posting.Ply = static_cast<sf::Uint32>(SCG::ReadLE(data + 12, 4));
+	return posting;
+}
+
+sf::Uint64 SimpleChess::Positions::Table::HashAt(std::size_t index) const {
+	return SCG::ReadLE(Map.Data() + HeaderSize + index * PostingSize, 8);
+}
+
+std::size_t SimpleChess::Positions::Table::Find(sf::Uint64 hash, std::vector<Posting>& found) const {
+	found.clear();
+
+	// The first posting with the hash, by binary search.
+	std::size_t low = 0, high = Count;
+	while (low < high) {
+		const std::size_t middle = low + (high - low) / 2;
+		if (HashAt(middle) < hash) {
+			low = middle + 1;
+		} else {
+			high = middle;
+		}
+	}
+
+	for (; low < Count and HashAt(low) is hash; low++) {
+		found.push_back((*this)[low]);
+	}
+
+	return found.size();
+}
+
+sf::Uint64 SimpleChess::Positions::Build(std::string archive, int threads) {
+	SCG::Directory directory;
+	File::Mapping map;
+
+	if (not directory.Open(archive)) {
+		FError(false, "ERROR: %s has no directory!", archive.c_str());
+
+		throw 1;
+		return 0;
+	}
+	map.Open(archive);
+
+	// Check every game first, since the threads that replay them cannot throw.
+	std::vector<SCG::Game> starts(directory.Size());
+	std::vector<SCG::Entry> entries(directory.Size());
+	for (std::size_t i = 0; i < entries.size(); i++) {
+		entries[i] = directory[i];
+		if (entries[i].Offset + SCG::HeaderSize > map.Size()) {
+			FError(false, "ERROR: %s is cut short!", archive.c_str());
+
+			throw 2;
+			return 0;
+		}
+
+		entries[i].Plies = SCG::ReadHeader(map.Data() + entries[i].Offset, archive, starts[i]);
+		if (entries[i].Offset + SCG::HeaderSize + static_cast<sf::Uint64>(entries[i].Plies) * 2 > map.Size()) {
+			FError(false, "ERROR: %s is cut short!", archive.c_str());
+
+			throw 2;
+			return 0;
+		}
+	}
+
+	// Map: every thread replays batches of games and sorts the postings it made.
+	threads = threads > 0 ? threads : std::max<int>(1, std::thread::hardware_concurrency());
+	std::vector<std::vector<Posting>> runs(static_cast<std::size_t>(threads));
+	std::atomic<std::size_t> next(0);
+
+	const auto worker = [&](std::size_t id) {
+		std::vector<Posting>& run = runs[id];
+		Engine::Position position;
+		Engine::Undo undo;
+
+		for (std::size_t first = next.fetch_add(BatchSize); first < entries.size(); first = next.fetch_add(BatchSize)) {
+			for (std::size_t i = first; i < std::min(first + BatchSize, entries.size()); i++) {
+				const unsigned char* moves = map.Data() + entries[i].Offset + SCG::HeaderSize;
+				Posting posting;
+				posting.Game = static_cast<sf::Uint32>(i);
+
+				Codec::StartPosition(starts[i], position);
+				for (sf::Uint32 ply = 0;; ply++) {
+					posting.Hash = position.Hash;
+					posting.Ply = ply;
+					run.push_back(posting);
+
+					// The Reader stops a game at its first broken move, so its postings stop there too.
+					if (ply is entries[i].Plies or Replay::Play(position, static_cast<Engine::Move16>(SCG::ReadLE(moves + ply * 2, 2)), undo) is Replay::Rules::Broken) {
+						break;
+					}
+				}
+			}
+		}
+
+		std::sort(run.begin(), run.end());
+	};
+
+	std::vector<std::thread> workers;
+	for (int t = 1; t < threads; t++) {
+		workers.emplace_back(worker, static_cast<std::size_t>(t));
+	}
+	worker(0);
+
+	for (auto& thread : workers) {
+		thread.join();
+	}
+
+	// Reduce: merge the sorted runs straight into the file.
+	std::ofstream fl(File::Path + archive + ".pos", std::ios::out | std::ios::binary | std::ios::trunc);
+	if (not fl.is_open()) {
+		FError(false, "ERROR: %s.pos could not be opened!", archive.c_str());
+
+		throw 1;
+		return 0;
+	}
+
+	sf::Uint64 total = 0;
+	for (const auto& run : runs) {
+		total += run.size();
+	}
+
+	unsigned char header[HeaderSize] = { 0 };
+	memcpy(header, Magic, 4);
+	SCG::WriteLE(header + 4, Version, 2);
+	SCG::WriteLE(header + 8, total, 8);
+	SCG::WriteLE(header + 16, entries.size(), 8);
+	fl.write(reinterpret_cast<const char*>(header), HeaderSize);
+
+	typedef std::pair<Posting, std::size_t> Head;
+	const auto later = [](const Head& a, const Head& b) {
+		return b.first < a.first;
+	};
+	std::priority_queue<Head, std::vector<Head>, decltype(later)> heads(later);
+	std::vector<std::size_t> positions(runs.size(), 0);
+
+	for (std::size_t r = 0; r < runs.size(); r++) {
+		if (not runs[r].empty()) {
+			heads.push(Head(runs[r][0], r));
+		}
+	}
+
+	std::vector<unsigned char> buffer(PostingSize * 65536);
+	std::size_t used = 0;
+
+	while (not heads.empty()) {
+		const Head head = heads.top();
+		heads.pop();
+
+		SCG::WriteLE(&buffer[used], head.first.Hash, 8);
+		SCG::WriteLE(&buffer[used + 8], head.first.Game, 4);
+		SCG::WriteLE(&buffer[used + 12], head.first.Ply, 4);
+		used += PostingSize;
+
+		if (used is buffer.size()) {
+			fl.write(reinterpret_cast<const char*>(buffer.data()), used);
+			used = 0;
+		}
+
+		if (++positions[head.second] < runs[head.second].size()) {
+			heads.push(Head(runs[head.second][positions[head.second]], head.second));
+		}
+	}
+
+	fl.write(reinterpret_cast<const char*>(buffer.data()), used);
+	fl.flush();
+
+	if (not fl) {
+		FError(false, "ERROR: %s.pos could not be written!", archive.c_str());
+
+		throw 1;
+		return 0;
+	}
+
+	return total;
+}
+
+#endif
@@ -25,15 +25,202 @@ namespace SimpleChess {
 		sf::Text PlayerTurn, /**< Stores who's turn it is. */
 				 LastMove, /**< Stores the last move. */
 				 NextBtnText, /**< Text for the Next Button. */
-				 GoBackBtnText; /**< Text for the Go-Back Button. */
+				 GoBackBtnText, /**< Text for the Go-Back Button. */
+				 AnalyseBtnText, /**< Text for the Analyse Button. */
+				 AnalysisText, /**< Shows the engine's best lines. */
+				 TimelineText, /**< Shows the move number. */
+				 GameText, /**< Describes the shown game. */
+				 FoundText, /**< Shows the games found with the shown position. */
+				 ExplorerText, /**< Shows the continuations played from the shown position. */
+				 PrevGameBtnText, /**< Text for the Previous Game Button. */
+				 NextGameBtnText, /**< Text for the Next Game Button. */
+				 GameEntryText; /**< Shows the game number being typed. */
 
 		sf::RectangleShape NextButton, /**< The button that says "Next". */
-						   GoBackButton; /**< The button that says "Back". */
+						   GoBackButton, /**< The button that says "Back". */
+						   AnalyseButton, /**< The button that turns analysis on and off. */
+						   Timeline, /**< The bar for jumping to any move. */
+						   TimelineKnob, /**< Marks the shown move on Timeline. */
+						   PrevGameButton, /**< The button that opens the game before. */
+						   NextGameButton; /**< The button that opens the game after. */
 
-		File::Information FileInfo; /**< File information necessary for the replay. */
+		SCG::Game Game; /**< The game being replayed. Moves stay empty when the game is read through Log. */
+		SCG::View Log; /**< The moves of a binary game, read from the file as they are needed. */
+		SCG::Directory Games; /**< The games in "Games.sca". */
+		long GameNumber = -1; /**< The shown game in Games, or -1 for "SimpleChess.log". */
+		std::string GameEntry; /**< The game number being typed, from 1. Enter opens it. */
+		std::size_t Legal = 0; /**< The moves before the first broken one. A broken log is only shown up to there. */
+		std::size_t Chess = 0; /**< The first move that leaves the king in check, which only the window rules allow. */
+		Positions::Table Index; /**< Where each position in Games was reached. */
+		std::vector<Positions::Posting> Found; /**< The first time each game reached the searched position. */
+		std::size_t FoundNumber = 0; /**< The shown game in Found. */
+		sf::Uint64 FoundHash = 0; /**< Hash of the searched position. */
+		SCG::Index Keyframes; /**< Boards every few moves, to jump to any move quickly. */
+		const sf::Int8 NotPlayed = -1; /**< In Captured for a move whose capture is not known yet. */
+		std::vector<sf::Int8> Captured; /**< The piece each move captured, by ply, filled in as moves are played, to take them back. */
+		bool Scrubbing = false; /**< True while the mouse drags along Timeline. */
 		SimpleChess::Board8 Board; /**< The board we will be replaying. */
 		short moveNumber;
 
+		/**
+		 * The Analysis class.
+		 * Searches the shown position in the background and remembers the results.
+		 */
+		namespace Analysis {
+			const int Lines = 3, /**< How many of the best lines to show. */
+					  Depth = 12, /**< How deep each position is searched. */
+					  MoveTime = 3000; /**< Most milliseconds spent on one position. */
+
+			bool On = false; /**< True while analysis is shown. */
+			Engine::Searcher Analyser; /**< Searches the positions. */
+			std::mutex Lock; /**< Guards Cache, Current and Hash, which the search thread writes. */
+			std::map<sf::Uint64, std::vector<Engine::SearchInfo>> Cache; /**< Finished analyses by position hash. */
+			std::vector<Engine::SearchInfo> Current; /**< The lines found so far for the shown position. */
+			sf::Uint64 Hash = 0; /**< Hash of the shown position. */
+			std::atomic<bool> Cancelled(false); /**< Set when a search is stopped before it finished. */
+
+			/**
+			 * Shows the analysis of the current board, starting a search if it is not in the cache.
+			 */
+			void Start(void);
+
+			/**
+			 * Stops the running search. Its partial lines are not cached.
+			 */
+			void Stop(void);
+
+			/**
+			 * Stores a line from the search thread.
+			 * @param info The line.
+			 */
+			void OnInfo(const Engine::SearchInfo&);
+
+			/**
+			 * Caches the lines of a search that finished on its own.
+			 * @param best The best move.
+			 */
+			void OnDone(Engine::Move16);
+
+			/**
+			 * Refreshes AnalysisText.
+			 */
+			void Update(void);
+		};
+
+		/**
+		 * The Explorer class.
+		 * Lists the moves played from the shown position in the archived games, from the archive's opening tree.
+		 */
+		namespace Explorer {
+			const std::size_t Lines = 8; /**< How many continuations to show. */
+
+			bool On = false; /**< True while the explorer is shown. */
+			Openings::Table Tree; /**< The opening tree of Games. */
+			long ShownGame = -2; /**< The game ExplorerText was made for. */
+			short ShownMove = -1; /**< The move ExplorerText was made for. */
+
+			/**
+			 * Shows or hides the explorer. The opening tree is built the first time, and again once it no longer covers every game.
+			 */
+			void Toggle(void);
+
+			/**
+			 * Refreshes ExplorerText when the shown position changed.
+			 */
+			void Update(void);
+		};
+
+		/**
+		 * The Follow class.
+		 * Shows "SimpleChess.log" while a game is played in another window, adding each move as it is logged.
+		 */
+		namespace Follow {
+			bool On = false; /**< True while the log is followed. */
+			File::Follower Tail; /**< Reads the records added to the log. */
+			Board8 Last; /**< The board after the last logged move, to convert the next record. */
+			Engine::Position Checked; /**< The position after the last move that is not broken, to check the next one. */
+
+			/**
+			 * Starts or stops following the log.
+			 */
+			void Toggle(void);
+
+			/**
+			 * Starts the game over from the start position, when following starts and when the log starts a new game.
+			 */
+			void Restart(void);
+
+			/**
+			 * Adds the moves logged since the last call, and moves along with them if the last move is shown.
+			 */
+			void Update(void);
+		};
+
+		/**
+		 * Counts the moves of the game that can be shown.
+		 * @return The number of moves up to the first illegal one.
+		 */
+		std::size_t MoveCount(void);
+
+		/**
+		 * Gets a move of the game.
+		 * @param index The ply, from 0.
+		 * @return The move.
+		 */
+		Engine::Move16 MoveAt(std::size_t);
+
+		/**
+		 * Opens a game from the start.
+		 * @param index The game in Games, or -1 for "SimpleChess.log".
+		 */
+		void OpenGame(long);
+
+		/**
+		 * Opens a game of Games for the buttons and keys, and analyses it if analysis is on.
+		 * The window closes if the archive cannot be read.
+		 * @param index The game in Games. Nothing happens if there is no such game.
+		 */
+		void GoToGame(long);
+
+		/**
+		 * Adds a digit to the typed game number, takes one back, or opens the game, as the key pressed says.
+		 */
+		void TypeGameNumber(void);
+
+		/**
+		 * Jumps to a move from the nearest known board: the shown one, played forward or taken back, or a keyframe.
+		 * @param ply The number of moves played.
+		 */
+		void Seek(std::size_t);
+
+		/**
+		 * Jumps to the move under the mouse on Timeline.
+		 */
+		void SeekToMouse(void);
+
+		/**
+		 * Moves TimelineKnob and refreshes TimelineText.
+		 */
+		void UpdateTimeline(void);
+
+		/**
+		 * Replays the game up to the shown move.
+		 * @return The shown position, with its castling rights and en passant square.
+		 */
+		Engine::Position ShownPosition(void);
+
+		/**
+		 * Finds the archived games that reached the shown position and opens the next one of them.
+		 * The position index is built the first time, and again once it no longer covers every game.
+		 */
+		void FindPosition(void);
+
+		/**
+		 * Saves the shown position to "Position.fen" and the shown game to "Game.pgn".
+		 * @param game True for the game, false for the position.
+		 */
+		void Export(bool);
+
 		/**
 		 * Creates the menu and other important parts of the start page.
 		 */
@@ -62,6 +249,12 @@ namespace SimpleChess {
 		 */
 		void OnKeyPressed(void);
 
+		/**
+		 * Handler for mouse button presses.
+		 * @see OnEvent
+		 */
+		void OnMouseButtonPressed(void);
+
 		/**
 		 * Handler for mouse button releases.
 		 * @see OnEvent
@@ -77,6 +270,110 @@ namespace SimpleChess {
 
 ////////// SOURCE //////////
 
+SimpleChess::Engine::Position SimpleChess::Reader::ShownPosition(void) {
+	// The board alone does not know the castling rights or en passant square.
+	Engine::Position position;
+	Engine::Undo undo;
+	Codec::StartPosition(Game, position);
+
+	for (short ply = 0; ply < moveNumber; ply++) {
+		position.DoMove(MoveAt(ply), undo);
+	}
+
+	return position;
+}
+
+void SimpleChess::Reader::FindPosition(void) {
+	const sf::Uint64 hash = ShownPosition().Hash;
+
+	if (hash != FoundHash or Found.empty()) {
+		if (Games.Size() is 0) {
+			FoundText.setString("No archived games");
+			return;
+		}
+
+		try {
+			if (not Index.IsOpen() or Index.Games() != Games.Size()) {
+				if (not Index.Open("log/Games.sca") or Index.Games() != Games.Size()) {
+					FoundText.setString("Indexing games...");
+					Display();
+
+					Index.Close();
+					Positions::Build("log/Games.sca");
+					Index.Open("log/Games.sca");
+				}
+			}
+		} catch (int e) {
+			Index.Close();
+			FoundText.setString("Could not index the games");
+			return;
+		}
+
+		// Postings come by game, so keep the first one of each game.
+		std::vector<Positions::Posting> postings;
+		Index.Find(hash, postings);
+		Found.clear();
+		for (const auto& posting : postings) {
+			if (Found.empty() or Found.back().Game != posting.Game) {
+				Found.push_back(posting);
+			}
+		}
+
+		FoundHash = hash;
+		FoundNumber = 0;
+	} else {
+		FoundNumber = (FoundNumber + 1) % Found.size();
+	}
+
+	if (Found.empty()) {
+		FoundText.setString("Position not in the archive");
+		return;
+	}
+
+	try {
+		OpenGame(static_cast<long>(Found[FoundNumber].Game));
+		Seek(Found[FoundNumber].Ply);
+	} catch (int e) {
+		StartPage::WhoWon = -1;
+		Window.close();
+		return;
+	}
+
+	FoundText.setString("Position in " + std::to_string(Found.size()) + (Found.size() is 1 ? " game" : " games") + "\nShowing " + std::to_string(FoundNumber + 1) + " / " + std::to_string(Found.size()) + " (S for the next)");
+
+	if (Analysis::On) {
+		Analysis::Start();
+	}
+}
+
+void SimpleChess::Reader::Export(bool game) {
+	SCG::Entry entry;
+	entry.Plies = static_cast<sf::Uint32>(MoveCount());
+
+	if (GameNumber >= 0) {
+		const SCG::Entry archived = Games[GameNumber];
+		entry.Result = archived.Result;
+		entry.Date = archived.Date;
+	}
+
+	try {
+		if (game) {
+			PGN::Writer writer("log/Game.pgn");
+			PGN::WriteGame(writer, Game, entry, MoveAt);
+		} else {
+			const Engine::Position position = ShownPosition();
+			char fen[PGN::MaxFEN];
+			PGN::Writer writer("log/Position.fen");
+			writer.Put(fen, PGN::WriteFEN(position, fen));
+			writer.Put('\n');
+		}
+
+		Window.setTitle(std::string("SimpleChess - Reader (saved ") + (game ? "log/Game.pgn" : "log/Position.fen") + ")");
+	} catch (int e) {
+		Window.setTitle("SimpleChess - Reader (could not save)");
+	}
+}
+
 void SimpleChess::Reader::Initialize(void) {
 	Window.create(sf::VideoMode(900, 640), "SimpleChess - Reader", sf::Style::Close);
 	Window.setFramerateLimit(10);
@@ -112,64 +409,613 @@ void SimpleChess::Reader::Initialize(void) {
 	GoBackBtnText.setFont(Font);
 	GoBackBtnText.setString("Back");
 
+	AnalyseButton.setFillColor(sf::Color::Yellow);
+	AnalyseButton.setSize(sf::Vector2f(240.0, 50.0));
+	AnalyseButton.setPosition(650.0, 460.0);
+
+	AnalyseBtnText.setColor(sf::Color::Blue);
+	AnalyseBtnText.setCharacterSize(40);
+	AnalyseBtnText.setPosition(695.0, 460.0);
+	AnalyseBtnText.setFont(Font);
+	AnalyseBtnText.setString("Analyse");
+
+	AnalysisText.setColor(sf::Color::White);
+	AnalysisText.setCharacterSize(11);
+	AnalysisText.setPosition(650.0, 100.0);
+	AnalysisText.setFont(Font);
+	AnalysisText.setString("");
+
+	Timeline.setFillColor(sf::Color(80, 80, 80));
+	Timeline.setSize(sf::Vector2f(240.0, 16.0));
+	Timeline.setPosition(650.0, 425.0);
+
+	TimelineKnob.setFillColor(sf::Color::Yellow);
+	TimelineKnob.setSize(sf::Vector2f(6.0, 24.0));
+
+	TimelineText.setColor(sf::Color::White);
+	TimelineText.setCharacterSize(14);
+	TimelineText.setPosition(650.0, 400.0);
+	TimelineText.setFont(Font);
+
+	Scrubbing = false;
+
+	PrevGameButton.setFillColor(sf::Color::Yellow);
+	PrevGameButton.setSize(sf::Vector2f(40.0, 40.0));
+	PrevGameButton.setPosition(650.0, 20.0);
+
+	PrevGameBtnText.setColor(sf::Color::Blue);
+	PrevGameBtnText.setCharacterSize(30);
+	PrevGameBtnText.setPosition(660.0, 20.0);
+	PrevGameBtnText.setFont(Font);
+	PrevGameBtnText.setString("<");
+
+	NextGameButton.setFillColor(sf::Color::Yellow);
+	NextGameButton.setSize(sf::Vector2f(40.0, 40.0));
+	NextGameButton.setPosition(850.0, 20.0);
+
+	NextGameBtnText.setColor(sf::Color::Blue);
+	NextGameBtnText.setCharacterSize(30);
+	NextGameBtnText.setPosition(860.0, 20.0);
+	NextGameBtnText.setFont(Font);
+	NextGameBtnText.setString(">");
+
+	GameText.setColor(sf::Color::White);
+	GameText.setCharacterSize(13);
+	GameText.setPosition(697.0, 22.0);
+	GameText.setFont(Font);
+
+	GameEntry.clear();
+	GameEntryText.setColor(sf::Color::Yellow);
+	GameEntryText.setCharacterSize(13);
+	GameEntryText.setPosition(650.0, 70.0);
+	GameEntryText.setFont(Font);
+	GameEntryText.setString("");
+
+	FoundText.setColor(sf::Color::White);
+	FoundText.setCharacterSize(13);
+	FoundText.setPosition(650.0, 340.0);
+	FoundText.setFont(Font);
+	FoundText.setString("");
+
+	ExplorerText.setColor(sf::Color::White);
+	ExplorerText.setCharacterSize(11);
+	ExplorerText.setPosition(650.0, 200.0);
+	ExplorerText.setFont(Font);
+	ExplorerText.setString("");
+
+	Analysis::On = false;
+	Analysis::Analyser.OnInfo = Analysis::OnInfo;
+	Analysis::Analyser.OnDone = Analysis::OnDone;
+
+	// The last game's moves may still be on their way to the file.
+	IO::Sync();
+
 	try {
-		File::Read("log/SimpleChess.log", FileInfo);
-		File::CreateBoardFromFile("config/default.chessconf", Board);
+		// Start with the newest game. Only the directory is read, not the archive.
+		if (Games.Open("log/Games.sca") and Games.Size() > 0) {
+			OpenGame(static_cast<long>(Games.Size()) - 1);
+		} else {
+			OpenGame(-1);
+		}
 	} catch (int e) {
 		StartPage::WhoWon = -1;
 		Window.close();
 	}
 }
 
+void SimpleChess::Reader::OpenGame(long index) {
+	if (index < 0) {
+		// Binary games are mapped instead of read, so they open at once whatever their length.
+		if (SCG::IsBinary("log/SimpleChess.log")) {
+			Log.Open("log/SimpleChess.log");
+			Log.Header(Game);
+		} else {
+			Log.Close();
+			SCG::Load("log/SimpleChess.log", Game);
+		}
+
+		Legal = std::numeric_limits<std::size_t>::max();
+		Legal = Replay::FirstBroken(Game, MoveAt, MoveCount(), Chess);
+
+		// The text log changes every game, so only binary games keep their index on disk.
+		if (Log.IsOpen()) {
+			SCG::LoadIndex("log/SimpleChess.log", Game.Start, MoveCount(), MoveAt, Keyframes);
+		} else {
+			Keyframes.Build(Game.Start, MoveCount(), MoveAt);
+		}
+
+		GameText.setString("Last game\n(SimpleChess.log)");
+	} else {
+		const SCG::Entry entry = Games[index];
+		Log.Open("log/Games.sca", static_cast<std::size_t>(entry.Offset));
+		Log.Header(Game);
+		Legal = std::numeric_limits<std::size_t>::max();
+		Legal = Replay::FirstBroken(Game, MoveAt, MoveCount(), Chess);
+		Keyframes.Build(Game.Start, MoveCount(), MoveAt);
+
+		const char* results[] = { "Unfinished", "1-0", "0-1", "1/2-1/2" };
+		const std::time_t date = static_cast<std::time_t>(entry.Date);
+		char when[32] = "";
+		// Imported games without a date have 0.
+		if (date != 0) {
+			std::strftime(when, sizeof(when), "%Y-%m-%d %H:%M", std::localtime(&date));
+		}
+
+		GameText.setString("Game " + std::to_string(index + 1) + " / " + std::to_string(Games.Size()) + "  " + (entry.Result <= 3 ? results[entry.Result] : "?") + "\n" + when);
+	}
+
+	// Moves after a broken one would put pieces anywhere, so the game stops before it.
+	if (Legal < (Log.IsOpen() ? Log.Size() : Game.Moves.size())) {
+		GameText.setString(GameText.getString() + "\nBroken move " + std::to_string(Legal + 1) + ", stopped there");
+	}
+	// The windows let a king be left in check, so this is only noted.
+	if (Chess < Legal) {
+		GameText.setString(GameText.getString() + "\nMove " + std::to_string(Chess + 1) + " leaves the king in check");
+	}
+
+	GameNumber = index;
+	Board = Game.Start;
+	Captured.assign(MoveCount(), NotPlayed);
+	moveNumber = 0;
+}
+
+std::size_t SimpleChess::Reader::MoveCount(void) {
+	return std::min(Log.IsOpen() ? Log.Size() : Game.Moves.size(), Legal);
+}
+
+SimpleChess::Engine::Move16 SimpleChess::Reader::MoveAt(std::size_t index) {
+	return Log.IsOpen() ? Log[index] : Game.Moves.at(index);
+}
+
+void SimpleChess::Reader::Seek(std::size_t ply) {
+	ply = std::min(ply, MoveCount());
+	const std::size_t shown = static_cast<std::size_t>(moveNumber),
+					  keyframe = std::min<std::size_t>(ply / Keyframes.Interval, Keyframes.Keyframes.size() - 1) * Keyframes.Interval;
+
+	// Going back from the shown board needs the capture of every move on the way.
+	bool known = ply < shown;
+	for (std::size_t i = ply; known and i < shown; i++) {
+		known = Captured[i] != NotPlayed;
+	}
+
+	// Copying the keyframe counts as one move, so ties stay on the shown board and keep filling in Captured.
+	if (ply >= shown and ply - shown <= ply - keyframe + 1) {
+		for (std::size_t i = shown; i < ply; i++) {
+			Captured[i] = static_cast<sf::Int8>(SCG::Play(Board, MoveAt(i)));
+		}
+	} else if (known and shown - ply <= ply - keyframe + 1) {
+		for (std::size_t i = shown; i > ply; i--) {
+			SCG::TakeBack(Board, MoveAt(i - 1), Captured[i - 1]);
+		}
+	} else {
+		std::vector<short> captured;
+		Keyframes.Seek(ply, MoveAt, Board, captured);
+		for (std::size_t i = 0; i < captured.size(); i++) {
+			Captured[keyframe + i] = static_cast<sf::Int8>(captured[i]);
+		}
+	}
+
+	moveNumber = static_cast<short>(ply);
+}
+
+void SimpleChess::Reader::SeekToMouse(void) {
+	const float fraction = (static_cast<float>(Mouse.x) - Timeline.getPosition().x) / Timeline.getSize().x;
+	Seek(static_cast<std::size_t>(std::min(std::max(fraction, 0.0f), 1.0f) * MoveCount() + 0.5f));
+}
+
+void SimpleChess::Reader::UpdateTimeline(void) {
+	const float fraction = MoveCount() > 0 ? static_cast<float>(moveNumber) / MoveCount() : 0.0f;
+	TimelineKnob.setPosition(Timeline.getPosition().x + fraction * (Timeline.getSize().x - TimelineKnob.getSize().x), Timeline.getPosition().y - 4.0f);
+	TimelineText.setString("Move " + std::to_string(moveNumber) + " / " + std::to_string(MoveCount()));
+}
+
 void SimpleChess::Reader::OnMouseMove(void) {
 	Mouse.x = Event.mouseMove.x;
 	Mouse.y = Event.mouseMove.y;
+
+	if (Scrubbing) {
+		SeekToMouse();
+	}
+}
+
+void SimpleChess::Reader::OnMouseButtonPressed(void) {
+	if(Utils::Contains(Mouse.x, Mouse.y, Timeline.getPosition().x, Timeline.getPosition().y - 4, Timeline.getSize().x, Timeline.getSize().y + 8)) {
+		Scrubbing = true;
+		SeekToMouse();
+	}
 }
 
 void SimpleChess::Reader::OnKeyPressed(void) {
 	if(((Event.key.code is sf::Keyboard::W or Event.key.code is sf::Keyboard::C) and Event.key.control) or ((Event.key.code is sf::Keyboard::W or Event.key.code is sf::Keyboard::C) and Event.key.alt)) {
 		Window.close();
+	} else if (Event.key.code is sf::Keyboard::F) {
+		Export(false);
+	} else if (Event.key.code is sf::Keyboard::P) {
+		Export(true);
+	} else if (Event.key.code is sf::Keyboard::S) {
+		FindPosition();
+	} else if (Event.key.code is sf::Keyboard::O) {
+		Explorer::Toggle();
+	} else if (Event.key.code is sf::Keyboard::L) {
+		Follow::Toggle();
+	} else {
+		TypeGameNumber();
+	}
+}
+
+void SimpleChess::Reader::TypeGameNumber(void) {
+	const sf::Keyboard::Key key = Event.key.code;
+
+	if (key >= sf::Keyboard::Num0 and key <= sf::Keyboard::Num9) {
+		GameEntry += static_cast<char>('0' + (key - sf::Keyboard::Num0));
+	} else if (key >= sf::Keyboard::Numpad0 and key <= sf::Keyboard::Numpad9) {
+		GameEntry += static_cast<char>('0' + (key - sf::Keyboard::Numpad0));
+	} else if (key is sf::Keyboard::BackSpace and not GameEntry.empty()) {
+		GameEntry.pop_back();
+	} else if (key is sf::Keyboard::Escape) {
+		GameEntry.clear();
+	} else if (key is sf::Keyboard::Return and not GameEntry.empty()) {
+		const long number = std::atol(GameEntry.c_str());
+		GameEntry.clear();
+
+		// A number past either end opens the first or the last game.
+		GoToGame(std::min(std::max(number, 1L), static_cast<long>(Games.Size())) - 1);
+	} else {
+		return;
+	}
+
+	// More digits than any archive has games are not kept.
+	if (GameEntry.size() > 9) {
+		GameEntry.pop_back();
+	}
+
+	GameEntryText.setString(GameEntry.empty() ? "" : "Go to game " + GameEntry + " / " + std::to_string(Games.Size()) + " (Enter)");
+}
+
+void SimpleChess::Reader::GoToGame(long index) {
+	if (index < 0 or index >= static_cast<long>(Games.Size())) {
+		return;
+	}
+
+	try {
+		OpenGame(index);
+	} catch (int e) {
+		StartPage::WhoWon = -1;
+		Window.close();
+		return;
+	}
+
+	if (Analysis::On) {
+		Analysis::Start();
 	}
 }
 
 void SimpleChess::Reader::OnMouseButtonReleased(void) {
-	if(Utils::Contains(Mouse.x, Mouse.y, NextButton.getPosition().x, NextButton.getPosition().y, NextButton.getSize().x, NextButton.getSize().y)) {
-		if (moveNumber < 0) {
-			moveNumber = 0;
-			return;
-		} else if (moveNumber > FileInfo.size() - 1) {
-			moveNumber = FileInfo.size() - 1;
+	if (Scrubbing) {
+		// Analyse only where the drag stops, not every move passed on the way.
+		Scrubbing = false;
+
+		if (Analysis::On) {
+			Analysis::Start();
+		}
+	} else if(Utils::Contains(Mouse.x, Mouse.y, NextButton.getPosition().x, NextButton.getPosition().y, NextButton.getSize().x, NextButton.getSize().y)) {
+		if (moveNumber < 0 or static_cast<std::size_t>(moveNumber) >= MoveCount()) {
 			return;
 		}
 
-		Board[FileInfo.at(moveNumber).Piece2Loc.y][FileInfo.at(moveNumber).Piece2Loc.x] = FileInfo.at(moveNumber).Piece1;
-		Board[FileInfo.at(moveNumber).Piece1Loc.y][FileInfo.at(moveNumber).Piece1Loc.x] = Pieces::Empty;
-		moveNumber++;
+		Seek(moveNumber + 1);
+
+		if (Analysis::On) {
+			Analysis::Start();
+		}
 	} else if(Utils::Contains(Mouse.x, Mouse.y, GoBackButton.getPosition().x, GoBackButton.getPosition().y, GoBackButton.getSize().x, GoBackButton.getSize().y)) {
 		if (moveNumber <= 0) {
-			moveNumber = 0;
 			return;
-		} else if (moveNumber > FileInfo.size() - 1) {
-			moveNumber = FileInfo.size() - 1;
+		}
+
+		Seek(moveNumber - 1);
+
+		if (Analysis::On) {
+			Analysis::Start();
+		}
+	} else if(Utils::Contains(Mouse.x, Mouse.y, PrevGameButton.getPosition().x, PrevGameButton.getPosition().y, PrevGameButton.getSize().x, PrevGameButton.getSize().y) or Utils::Contains(Mouse.x, Mouse.y, NextGameButton.getPosition().x, NextGameButton.getPosition().y, NextGameButton.getSize().x, NextGameButton.getSize().y)) {
+		GoToGame(GameNumber + (Mouse.x >= NextGameButton.getPosition().x ? 1 : -1));
+	} else if(Utils::Contains(Mouse.x, Mouse.y, AnalyseButton.getPosition().x, AnalyseButton.getPosition().y, AnalyseButton.getSize().x, AnalyseButton.getSize().y)) {
+		Analysis::On = not Analysis::On;
+
+		if (Analysis::On) {
+			Analysis::Start();
+		} else {
+			Analysis::Stop();
+		}
+	}
+}
+
+void SimpleChess::Reader::Analysis::Start(void) {
+	Stop();
+
+	const Engine::Position position = ShownPosition();
+
+	{
+		std::lock_guard<std::mutex> lock(Lock);
+		Hash = position.Hash;
+		Current.clear();
+
+		auto cached = Cache.find(Hash);
+		if (cached != Cache.end()) {
+			Current = cached->second;
+			return;
+		}
+	}
+
+	if (position.Kings[1] < 0 or position.Kings[2] < 0) {
+		return;
+	}
+
+	Engine::SearchLimits limits;
+	limits.Depth = Depth;
+	limits.MoveTime = MoveTime;
+	limits.MultiPV = Lines;
+
+	Cancelled = false;
+	Analyser.Start(position, limits);
+}
+
+void SimpleChess::Reader::Analysis::Stop(void) {
+	if (Analyser.IsRunning()) {
+		Cancelled = true;
+	}
+
+	Analyser.Halt();
+}
+
+void SimpleChess::Reader::Analysis::OnInfo(const Engine::SearchInfo& info) {
+	std::lock_guard<std::mutex> lock(Lock);
+
+	if (info.Line is 1) {
+		Current.clear();
+	}
+
+	Current.push_back(info);
+}
+
+void SimpleChess::Reader::Analysis::OnDone(Engine::Move16 best) {
+	std::lock_guard<std::mutex> lock(Lock);
+
+	if (not Cancelled.load() and not Current.empty()) {
+		Cache[Hash] = Current;
+	}
+}
+
+void SimpleChess::Reader::Explorer::Toggle(void) {
+	On = not On;
+	ShownGame = -2;
+	ExplorerText.setString("");
+
+	if (not On) {
+		return;
+	}
+
+	if (Games.Size() is 0) {
+		On = false;
+		ExplorerText.setString("No archived games");
+		return;
+	}
+
+	try {
+		if (not Tree.IsOpen() or Tree.Games() != Games.Size()) {
+			if (not Tree.Open("log/Games.sca") or Tree.Games() != Games.Size()) {
+				ExplorerText.setString("Building the opening tree...");
+				Display();
+
+				Tree.Close();
+				Openings::Build("log/Games.sca");
+				Tree.Open("log/Games.sca");
+			}
+		}
+	} catch (int e) {
+		Tree.Close();
+		On = false;
+		ExplorerText.setString("Could not build the opening tree");
+	}
+}
+
+void SimpleChess::Reader::Explorer::Update(void) {
+	if (not On or (ShownGame is GameNumber and ShownMove is moveNumber)) {
+		return;
+	}
+	ShownGame = GameNumber;
+	ShownMove = moveNumber;
+
+	Engine::Position position;
+	Engine::Undo undo;
+	Openings::Node node;
+	Codec::StartPosition(Game, position);
+
+	if (not Tree.Root(position.Hash, node)) {
+		ExplorerText.setString("Opening tree: no game starts here");
+		return;
+	}
+
+	for (short ply = 0; ply < moveNumber; ply++) {
+		if (not Tree.Child(node, MoveAt(ply), node)) {
+			ExplorerText.setString("Opening tree: out of book");
 			return;
 		}
-		moveNumber--;
+		position.DoMove(MoveAt(ply), undo);
+	}
+
+	std::stringstream ss;
+	std::vector<Openings::Node> children;
+	Tree.Children(node, children);
+	ss << "Opening tree: " << node.Games << (node.Games is 1 ? " game" : " games") << " (W / D / L)";
+
+	for (std::size_t i = 0; i < children.size() and i < Lines; i++) {
+		char san[PGN::MaxSAN + 1];
+		san[PGN::WriteSAN(position, children[i].Move, undo, san)] = '\0';
+		position.UndoMove(undo);
+
+		const Openings::Node& child = children[i];
+		ss << "\n" << san << "  " << child.Games << "  " << child.White * 100 / child.Games << "% / " << child.Draws * 100 / child.Games << "% / " << child.Black * 100 / child.Games << "%";
+	}
+
+	if (children.size() > Lines) {
+		ss << "\n+" << children.size() - Lines << " more";
+	}
+
+	ExplorerText.setString(ss.str());
+}
+
+void SimpleChess::Reader::Follow::Toggle(void) {
+	On = not On;
+
+	if (not On) {
+		Tail.Close();
+		GameText.setString("Last game\n(SimpleChess.log)");
+		return;
+	}
+
+	// Binary games are written in one go when they end, so there is nothing to follow.
+	if (SCG::IsBinary("log/SimpleChess.log")) {
+		On = false;
+		GameText.setString("Only text logs\ncan be followed");
+		return;
+	}
+
+	Restart();
+	Tail.Open("log/SimpleChess.log");
+	Update();
+}
+
+void SimpleChess::Reader::Follow::Restart(void) {
+	Engine::Position start;
+	try {
+		File::ReadStartPosition("config/default.chessconf", start);
+	} catch (int e) {
+		start.Reset();
+	}
+
+	Log.Close();
+	SCG::FromText(File::Information(), start, Game);
+	Last = Game.Start;
+	Checked = start;
+	Legal = 0;
+	Chess = std::numeric_limits<std::size_t>::max();
+	Keyframes.Interval = SCG::DefaultInterval;
+	Keyframes.Build(Game.Start, 0, MoveAt);
+
+	GameNumber = -1;
+	Board = Game.Start;
+	Captured.clear();
+	moveNumber = 0;
+	GameText.setString("Following the live game\n(SimpleChess.log)");
+}
+
+void SimpleChess::Reader::Follow::Update(void) {
+	if (not On) {
+		return;
+	}
+
+	// Another game was opened.
+	if (GameNumber != -1 or Log.IsOpen()) {
+		On = false;
+		Tail.Close();
+		return;
+	}
+
+	File::Information inf;
+	if (not Tail.Poll(inf)) {
+		Restart();
+		Tail.Poll(inf);
+	}
+
+	if (inf.empty()) {
+		return;
+	}
+
+	const bool newest = static_cast<std::size_t>(moveNumber) is MoveCount();
+	Engine::Undo undo;
+
+	for (const File::Info& info : inf) {
+		const Engine::Move16 move = SCG::FromInfo(info, Last);
+		Game.Moves.push_back(move);
+		Captured.push_back(NotPlayed);
+
+		// Moves are only shown up to the first broken one.
+		if (Legal + 1 is Game.Moves.size()) {
+			const short rules = Replay::Play(Checked, move, undo);
+			if (rules is Replay::Rules::Windows and Chess > Legal) {
+				Chess = Legal;
+			}
+			if (rules != Replay::Rules::Broken) {
+				Legal++;
+			}
+		}
+
+		if (Game.Moves.size() % Keyframes.Interval is 0) {
+			Keyframes.Keyframes.push_back(Last);
+		}
+	}
+	Keyframes.Moves = static_cast<sf::Uint32>(Game.Moves.size());
 
-		if (FileInfo.at(moveNumber).Move == 0) {
-			Board[FileInfo.at(moveNumber).Piece2Loc.y][FileInfo.at(moveNumber).Piece2Loc.x] = Pieces::Empty;
-			Board[FileInfo.at(moveNumber).Piece1Loc.y][FileInfo.at(moveNumber).Piece1Loc.x] = FileInfo.at(moveNumber).Piece1;
+	std::string notes;
+	if (Legal < Game.Moves.size()) {
+		notes += "\nBroken move " + std::to_string(Legal + 1) + ", stopped there";
+	}
+	if (Chess < Legal) {
+		notes += "\nMove " + std::to_string(Chess + 1) + " leaves the king in check";
+	}
+	GameText.setString("Following the live game\n(SimpleChess.log)" + notes);
+
+	if (newest) {
+		Seek(MoveCount());
+
+		if (Analysis::On) {
+			Analysis::Start();
+		}
+	}
+}
+
+void SimpleChess::Reader::Analysis::Update(void) {
+	if (not On) {
+		AnalysisText.setString("");
+		return;
+	}
+
+	std::stringstream ss;
+	std::lock_guard<std::mutex> lock(Lock);
+
+	if (Current.empty()) {
+		ss << "Analysing...";
+	} else {
+		ss << "Depth " << Current.front().Depth << (Cache.count(Hash) ? " (done)" : "") << "\n";
+	}
+
+	for (const Engine::SearchInfo& info : Current) {
+		ss << "\n" << info.Line << ". ";
+
+		if (info.Score > Engine::Score::MateBound) {
+			ss << "#" << (Engine::Score::Mate - info.Score + 1) / 2;
+		} else if (info.Score < -Engine::Score::MateBound) {
+			ss << "#-" << (Engine::Score::Mate + info.Score) / 2;
 		} else {
-			Board[FileInfo.at(moveNumber).Piece2Loc.y][FileInfo.at(moveNumber).Piece2Loc.x] = FileInfo.at(moveNumber).Piece2;
-			Board[FileInfo.at(moveNumber).Piece1Loc.y][FileInfo.at(moveNumber).Piece1Loc.x] = FileInfo.at(moveNumber).Piece1;
+			ss << (info.Score >= 0 ? "+" : "-") << std::abs(info.Score) / 100 << "." << (std::abs(info.Score) % 100 < 10 ? "0" : "") << std::abs(info.Score) % 100;
+		}
+
+		for (std::size_t i = 0; i < info.PV.size() and i < 6; i++) {
+			ss << " " << Engine::MoveToString(info.PV[i]);
 		}
 	}
+
+	AnalysisText.setString(ss.str());
 }
 
 void SimpleChess::Reader::OnEvent(void) {
 	switch(Event.type) {
-		case sf::Event::Closed: Window.close();
+		case sf::Event::Closed: Window.close(); break;
 		case sf::Event::KeyPressed: OnKeyPressed(); break;
 		case sf::Event::MouseMoved: OnMouseMove(); break;
+		case sf::Event::MouseButtonPressed: OnMouseButtonPressed(); break;
 		case sf::Event::MouseButtonReleased: OnMouseButtonReleased(); break;
 		default: {}
 	}
@@ -185,8 +1031,24 @@ void SimpleChess::Reader::Main(void) {
 			OnEvent();
 		}
 
+		Follow::Update();
+		Analysis::Update();
+		Explorer::Update();
+		UpdateTimeline();
 		Display();
 	}
+
+	Analysis::Stop();
+	Analysis::On = false;
+	Explorer::On = false;
+	Explorer::ShownGame = -2;
+	Explorer::Tree.Close();
+	Follow::On = false;
+	Follow::Tail.Close();
+	Log.Close();
+	Games.Close();
+	Index.Close();
+	Found.clear();
 }
 
 void SimpleChess::Reader::Display(void) {
@@ -228,6 +1090,20 @@ void SimpleChess::Reader::Display(void) {
 	Window.draw(NextButton);
 	Window.draw(GoBackBtnText);
 	Window.draw(NextBtnText);
+	Window.draw(AnalyseButton);
+	Window.draw(AnalyseBtnText);
+	Window.draw(AnalysisText);
+	Window.draw(Timeline);
+	Window.draw(TimelineKnob);
+	Window.draw(TimelineText);
+	Window.draw(PrevGameButton);
+	Window.draw(PrevGameBtnText);
+	Window.draw(NextGameButton);
+	Window.draw(NextGameBtnText);
+	Window.draw(GameText);
+	Window.draw(GameEntryText);
+	Window.draw(FoundText);
+	Window.draw(ExplorerText);
 
 	Window.display();
 }
@@ -0,0 +1,217 @@
+/*
+ *  replay.hpp
+ *  SimpleChess
+ *
+ *  Copyright (c) 2013-2015 Ronak Gajrawala. All rights reserved.
+ */
+
+#ifndef SimpleChess_replay_hpp
+#define SimpleChess_replay_hpp
+
+namespace SimpleChess {
+	/**
+	 * The Replay class.
+	 * Replays logged games against the rules they were played by, to find the ones a broken or edited log made illegal.
+	 * The game windows follow the piece rules but let a king be left in check and captured, which ends the game, so a
+	 * move that is only illegal in standard chess is counted, not reported. A game is broken by a move no piece can
+	 * make, e.g. from an empty square or onto a piece of the same side, or by any move after a king was captured.
+	 */
+	namespace Replay {
+		const std::size_t BatchSize = 64; /**< Games each thread takes at a time. */
+
+		/**
+		 * The Rules class.
+		 * How a move fits the rules.
+		 */
+		namespace Rules {
+			static const short Broken = 0, /**< No piece can make the move, or a king was already captured. */
+							   Windows = 1, /**< The move follows the piece rules but leaves the king in check, as the windows allow. */
+							   Chess = 2; /**< The move is legal in standard chess. */
+		};
+
+		/**
+		 * A game with a broken move.
+		 */
+		class Problem {
+		public:
+			sf::Uint32 Game = 0; /**< The game in the archive. */
+			sf::Uint32 Ply = 0; /**< The first broken move, from 0. */
+			Engine::Move16 Move = Engine::NoMove; /**< That move. */
+		};
+
+		/**
+		 * What a validation found.
+		 */
+		class Stats {
+		public:
+			sf::Uint64 Games = 0, /**< Games replayed. */
+					   Moves = 0, /**< Moves replayed up to the first broken one. */
+					   Windows = 0; /**< Games with a move that only the window rules allow. */
+			std::vector<Problem> Problems; /**< The games with a broken move, in archive order. */
+		};
+
+		/**
+		 * Checks how a move fits the rules, and plays it unless it is broken.
+		 * The move is looked up from the square it lands on, so no list of every move is made.
+		 * @param position The position.
+		 * @param move The move.
+		 * @param undo Where the information to take the move back will be stored.
+		 * @return Rules::Broken (the position is then unchanged), Rules::Windows or Rules::Chess.
+		 */
+		short Play(Engine::Position&, Engine::Move16, Engine::Undo&);
+
+		/**
+		 * Finds the first broken move of a game.
+		 * @param game The game's start. A start without both kings makes the first move broken.
+		 * @param moves The game's moves.
+		 * @param plies The number of moves.
+		 * @param chess Where the first move that is not legal in standard chess will be stored, plies if there is none before the broken one.
+		 * @return The first broken move, from 0, or plies if no move is broken.
+		 */
+		std::size_t FirstBroken(const SCG::Game&, const SCG::MoveSource&, std::size_t, std::size_t&);
+
+		/**
+		 * Replays every game of an archive on several threads.
+		 * @param archive The name of the archive.
+		 * @param threads The number of threads, 0 for one per core.
+		 * @return What was found.
+		 */
+		Stats Run(std::string, int = 0);
+	};
+};
+
+////////// SOURCE //////////
+
+short SimpleChess::Replay::Play(Engine::Position& position, Engine::Move16 move, Engine::Undo& undo) {
+	const int from = Engine::FromSquare(move), to = Engine::ToSquare(move);
+	const short piece = position.At(from);
+	Engine::MoveList list;
+
+	// A captured king ends the game.
+	if (position.Kings[1] < 0 or position.Kings[2] < 0 or Engine::SideOf(piece) != position.SideToMove) {
+		return Rules::Broken;
+	}
+
+	if (Engine::FlagOf(move) is Engine::MoveFlag::Castling) {
+		position.GenerateMoves(list);
+	} else {
+		PGN::MovesTo(position, Engine::TypeOf(piece), to, list);
+	}
+
+	if (std::find(list.Moves.begin(), list.Moves.begin() + list.Size, move) is list.Moves.begin() + list.Size) {
+		return Rules::Broken;
+	}
+
+	// The move stays played even if it leaves the king in check.
+	return position.DoMove(move, undo) ? Rules::Chess : Rules::Windows;
+}
+
+std::size_t SimpleChess::Replay::FirstBroken(const SCG::Game& game, const SCG::MoveSource& moves, std::size_t plies, std::size_t& chess) {
+	Engine::Position position;
+	Engine::Undo undo;
+	Codec::StartPosition(game, position);
+	chess = plies;
+
+	for (std::size_t ply = 0; ply < plies; ply++) {
+		const short rules = Play(position, moves(ply), undo);
+
+		if (rules is Rules::Broken) {
+			return ply;
+		} else if (rules is Rules::Windows and chess is plies) {
+			chess = ply;
+		}
+	}
+
+	return plies;
+}
+
+SimpleChess::Replay::Stats SimpleChess::Replay::Run(std::string archive, int threads) {
+	SCG::Directory directory;
+	File::Mapping map;
+	Stats stats;
+
+	if (not directory.Open(archive)) {
+		FError(false, "ERROR: %s has no directory!", archive.c_str());
+
+		throw 1;
+		return stats;
+	}
+	map.Open(archive);
+
+	// Headers are read in the main thread, since the threads cannot throw.
+	std::vector<SCG::Game> starts(directory.Size());
+	std::vector<SCG::Entry> entries(directory.Size());
+	for (std::size_t i = 0; i < entries.size(); i++) {
+		entries[i] = directory[i];
+		if (entries[i].Offset + SCG::HeaderSize > map.Size()) {
+			FError(false, "ERROR: %s is cut short!", archive.c_str());
+
+			throw 2;
+			return stats;
+		}
+
+		entries[i].Plies = SCG::ReadHeader(map.Data() + entries[i].Offset, archive, starts[i]);
+		if (entries[i].Offset + SCG::HeaderSize + static_cast<sf::Uint64>(entries[i].Plies) * 2 > map.Size()) {
+			FError(false, "ERROR: %s is cut short!", archive.c_str());
+
+			throw 2;
+			return stats;
+		}
+	}
+
+	threads = threads > 0 ? threads : std::max<int>(1, std::thread::hardware_concurrency());
+	std::vector<Stats> found(static_cast<std::size_t>(threads));
+	std::atomic<std::size_t> next(0);
+
+	const auto worker = [&](std::size_t id) {
+		Stats& mine = found[id];
+
+		for (std::size_t first = next.fetch_add(BatchSize); first < entries.size(); first = next.fetch_add(BatchSize)) {
+			for (std::size_t i = first; i < std::min(first + BatchSize, entries.size()); i++) {
+				const unsigned char* moves = map.Data() + entries[i].Offset + SCG::HeaderSize;
+				const auto move = [moves](std::size_t ply) {
+					return static_cast<Engine::Move16>(SCG::ReadLE(moves + ply * 2, 2));
+				};
+
+				std::size_t chess;
+				const std::size_t legal = FirstBroken(starts[i], move, entries[i].Plies, chess);
+				mine.Games++;
+				mine.Moves += legal;
+				mine.Windows += chess < legal ? 1 : 0;
+
+				if (legal < entries[i].Plies) {
+					Problem problem;
+					problem.Game = static_cast<sf::Uint32>(i);
+					problem.Ply = static_cast<sf::Uint32>(legal);
+					problem.Move = move(legal);
+					mine.Problems.push_back(problem);
+				}
+			}
+		}
+	};
+
+	std::vector<std::thread> workers;
+	for (int t = 1; t < threads; t++) {
+		workers.emplace_back(worker, static_cast<std::size_t>(t));
+	}
+	worker(0);
+
+	for (auto& thread : workers) {
+		thread.join();
+	}
+
+	for (const auto& mine : found) {
+		stats.Games += mine.Games;
+		stats.Moves += mine.Moves;
+		stats.Windows += mine.Windows;
+		stats.Problems.insert(stats.Problems.end(), mine.Problems.begin(), mine.Problems.end());
+	}
+
+	std::sort(stats.Problems.begin(), stats.Problems.end(), [](const Problem& a, const Problem& b) {
+		return a.Game < b.Game;
+	});
+
+	return stats;
+}
+
+#endif
@@ -0,0 +1,908 @@
+/*
+ *  scg.hpp
+ *  SimpleChess
+ *
+ *  Copyright (c) 2013-2015 Ronak Gajrawala. All rights reserved.
+ */
+
+#ifndef SimpleChess_scg_hpp
+#define SimpleChess_scg_hpp
+
+namespace SimpleChess {
+	/**
+	 * The SCG class.
+	 * The binary game format (.scg). All numbers are little-endian.
+	 *
+	 *   offset  size  field
+	 *        0     4  magic "SCG" 0x1A
+	 *        4     2  version
+	 *        6     2  flags (0)
+	 *        8    64  starting board, one piece per square (y * 8 + x, Black's back rank first)
+	 *       72     1  side to move (1 or 2)
+	 *       73     1  castling rights
+	 *       74     1  en passant square or -1
+	 *       75     1  reserved (0)
+	 *       76     4  number of moves
+	 *       80   2*n  moves (Engine::Move16)
+	 *
+	 * A game can have an index next to it (<filename>.idx) holding the board every Interval moves, so any ply
+	 * can be reached by playing at most Interval - 1 moves:
+	 *
+	 *   offset  size  field
+	 *        0     4  magic "SCI" 0x1A
+	 *        4     2  version
+	 *        6     2  interval
+	 *        8     4  number of moves in the game
+	 *       12     4  number of keyframes
+	 *       16     4  CRC-32C of the moves, as they are stored in the game
+	 *       20  64*k  keyframes, laid out like the starting board
+	 *
+	 * An archive (.sca) is .scg games one after another. New games are only ever appended. Its directory
+	 * (<archive>.dir) is appended to after each game, so any game can be found without reading the archive:
+	 *
+	 *   offset  size  field
+	 *        0     4  magic "SCD" 0x1A
+	 *        4     2  version
+	 *        6     2  reserved (0)
+	 *        8  32*g  entries: offset of the game in the archive (8), its length in bytes (4), number of
+	 *                 moves (4), date in seconds since 1970 (8), result (1, as StartPage::WhoWon), reserved (7)
+	 */
+	namespace SCG {
+		const char Magic[4] = { 'S', 'C', 'G', 0x1A }; /**< The first bytes of every .scg file. */
+		const sf::Uint16 Version = 1; /**< The version this code writes and reads. */
+		const std::size_t HeaderSize = 80; /**< Bytes before the first move. */
+		const char IndexMagic[4] = { 'S', 'C', 'I', 0x1A }; /**< The first bytes of every index. */
+		const sf::Uint16 IndexVersion = 2; /**< The index version this code writes and reads. */
+		const std::size_t IndexHeaderSize = 20; /**< Bytes before the first keyframe. */
+		const sf::Uint16 DefaultInterval = 32; /**< Moves between keyframes. */
+		const char DirectoryMagic[4] = { 'S', 'C', 'D', 0x1A }; /**< The first bytes of every archive directory. */
+		const std::size_t DirectoryHeaderSize = 8; /**< Bytes before the first directory entry. */
+		const std::size_t EntrySize = 32; /**< Bytes per directory entry. */
+
+		/**
+		 * A game: where it started and the moves played.
+		 */
+		class Game {
+		public:
+			Board8 Start; /**< The starting board. */
+			short SideToMove = 1; /**< Who moves first (1 or 2). */
+			sf::Uint8 CastlingRights = 0; /**< Castling rights at the start. */
+			sf::Int8 EnPassant = -1; /**< En passant square at the start or -1. */
+			std::vector<Engine::Move16> Moves; /**< The moves. */
+		};
+
+		/**
+		 * Where to find a game in an archive.
+		 */
+		class Entry {
+		public:
+			sf::Uint64 Offset = 0; /**< Where the game starts in the archive. */
+			sf::Uint32 Length = 0; /**< The game's size in bytes. */
+			sf::Uint32 Plies = 0; /**< The number of moves. */
+			sf::Int64 Date = 0; /**< When the game was archived, in seconds since 1970. */
+			sf::Uint8 Result = 0; /**< 1 if White won, 2 if Black won, 3 for a draw, 0 if unfinished. */
+		};
+
+		/**
+		 * A read-only view of a binary game mapped into memory.
+		 * Opening costs the same for any number of moves: the moves are read straight from the mapping when asked for.
+		 */
+		class View {
+		public:
+			/**
+			 * Maps a binary game and checks its header. An open view is closed first.
+			 * @param filename The name of the file to open.
+			 * @param offset Where the game starts in the file, e.g. Entry::Offset in an archive.
+			 */
+			void Open(std::string, std::size_t = 0);
+
+			/**
+			 * Unmaps the file.
+			 */
+			void Close(void);
+
+			/**
+			 * Checks if a game is open.
+			 * @return True if a game is open.
+			 */
+			bool IsOpen(void) const;
+
+			/**
+			 * Copies where the game started. Moves are left empty.
+			 * @param game Where the start will be dumped.
+			 */
+			void Header(Game&) const;
+
+			/**
+			 * Counts the moves.
+			 * @return The number of moves.
+			 */
+			std::size_t Size(void) const;
+
+			/**
+			 * Gets a move without checking the index.
+			 * @param index The ply, from 0.
+			 * @return The move.
+			 */
+			Engine::Move16 operator[](std::size_t) const;
+
+		private:
+			File::Mapping Map; /**< The mapped file. */
+			const unsigned char* Base = nullptr; /**< The game's header in Map. */
+			std::size_t Count = 0; /**< The number of moves. */
+		};
+
+		/**
+		 * A read-only view of an archive's directory mapped into memory.
+		 */
+		class Directory {
+		public:
+			/**
+			 * Maps the directory of an archive. An open directory is closed first.
+			 * @param archive The name of the archive.
+			 * @return False if the archive has no directory yet.
+			 */
+			bool Open(std::string);
+
+			/**
+			 * Unmaps the directory.
+			 */
+			void Close(void);
+
+			/**
+			 * Counts the games.
+			 * @return The number of games.
+			 */
+			std::size_t Size(void) const;
+
+			/**
+			 * Gets a game's entry without checking the index.
+			 * @param index The game, from 0.
+			 * @return The entry.
+			 */
+			Entry operator[](std::size_t) const;
+
+		private:
+			File::Mapping Map; /**< The mapped directory. */
+			std::size_t Count = 0; /**< The number of games. */
+		};
+
+		typedef std::function<Engine::Move16(std::size_t)> MoveSource; /**< Gets the move at a ply, from a Game or a View. */
+
+		/**
+		 * Boards saved every Interval moves of a game.
+		 */
+		class Index {
+		public:
+			sf::Uint16 Interval = DefaultInterval; /**< Moves between keyframes. */
+			sf::Uint32 Moves = 0; /**< Moves in the indexed game. */
+			sf::Uint32 Checksum = 0; /**< CRC-32C of the moves, to tell the game from another one of the same length. */
+			std::vector<Board8> Keyframes; /**< Keyframes[i] is the board after i * Interval moves. */
+
+			/**
+			 * Plays through a game and saves a keyframe every Interval moves.
+			 * @param start The starting board.
+			 * @param count The number of moves.
+			 * @param moves The moves.
+			 */
+			void Build(const Board8&, std::size_t, const MoveSource&);
+
+			/**
+			 * Sets up the board after a number of moves from the nearest keyframe before it.
+			 * @param ply The number of moves played.
+			 * @param moves The moves.
+			 * @param board Where the board will be dumped.
+			 * @param captured Where the pieces captured since the keyframe will be dumped, to take them back.
+			 * @return The ply of the keyframe used.
+			 */
+			std::size_t Seek(std::size_t, const MoveSource&, Board8&, std::vector<short>&) const;
+		};
+
+		/**
+		 * Computes the checksum of a game's moves that its index is kept with.
+		 * @param count The number of moves.
+		 * @param moves The moves.
+		 * @return The CRC-32C of the moves as they are stored in a game.
+		 */
+		sf::Uint32 Checksum(std::size_t, const MoveSource&);
+
+		/**
+		 * Reads an index.
+		 * @param filename The name of the file to read from.
+		 * @param index Where the index will be dumped.
+		 * @return False if the file does not exist.
+		 */
+		bool ReadIndex(std::string, Index&);
+
+		/**
+		 * Writes an index.
+		 * @param filename The name of the file to write to.
+		 * @param index The index.
+		 */
+		void WriteIndex(std::string, const Index&);
+
+		/**
+		 * Reads the index next to a game, or builds it and tries to save it if it is missing or out of date.
+		 * @param filename The name of the game file.
+		 * @param start The starting board.
+		 * @param count The number of moves.
+		 * @param moves The moves.
+		 * @param index Where the index will be dumped.
+		 */
+		void LoadIndex(std::string, const Board8&, std::size_t, const MoveSource&, Index&);
+
+		/**
+		 * Checks if a file is in the binary format.
+		 * @param filename The name of the file.
+		 * @return True if the file starts with Magic.
+		 */
+		bool IsBinary(std::string);
+
+		/**
+		 * Reads a binary game.
+		 * @param filename The name of the file to read from.
+		 * @param game Where the game will be dumped.
+		 */
+		void Read(std::string, Game&);
+
+		/**
+		 * Writes a binary game.
+		 * @param filename The name of the file to write to.
+		 * @param game The game.
+		 */
+		void Write(std::string, const Game&);
+
+		/**
+		 * Appends a game to an archive and its directory, creating them if needed.
+		 * @param archive The name of the archive.
+		 * @param game The game.
+		 * @param result 1 if White won, 2 if Black won, 3 for a draw, 0 if unfinished.
+		 */
+		void Append(std::string, const Game&, sf::Uint8);
+
+		/**
+		 * Appends the game in "SimpleChess.log" to "Games.sca". Empty games are skipped.
+		 * @param result How the game ended, as StartPage::WhoWon.
+		 */
+		void ArchiveLog(short);
+
+		/**
+		 * Appends the game in "SimpleChess.log" to "Games.sca" as unfinished if it never got there, because SimpleChess
+		 * stopped before the game ended. A game that ended is the newest one in the archive, so only that one is compared.
+		 */
+		void ArchiveLeftoverLog(void);
+
+		/**
+		 * Reads a game in either format.
+		 * Text logs start from the position in config/default.chessconf, or the standard position if it is missing.
+		 * @param filename The name of the file to read from.
+		 * @param game Where the game will be dumped.
+		 */
+		void Load(std::string, Game&);
+
+		/**
+		 * Converts the records of a text log.
+		 * Promotions, castling and en passant are worked out by replaying the records on the board.
+		 * @param inf The records.
+		 * @param start The position the game started from.
+		 * @param game Where the game will be dumped.
+		 */
+		void FromText(const File::Information&, const Engine::Position&, Game&);
+
+		/**
+		 * Converts one record of a text log and plays it.
+		 * @param info The record.
+		 * @param board The board before the move. The move is played on it.
+		 * @return The move.
+		 */
+		Engine::Move16 FromInfo(const File::Info&, Board8&);
+
+		/**
+		 * Plays a move on a board without checking that it is legal.
+		 * @param board The board.
+		 * @param move The move.
+		 * @return The captured piece or Pieces::Empty.
+		 */
+		short Play(Board8&, Engine::Move16);
+
+		/**
+		 * Takes back a move played with Play.
+		 * @param board The board.
+		 * @param move The move.
+		 * @param captured What Play returned.
+		 */
+		void TakeBack(Board8&, Engine::Move16, short);
+	};
+};
+
+////////// SOURCE //////////
+
+namespace SimpleChess {
+	namespace SCG {
+		/**
+		 * Reads a little-endian number.
+		 * @param data The bytes.
+		 * @param size How many bytes.
+		 * @return The number.
+		 */
+		inline sf::Uint64 ReadLE(const unsigned char* data, int size) {
+			sf::Uint64 value = 0;
+			for (int i = size - 1; i >= 0; i--) {
+				value = value << 8 | data[i];
+			}
+			return value;
+		}
+
+		/**
+		 * Reads the start of a game from a header.
+		 * @param header HeaderSize bytes.
+		 * @param filename The name of the file, for errors.
+		 * @param game Where the start will be dumped.
+		 * @return The number of moves that follow.
+		 */
+		sf::Uint32 ReadHeader(const unsigned char*, const std::string&, Game&);
+
+		/**
+		 * Lays a game out in the binary format.
+		 * @param game The game.
+		 * @param data Where the bytes will be dumped.
+		 */
+		void Encode(const Game&, std::vector<unsigned char>&);
+
+		/**
+		 * Lays a directory entry out in the binary format.
+		 * @param entry The entry.
+		 * @param data Where the EntrySize bytes go.
+		 */
+		void EncodeEntry(const Entry&, unsigned char*);
+
+		/**
+		 * Opens an archive and its directory for appending, creating them if needed.
+		 * @param archive The name of the archive.
+		 * @param fl Where the archive will be opened.
+		 * @param dir Where the directory will be opened.
+		 */
+		void OpenArchive(const std::string&, std::ofstream&, std::ofstream&);
+
+		/**
+		 * Writes a little-endian number.
+		 * @param data Where the bytes go.
+		 * @param value The number.
+		 * @param size How many bytes.
+		 */
+		inline void WriteLE(unsigned char* data, sf::Uint64 value, int size) {
+			for (int i = 0; i < size; i++, value >>= 8) {
+				data[i] = static_cast<unsigned char>(value & 0xFF);
+			}
+		}
+	};
+};
+
+void SimpleChess::SCG::View::Open(std::string filename, std::size_t offset) {
+	Close();
+	Map.Open(filename);
+
+	Game start;
+	if (Map.Size() < HeaderSize or offset > Map.Size() - HeaderSize) {
+		Close();
+		FError(false, "ERROR: %s is not a version %d .scg file!", filename.c_str(), Version);
+
+		throw 2;
+		return;
+	}
+
+	try {
+		Base = Map.Data() + offset;
+		Count = ReadHeader(Base, filename, start);
+	} catch (int e) {
+		Close();
+		throw;
+	}
+
+	if (Map.Size() - offset < HeaderSize + Count * 2) {
+		Close();
+		FError(false, "ERROR: %s is cut short!", filename.c_str());
+
+		throw 2;
+		return;
+	}
+}
+
+void SimpleChess::SCG::View::Close(void) {
+	Map.Close();
+	Base = nullptr;
+	Count = 0;
+}
+
+bool SimpleChess::SCG::View::IsOpen(void) const {
+	return Map.IsOpen();
+}
+
+void SimpleChess::SCG::View::Header(Game& game) const {
+	ReadHeader(Base, "", game);
+}
+
+std::size_t SimpleChess::SCG::View::Size(void) const {
+	return Count;
+}
+
+SimpleChess::Engine::Move16 SimpleChess::SCG::View::operator[](std::size_t index) const {
+	return static_cast<Engine::Move16>(ReadLE(Base + HeaderSize + index * 2, 2));
+}
+
+bool SimpleChess::SCG::Directory::Open(std::string archive) {
+	Close();
+
+	try {
+		Map.Open(archive + ".dir");
+	} catch (int e) {
+		return false;
+	}
+
+	if (Map.Size() < DirectoryHeaderSize or memcmp(Map.Data(), DirectoryMagic, 4) != 0 or ReadLE(Map.Data() + 4, 2) != Version) {
+		Close();
+		FError(false, "ERROR: %s.dir is not a version %d archive directory!", archive.c_str(), Version);
+
+		throw 2;
+		return false;
+	}
+
+	// A game whose entry was cut short by a crash is left out.
+	Count = (Map.Size() - DirectoryHeaderSize) / EntrySize;
+	return true;
+}
+
+void SimpleChess::SCG::Directory::Close(void) {
+	Map.Close();
+	Count = 0;
+}
+
+std::size_t SimpleChess::SCG::Directory::Size(void) const {
+	return Count;
+}
+
+SimpleChess::SCG::Entry SimpleChess::SCG::Directory::operator[](std::size_t index) const {
+	const unsigned char* data = Map.Data() + DirectoryHeaderSize + index * EntrySize;
+	Entry entry;
+
+	entry.Offset = ReadLE(data, 8);
+	entry.Length = static_cast<sf::Uint32>(ReadLE(data + 8, 4));
+	entry.Plies = static_cast<sf::Uint32>(ReadLE(data + 12, 4));
+	entry.Date = static_cast<sf::Int64>(ReadLE(data + 16, 8));
+	entry.Result = data[24];
+	return entry;
+}
+
+void SimpleChess::SCG::Index::Build(const Board8& start, std::size_t count, const MoveSource& moves) {
+	Board8 board = start;
+
+	Moves = static_cast<sf::Uint32>(count);
+	Checksum = SCG::Checksum(count, moves);
+	Keyframes.clear();
+	Keyframes.reserve(count / Interval + 1);
+	Keyframes.push_back(board);
+
+	for (std::size_t ply = 0; ply < count; ply++) {
+		Play(board, moves(ply));
+
+		if ((ply + 1) % Interval is 0) {
+			Keyframes.push_back(board);
+		}
+	}
+}
+
+std::size_t SimpleChess::SCG::Index::Seek(std::size_t ply, const MoveSource& moves, Board8& board, std::vector<short>& captured) const {
+	const std::size_t keyframe = std::min(ply / Interval, Keyframes.size() - 1), base = keyframe * Interval;
+
+	board = Keyframes[keyframe];
+	captured.clear();
+
+	for (std::size_t i = base; i < ply; i++) {
+		captured.push_back(Play(board, moves(i)));
+	}
+
+	return base;
+}
+
+sf::Uint32 SimpleChess::SCG::Checksum(std::size_t count, const MoveSource& moves) {
+	unsigned char data[256];
+	sf::Uint32 crc = 0;
+
+	// A few moves at a time, so the CRC instruction gets more than two bytes.
+	for (std::size_t ply = 0; ply < count;) {
+		std::size_t size = 0;
+		for (; ply < count and size < sizeof(data); ply++, size += 2) {
+			WriteLE(data + size, moves(ply), 2);
+		}
+
+		crc = File::CRC32C(data, size, crc);
+	}
+
+	return crc;
+}
+
+bool SimpleChess::SCG::ReadIndex(std::string filename, Index& index) {
+	std::ifstream fl(File::Path + filename, std::ios::in | std::ios::binary);
+	if (not fl.is_open()) {
+		return false;
+	}
+
+	unsigned char header[IndexHeaderSize];
+	if (not fl.read(reinterpret_cast<char*>(header), IndexHeaderSize) or memcmp(header, IndexMagic, 4) != 0 or ReadLE(header + 4, 2) != IndexVersion or ReadLE(header + 6, 2) is 0) {
+		FError(false, "ERROR: %s is not a version %d index!", filename.c_str(), IndexVersion);
+
+		throw 2;
+		return false;
+	}
+
+	index.Interval = static_cast<sf::Uint16>(ReadLE(header + 6, 2));
+	index.Moves = static_cast<sf::Uint32>(ReadLE(header + 8, 4));
+	index.Checksum = static_cast<sf::Uint32>(ReadLE(header + 16, 4));
+
+	if (ReadLE(header + 12, 4) != index.Moves / index.Interval + 1) {
+		FError(false, "ERROR: %s not formatted correctly!", filename.c_str());
+
+		throw 2;
+		return false;
+	}
+
+	std::vector<unsigned char> keyframes(static_cast<std::size_t>(index.Moves / index.Interval + 1) * 64);
+	if (not fl.read(reinterpret_cast<char*>(keyframes.data()), keyframes.size())) {
+		FError(false, "ERROR: %s is cut short!", filename.c_str());
+
+		throw 2;
+		return false;
+	}
+
+	index.Keyframes.resize(keyframes.size() / 64);
+	for (std::size_t i = 0; i < keyframes.size(); i++) {
+		if (keyframes[i] > Pieces::Black_King) {
+			FError(false, "ERROR: %s not formatted correctly!", filename.c_str());
+
+			throw 2;
+			return false;
+		}
+
+		index.Keyframes[i / 64][(i & 63) >> 3][i & 7] = keyframes[i];
+	}
+
+	return true;
+}
+
+void SimpleChess::SCG::WriteIndex(std::string filename, const Index& index) {
+	std::ofstream fl(File::Path + filename, std::ios::out | std::ios::binary | std::ios::trunc);
+	if (not fl.is_open()) {
+		FError(false, "ERROR: %s could not be opened!", filename.c_str());
+
+		throw 1;
+		return;
+	}
+
+	std::vector<unsigned char> data(IndexHeaderSize + index.Keyframes.size() * 64, 0);
+
+	memcpy(data.data(), IndexMagic, 4);
+	WriteLE(&data[4], IndexVersion, 2);
+	WriteLE(&data[6], index.Interval, 2);
+	WriteLE(&data[8], index.Moves, 4);
+	WriteLE(&data[12], static_cast<sf::Uint32>(index.Keyframes.size()), 4);
+	WriteLE(&data[16], index.Checksum, 4);
+
+	for (std::size_t i = 0; i < index.Keyframes.size() * 64; i++) {
+		data[IndexHeaderSize + i] = static_cast<unsigned char>(index.Keyframes[i / 64][(i & 63) >> 3][i & 7]);
+	}
+
+	fl.write(reinterpret_cast<const char*>(data.data()), data.size());
+}
+
+void SimpleChess::SCG::LoadIndex(std::string filename, const Board8& start, std::size_t count, const MoveSource& moves, Index& index) {
+	try {
+		// The start board is the same for most games, so the moves have to match too.
+		if (ReadIndex(filename + ".idx", index) and index.Moves is count and index.Keyframes.front() is start and index.Checksum is Checksum(count, moves)) {
+			return;
+		}
+	} catch (int e) {}
+
+	index.Interval = DefaultInterval;
+	index.Build(start, count, moves);
+
+	try {
+		WriteIndex(filename + ".idx", index);
+	} catch (int e) {}
+}
+
+bool SimpleChess::SCG::IsBinary(std::string filename) {
+	std::ifstream fl(File::Path + filename, std::ios::in | std::ios::binary);
+	char magic[4];
+
+	return fl.read(magic, 4) and memcmp(magic, Magic, 4) is 0;
+}
+
+sf::Uint32 SimpleChess::SCG::ReadHeader(const unsigned char* header, const std::string& filename, Game& game) {
+	if (memcmp(header, Magic, 4) != 0 or ReadLE(header + 4, 2) != Version) {
+		FError(false, "ERROR: %s is not a version %d .scg file!", filename.c_str(), Version);
+
+		throw 2;
+		return 0;
+	}
+
+	for (int square = 0; square < 64; square++) {
+		if (header[8 + square] > Pieces::Black_King) {
+			FError(false, "ERROR: %s not formatted correctly!", filename.c_str());
+
+			throw 2;
+			return 0;
+		}
+
+		game.Start[square >> 3][square & 7] = header[8 + square];
+	}
+
+	game.SideToMove = header[72] is 2 ? 2 : 1;
+	game.CastlingRights = header[73] & Engine::Castling::All;
+	game.EnPassant = static_cast<sf::Int8>(header[74]);
+	game.Moves.clear();
+
+	return static_cast<sf::Uint32>(ReadLE(header + 76, 4));
+}
+
+void SimpleChess::SCG::Read(std::string filename, Game& game) {
+	std::ifstream fl(File::Path + filename, std::ios::in | std::ios::binary);
+	if (not fl.is_open()) {
+		FError(false, "ERROR: %s could not be opened!", filename.c_str());
+
+		throw 1;
+		return;
+	}
+
+	unsigned char header[HeaderSize];
+	if (not fl.read(reinterpret_cast<char*>(header), HeaderSize)) {
+		FError(false, "ERROR: %s is not a version %d .scg file!", filename.c_str(), Version);
+
+		throw 2;
+		return;
+	}
+
+	std::vector<unsigned char> moves(static_cast<std::size_t>(ReadHeader(header, filename, game)) * 2);
+	if (not fl.read(reinterpret_cast<char*>(moves.data()), moves.size())) {
+		FError(false, "ERROR: %s is cut short!", filename.c_str());
+
+		throw 2;
+		return;
+	}
+
+	game.Moves.resize(moves.size() / 2);
+	for (std::size_t i = 0; i < game.Moves.size(); i++) {
+		game.Moves[i] = static_cast<Engine::Move16>(ReadLE(&moves[i * 2], 2));
+	}
+}
+
+void SimpleChess::SCG::Encode(const Game& game, std::vector<unsigned char>& data) {
+	data.assign(HeaderSize + game.Moves.size() * 2, 0);
+
+	memcpy(data.data(), Magic, 4);
+	WriteLE(&data[4], Version, 2);
+
+	for (int square = 0; square < 64; square++) {
+		data[8 + square] = static_cast<unsigned char>(game.Start[square >> 3][square & 7]);
+	}
+
+	data[72] = static_cast<unsigned char>(game.SideToMove);
+	data[73] = game.CastlingRights;
+	data[74] = static_cast<unsigned char>(game.EnPassant);
+	WriteLE(&data[76], game.Moves.size(), 4);
+
+	for (std::size_t i = 0; i < game.Moves.size(); i++) {
+		WriteLE(&data[HeaderSize + i * 2], game.Moves[i], 2);
+	}
+}
+
+void SimpleChess::SCG::Write(std::string filename, const Game& game) {
+	std::ofstream fl(File::Path + filename, std::ios::out | std::ios::binary | std::ios::trunc);
+	if (not fl.is_open()) {
+		FError(false, "ERROR: %s could not be opened!", filename.c_str());
+
+		throw 1;
+		return;
+	}
+
+	std::vector<unsigned char> data;
+	Encode(game, data);
+	fl.write(reinterpret_cast<const char*>(data.data()), data.size());
+}
+
+void SimpleChess::SCG::EncodeEntry(const Entry& entry, unsigned char* data) {
+	memset(data, 0, EntrySize);
+	WriteLE(data, entry.Offset, 8);
+	WriteLE(data + 8, entry.Length, 4);
+	WriteLE(data + 12, entry.Plies, 4);
+	WriteLE(data + 16, static_cast<sf::Uint64>(entry.Date), 8);
+	data[24] = entry.Result;
+}
+
+void SimpleChess::SCG::OpenArchive(const std::string& archive, std::ofstream& fl, std::ofstream& dir) {
+	fl.open(File::Path + archive, std::ios::out | std::ios::binary | std::ios::app);
+	dir.open(File::Path + archive + ".dir", std::ios::out | std::ios::binary | std::ios::app);
+	if (not fl.is_open() or not dir.is_open()) {
+		FError(false, "ERROR: %s could not be opened!", archive.c_str());
+
+		throw 1;
+		return;
+	}
+
+	fl.seekp(0, std::ios::end);
+	dir.seekp(0, std::ios::end);
+
+	if (dir.tellp() is std::streampos(0)) {
+		unsigned char header[DirectoryHeaderSize] = { 0 };
+		memcpy(header, DirectoryMagic, 4);
+		WriteLE(header + 4, Version, 2);
+		dir.write(reinterpret_cast<const char*>(header), DirectoryHeaderSize);
+		dir.flush();
+	}
+}
+
+void SimpleChess::SCG::Append(std::string archive, const Game& game, sf::Uint8 result) {
+	std::ofstream fl, dir;
+	OpenArchive(archive, fl, dir);
+
+	Entry entry;
+	entry.Offset = static_cast<sf::Uint64>(fl.tellp());
+	entry.Plies = static_cast<sf::Uint32>(game.Moves.size());
+	entry.Date = static_cast<sf::Int64>(std::time(nullptr));
+	entry.Result = result;
+
+	std::vector<unsigned char> data;
+	Encode(game, data);
+	entry.Length = static_cast<sf::Uint32>(data.size());
+
+	// The game goes in first, so a directory entry never points past the end of the archive.
+	fl.write(reinterpret_cast<const char*>(data.data()), data.size());
+	fl.flush();
+
+	unsigned char bytes[EntrySize];
+	EncodeEntry(entry, bytes);
+	dir.write(reinterpret_cast<const char*>(bytes), EntrySize);
+}
+
+void SimpleChess::SCG::ArchiveLog(short result) {
+	Game game;
+
+	try {
+		Load("log/SimpleChess.log", game);
+
+		if (not game.Moves.empty()) {
+			Append("log/Games.sca", game, static_cast<sf::Uint8>(result > 0 ? result : 0));
+		}
+	} catch (int e) {}
+}
+
+void SimpleChess::SCG::ArchiveLeftoverLog(void) {
+	Game game, last;
+	Directory directory;
+	View view;
+
+	try {
+		Load("log/SimpleChess.log", game);
+		if (game.Moves.empty()) {
+			return;
+		}
+
+		if (directory.Open("log/Games.sca") and directory.Size() > 0) {
+			view.Open("log/Games.sca", static_cast<std::size_t>(directory[directory.Size() - 1].Offset));
+			view.Header(last);
+
+			bool same = view.Size() is game.Moves.size() and last.Start is game.Start;
+			for (std::size_t ply = 0; same and ply < view.Size(); ply++) {
+				same = view[ply] is game.Moves[ply];
+			}
+
+			if (same) {
+				return;
+			}
+		}
+
+		Append("log/Games.sca", game, 0);
+	} catch (int e) {}
+}
+
+void SimpleChess::SCG::Load(std::string filename, Game& game) {
+	if (IsBinary(filename)) {
+		Read(filename, game);
+		return;
+	}
+
+	File::Information inf;
+	Engine::Position start;
+	start.Reset();
+
+	File::Read(filename, inf);
+
+	try {
+		File::ReadStartPosition("config/default.chessconf", start);
+	} catch (int e) {
+		start.Reset();
+	}
+
+	FromText(inf, start, game);
+}
+
+void SimpleChess::SCG::FromText(const File::Information& inf, const Engine::Position& start, Game& game) {
+	game.Start = start.Board;
+	game.SideToMove = start.SideToMove;
+	game.CastlingRights = start.CastlingRights;
+	game.EnPassant = start.EnPassant;
+	game.Moves.clear();
+	game.Moves.reserve(inf.size());
+
+	Board8 board = start.Board;
+
+	for (const File::Info& info : inf) {
+		game.Moves.push_back(FromInfo(info, board));
+	}
+}
+
+SimpleChess::Engine::Move16 SimpleChess::SCG::FromInfo(const File::Info& info, Board8& board) {
+	const int from = info.Piece1Loc.y * 8 + info.Piece1Loc.x,
+			  to = info.Piece2Loc.y * 8 + info.Piece2Loc.x;
+	const short piece = board[info.Piece1Loc.y][info.Piece1Loc.x],
+				type = Engine::TypeOf(piece);
+	Engine::Move16 move = Engine::CreateMove(from, to);
+
+	if (type is Pieces::White_Pawn and Engine::TypeOf(info.Piece1) != Pieces::White_Pawn and info.Piece1 != Pieces::Empty) {
+		move = Engine::CreateMove(from, to, Engine::MoveFlag::Promotion, Engine::TypeOf(info.Piece1));
+	} else if (type is Pieces::White_Pawn and (from & 7) != (to & 7) and board[info.Piece2Loc.y][info.Piece2Loc.x] is Pieces::Empty) {
+		move = Engine::CreateMove(from, to, Engine::MoveFlag::EnPassant);
+	} else if (type is Pieces::White_King and (to - from is 2 or from - to is 2)) {
+		move = Engine::CreateMove(from, to, Engine::MoveFlag::Castling);
+	}
+
+	Play(board, move);
+	return move;
+}
+
+short SimpleChess::SCG::Play(Board8& board, Engine::Move16 move) {
+	const int from = Engine::FromSquare(move), to = Engine::ToSquare(move);
+	const sf::Uint16 flag = Engine::FlagOf(move);
+	short piece = board[from >> 3][from & 7], captured = board[to >> 3][to & 7];
+
+	if (flag is Engine::MoveFlag::Promotion) {
+		piece = Engine::PromotionOf(move, Engine::SideOf(piece));
+	} else if (flag is Engine::MoveFlag::EnPassant) {
+		captured = board[from >> 3][to & 7];
+		board[from >> 3][to & 7] = Pieces::Empty;
+	} else if (flag is Engine::MoveFlag::Castling) {
+		const int rook_from = to > from ? to + 1 : to - 2, rook_to = to > from ? to - 1 : to + 1;
+		board[rook_to >> 3][rook_to & 7] = board[rook_from >> 3][rook_from & 7];
+		board[rook_from >> 3][rook_from & 7] = Pieces::Empty;
+	}
+
+	board[to >> 3][to & 7] = piece;
+	board[from >> 3][from & 7] = Pieces::Empty;
+	return captured;
+}
+
+void SimpleChess::SCG::TakeBack(Board8& board, Engine::Move16 move, short captured) {
+	const int from = Engine::FromSquare(move), to = Engine::ToSquare(move);
+	const sf::Uint16 flag = Engine::FlagOf(move);
+	short piece = board[to >> 3][to & 7];
+
+	if (flag is Engine::MoveFlag::Promotion) {
+		piece = Engine::MakePiece(Pieces::White_Pawn, Engine::SideOf(piece));
+	}
+
+	board[from >> 3][from & 7] = piece;
+	board[to >> 3][to & 7] = Pieces::Empty;
+
+	if (flag is Engine::MoveFlag::EnPassant) {
+		board[from >> 3][to & 7] = captured;
+	} else {
+		board[to >> 3][to & 7] = captured;
+	}
+
+	if (flag is Engine::MoveFlag::Castling) {
+		const int rook_from = to > from ? to + 1 : to - 2, rook_to = to > from ? to - 1 : to + 1;
+		board[rook_from >> 3][rook_from & 7] = board[rook_to >> 3][rook_to & 7];
+		board[rook_to >> 3][rook_to & 7] = Pieces::Empty;
+	}
+}
+
+#endif
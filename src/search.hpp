@@ -0,0 +1,1023 @@
+/*
+ *  search.hpp
+ *  SimpleChess
+ *
+ *  Copyright (c) 2013-2015 Ronak Gajrawala. All rights reserved.
+ */
+
+#ifndef SimpleChess_search_hpp
+#define SimpleChess_search_hpp
+
+namespace SimpleChess {
+	namespace Engine {
+		static const int MaxPly = 128; /**< Deepest ply the search will ever reach. */
+
+		/**
+		 * Special scores, in centipawns from the side to move's point of view.
+		 */
+		namespace Score {
+			static const int Infinite = 32000, /**< Larger than any real score. */
+							 Mate = 31000, /**< Mate right now. Mate in n plies is Mate - n. */
+							 MateBound = Mate - MaxPly, /**< Scores beyond this are mates. */
+							 Draw = 0; /**< A drawn position. */
+		};
+
+		/**
+		 * Evaluates a position statically.
+		 * @param position The position.
+		 * @return The score in centipawns for the side to move.
+		 */
+		int Evaluate(const Position&);
+
+		/**
+		 * A snapshot of the search counters, summed over every thread.
+		 */
+		class SearchCounters {
+		public:
+			sf::Uint64 Nodes = 0, /**< Positions visited, including quiescence. */
+					   QNodes = 0, /**< Positions visited in the quiescence search. */
+					   BetaCutoffs = 0, /**< Moves that failed high. */
+					   FirstMoveCutoffs = 0, /**< Fail highs on the first move searched. */
+					   TTProbes = 0, /**< Transposition table lookups. */
+					   TTHits = 0, /**< Transposition table lookups that found the position. */
+					   NullMoveCutoffs = 0, /**< Null moves that failed high. */
+					   EvalCalls = 0; /**< Calls to Evaluate. */
+			int Depth = 0, /**< Deepest completed iteration. */
+				SelDepth = 0, /**< Deepest ply reached. */
+				Searches = 0; /**< How many searches were summed. */
+			sf::Int64 Milliseconds = 0; /**< Time spent searching. */
+
+			/**
+			 * Adds another snapshot to this one.
+			 * @param other The other snapshot.
+			 */
+			void Add(const SearchCounters&);
+
+			/**
+			 * Gets the nodes per second.
+			 * @return Nodes per second.
+			 */
+			sf::Uint64 NodesPerSecond(void) const;
+		};
+
+		/**
+		 * The counters of one search thread.
+		 * Only the owning thread writes them, with plain relaxed loads and stores, so counting costs no locked instructions.
+		 * Padded on both sides so that no other data shares their cache lines, whatever alignment the allocator gives.
+		 */
+		class ThreadStats {
+		public:
+			/**
+			 * Adds one to a counter. Must only be called by the owning thread.
+			 * @param counter The counter.
+			 */
+			static void Bump(std::atomic<sf::Uint64>&);
+
+			/**
+			 * Resets every counter. Must not be called while the thread searches.
+			 */
+			void Clear(void);
+
+			/**
+			 * Adds the counters to a snapshot. Safe to call from any thread.
+			 * @param counters The snapshot.
+			 */
+			void Collect(SearchCounters&) const;
+
+		private:
+			char PaddingFront[64]; /**< Keeps the counters off the previous cache line. */
+
+		public:
+			std::atomic<sf::Uint64> Nodes, /**< @see SearchCounters::Nodes */
+									QNodes, /**< @see SearchCounters::QNodes */
+									BetaCutoffs, /**< @see SearchCounters::BetaCutoffs */
+									FirstMoveCutoffs, /**< @see SearchCounters::FirstMoveCutoffs */
+									TTProbes, /**< @see SearchCounters::TTProbes */
+									TTHits, /**< @see SearchCounters::TTHits */
+									NullMoveCutoffs, /**< @see SearchCounters::NullMoveCutoffs */
+									EvalCalls; /**< @see SearchCounters::EvalCalls */
+			std::atomic<int> Depth, /**< @see SearchCounters::Depth */
+							 SelDepth; /**< @see SearchCounters::SelDepth */
+
+		private:
+			char PaddingBack[64]; /**< Keeps the counters off the next cache line. */
+		};
+
+		/**
+		 * A transposition table shared by every search thread.
+		 * Entries are written without locks; the key is stored XORed with the data so torn entries are never trusted.
+		 */
+		class TranspositionTable {
+		public:
+			static const sf::Uint8 Exact = 1, /**< The score is exact. */
+								   Lower = 2, /**< The score is a lower bound (fail high). */
+								   Upper = 3; /**< The score is an upper bound (fail low). */
+
+			/**
+			 * A decoded table entry.
+			 */
+			class Entry {
+			public:
+				Move16 Best; /**< The best move found or NoMove. */
+				int Score, /**< The score. */
+					Depth; /**< The depth it was searched to. */
+				sf::Uint8 Bound; /**< Exact, Lower or Upper. */
+			};
+
+			/**
+			 * Resizes (and clears) the table.
+			 * @param megabytes The new size.
+			 */
+			void Resize(int);
+
+			/**
+			 * Forgets every entry.
+			 */
+			void Clear(void);
+
+			/**
+			 * Looks a position up.
+			 * @param hash The position's hash.
+			 * @param entry Where the entry will be stored.
+			 * @return True if the position was found.
+			 */
+			bool Probe(sf::Uint64, Entry&) const;
+
+			/**
+			 * Stores a position.
+			 * @param hash The position's hash.
+			 * @param entry The entry.
+			 */
+			void Store(sf::Uint64, const Entry&);
+
+		private:
+			/**
+			 * One slot of the table.
+			 */
+			class Slot {
+			public:
+				std::atomic<sf::Uint64> Key, /**< The hash XORed with Data. */
+										Data; /**< Move, score, depth and bound. */
+			};
+
+			std::unique_ptr<Slot[]> Slots; /**< The slots. */
+			sf::Uint64 Mask = 0; /**< Number of slots minus one. */
+		};
+
+		/**
+		 * Limits for one search. Zero means no limit.
+		 */
+		class SearchLimits {
+		public:
+			int Depth = 0; /**< Maximum depth. */
+			sf::Int32 MoveTime = 0, /**< Time for this move in milliseconds. */
+					  WhiteTime = 0, /**< White's clock in milliseconds. */
+					  BlackTime = 0, /**< Black's clock in milliseconds. */
+					  WhiteIncrement = 0, /**< White's increment in milliseconds. */
+					  BlackIncrement = 0, /**< Black's increment in milliseconds. */
+					  MovesToGo = 0; /**< Moves until the next time control. */
+			sf::Uint64 Nodes = 0; /**< Maximum nodes. */
+			int MultiPV = 1; /**< How many of the best lines to find. */
+			bool Infinite = false; /**< Search until stopped. */
+		};
+
+		/**
+		 * Progress reported after each completed iteration.
+		 */
+		class SearchInfo {
+		public:
+			int Depth = 0, /**< The completed depth. */
+				SelDepth = 0, /**< The deepest ply reached. */
+				Score = 0, /**< The score for the side to move. */
+				Line = 1; /**< Which of the best lines this is, starting at 1. */
+			sf::Uint64 Nodes = 0; /**< Nodes searched by every thread. */
+			sf::Int64 Milliseconds = 0; /**< Time since the search started. */
+			std::vector<Move16> PV; /**< The principal variation. */
+		};
+
+		/**
+		 * Settings for the computer player.
+		 */
+		class Settings {
+		public:
+			int Threads = 1, /**< Search threads. */
+				Hash = 16, /**< Transposition table size in megabytes. */
+				Depth = 0, /**< Maximum depth or 0 for none. */
+				MoveTime = 1000; /**< Time per move in milliseconds. */
+		};
+
+		class Searcher;
+
+		/**
+		 * One search thread. Each one has its own copy of the position and its own counters.
+		 */
+		class SearchThread {
+		public:
+			Searcher* Owner; /**< The searcher this thread belongs to. */
+			int Id; /**< 0 for the main thread, helpers count up from 1. */
+			Position Pos; /**< The position being searched. */
+			ThreadStats Stats; /**< This thread's counters. */
+			Move16 Killers[MaxPly][2]; /**< Quiet moves that caused cutoffs at each ply. */
+			int History[13][64]; /**< How often a quiet piece move caused a cutoff. */
+			Move16 PV[MaxPly + 1][MaxPly + 1]; /**< Triangular principal variation table. */
+			int PVLength[MaxPly + 1]; /**< Length of each principal variation. */
+			Move16 RootBest; /**< Best root move of the last completed iteration. */
+			int RootScore; /**< Score of RootBest. */
+			std::vector<Move16> Excluded; /**< Root moves to skip while looking for the next best line. */
+			std::vector<SearchInfo> Lines; /**< The best lines of the last completed iteration, best first. */
+
+			/**
+			 * Runs iterative deepening until the limits are reached or the search is stopped.
+			 */
+			void Run(void);
+
+			/**
+			 * Searches the root position to a certain depth.
+			 * The main thread searches it once per line, each time without the root moves of the lines before.
+			 * @param depth The depth.
+			 * @return The score of the best line.
+			 */
+			int SearchRoot(int);
+
+			/**
+			 * Alpha-beta search.
+			 * @param alpha The lower bound.
+			 * @param beta The upper bound.
+			 * @param depth The remaining depth.
+			 * @param ply The distance from the root.
+			 * @param allow_null False right after a null move.
+			 * @return The score.
+			 */
+			int Search(int, int, int, int, bool);
+
+			/**
+			 * Searches captures until the position is quiet.
+			 * @param alpha The lower bound.
+			 * @param beta The upper bound.
+			 * @param ply The distance from the root.
+			 * @return The score.
+			 */
+			int Quiesce(int, int, int);
+
+			/**
+			 * Gives every move a score for ordering.
+			 * @param list The moves.
+			 * @param scores Where the scores will be stored.
+			 * @param best The move from the transposition table.
+			 * @param ply The distance from the root.
+			 */
+			void ScoreMoves(const MoveList&, std::array<int, 256>&, Move16, int) const;
+
+			/**
+			 * Moves the best scored move to position index.
+			 * @param list The moves.
+			 * @param scores The move scores.
+			 * @param index The position to fill.
+			 */
+			static void PickMove(MoveList&, std::array<int, 256>&, unsigned short);
+
+			/**
+			 * Checks if the search must stop.
+			 * @return True if the search must stop.
+			 */
+			bool ShouldStop(void);
+		};
+
+		/**
+		 * Runs searches in the background.
+		 * Start returns immediately; the result is available once IsRunning returns false.
+		 */
+		class Searcher {
+		public:
+			TranspositionTable TT; /**< The shared transposition table. */
+			std::vector<std::unique_ptr<SearchThread>> Threads; /**< The search threads. */
+			std::atomic<bool> Stop; /**< Set to stop every thread. */
+			SearchLimits Limits; /**< Limits of the current search. */
+			sf::Clock Clock; /**< Started when the search starts. */
+			sf::Int64 TimeBudget = 0; /**< Milliseconds the search may use, or 0. */
+			Move16 BestMove = NoMove; /**< The best move of the last search. */
+			int BestScore = 0; /**< The score of BestMove. */
+			sf::Int64 Elapsed = 0; /**< Milliseconds the last search took. */
+			std::function<void(const SearchInfo&)> OnInfo; /**< Called by the main thread after each iteration. */
+			std::function<void(Move16)> OnDone; /**< Called by the main thread with the best move when the search ends. */
+
+			Searcher(void);
+			~Searcher(void);
+
+			/**
+			 * Sets the number of search threads. Must not be called while searching.
+			 * @param count The number of threads.
+			 */
+			void SetThreads(int);
+
+			/**
+			 * Sets the transposition table size. Must not be called while searching.
+			 * @param megabytes The size.
+			 */
+			void SetHash(int);
+
+			/**
+			 * Starts searching a position in the background.
+			 * @param position The position.
+			 * @param limits The limits.
+			 */
+			void Start(const Position&, const SearchLimits&);
+
+			/**
+			 * Checks if a search is running.
+			 * @return True if the search has not finished yet.
+			 */
+			bool IsRunning(void) const;
+
+			/**
+			 * Stops the search and waits for it.
+			 */
+			void Halt(void);
+
+			/**
+			 * Waits for the search to finish by itself.
+			 */
+			void Wait(void);
+
+			/**
+			 * Sums the counters of every thread.
+			 * @param counters Where the sum will be stored.
+			 */
+			void Collect(SearchCounters&) const;
+
+		private:
+			std::thread Worker; /**< Runs the main search thread. */
+			std::atomic<bool> Running; /**< True while Worker searches. */
+
+			/**
+			 * Body of Worker: starts the helpers, searches and joins them.
+			 */
+			void Run(void);
+		};
+	};
+};
+
+////////// SOURCE //////////
+
+namespace SimpleChess {
+	namespace Engine {
+		static const int PieceValue[7] = { 0, 100, 500, 320, 330, 900, 0 }; /**< Indexed by white piece. */
+
+		/**
+		 * Piece-square tables from White's point of view, row 0 being the 8th rank.
+		 * Indexed by white piece.
+		 */
+		static const sf::Int8 PieceSquareTable[7][64] = {
+			{ 0 },
+			{ // Pawn
+				 0,  0,  0,  0,  0,  0,  0,  0,
+				50, 50, 50, 50, 50, 50, 50, 50,
+				10, 10, 20, 30, 30, 20, 10, 10,
+				 5,  5, 10, 25, 25, 10,  5,  5,
+				 0,  0,  0, 20, 20,  0,  0,  0,
+				 5, -5,-10,  0,  0,-10, -5,  5,
+				 5, 10, 10,-20,-20, 10, 10,  5,
+				 0,  0,  0,  0,  0,  0,  0,  0
+			},
+			{ // Rook
+				 0,  0,  0,  0,  0,  0,  0,  0,
+				 5, 10, 10, 10, 10, 10, 10,  5,
+				-5,  0,  0,  0,  0,  0,  0, -5,
+				-5,  0,  0,  0,  0,  0,  0, -5,
+				-5,  0,  0,  0,  0,  0,  0, -5,
+				-5,  0,  0,  0,  0,  0,  0, -5,
+				-5,  0,  0,  0,  0,  0,  0, -5,
+				 0,  0,  0,  5,  5,  0,  0,  0
+			},
+			{ // Knight
+				-50,-40,-30,-30,-30,-30,-40,-50,
+				-40,-20,  0,  0,  0,  0,-20,-40,
+				-30,  0, 10, 15, 15, 10,  0,-30,
+				-30,  5, 15, 20, 20, 15,  5,-30,
+				-30,  0, 15, 20, 20, 15,  0,-30,
+				-30,  5, 10, 15, 15, 10,  5,-30,
+				-40,-20,  0,  5,  5,  0,-20,-40,
+				-50,-40,-30,-30,-30,-30,-40,-50
+			},
+			{ // Bishop
+				-20,-10,-10,-10,-10,-10,-10,-20,
+				-10,  0,  0,  0,  0,  0,  0,-10,
+				-10,  0,  5, 10, 10,  5,  0,-10,
+				-10,  5,  5, 10, 10,  5,  5,-10,
+				-10,  0, 10, 10, 10, 10,  0,-10,
+				-10, 10, 10, 10, 10, 10, 10,-10,
+				-10,  5,  0,  0,  0,  0,  5,-10,
+				-20,-10,-10,-10,-10,-10,-10,-20
+			},
+			{ // Queen
+				-20,-10,-10, -5, -5,-10,-10,-20,
+				-10,  0,  0,  0,  0,  0,  0,-10,
+				-10,  0,  5,  5,  5,  5,  0,-10,
+				 -5,  0,  5,  5,  5,  5,  0, -5,
+				  0,  0,  5,  5,  5,  5,  0, -5,
+				-10,  5,  5,  5,  5,  5,  0,-10,
+				-10,  0,  5,  0,  0,  0,  0,-10,
+				-20,-10,-10, -5, -5,-10,-10,-20
+			},
+			{ // King
+				-30,-40,-40,-50,-50,-40,-40,-30,
+				-30,-40,-40,-50,-50,-40,-40,-30,
+				-30,-40,-40,-50,-50,-40,-40,-30,
+				-30,-40,-40,-50,-50,-40,-40,-30,
+				-20,-30,-30,-40,-40,-30,-30,-20,
+				-10,-20,-20,-20,-20,-20,-20,-10,
+				 20, 20,  0,  0,  0,  0, 20, 20,
+				 20, 30, 10,  0,  0, 10, 30, 20
+			}
+		};
+	};
+};
+
+int SimpleChess::Engine::Evaluate(const Position& position) {
+	int score = 0;
+
+	for (int square = 0; square < 64; square++) {
+		const short piece = position.At(square);
+		if (piece is Pieces::Empty) {
+			continue;
+		}
+
+		const short type = TypeOf(piece);
+		if (SideOf(piece) is 1) {
+			score += PieceValue[type] + PieceSquareTable[type][square];
+		} else {
+			score -= PieceValue[type] + PieceSquareTable[type][square ^ 56];
+		}
+	}
+
+	return position.SideToMove is 1 ? score : -score;
+}
+
+void SimpleChess::Engine::SearchCounters::Add(const SearchCounters& other) {
+	Nodes += other.Nodes;
+	QNodes += other.QNodes;
+	BetaCutoffs += other.BetaCutoffs;
+	FirstMoveCutoffs += other.FirstMoveCutoffs;
+	TTProbes += other.TTProbes;
+	TTHits += other.TTHits;
+	NullMoveCutoffs += other.NullMoveCutoffs;
+	EvalCalls += other.EvalCalls;
+	Depth = std::max(Depth, other.Depth);
+	SelDepth = std::max(SelDepth, other.SelDepth);
+	Searches += other.Searches;
+	Milliseconds += other.Milliseconds;
+}
+
+sf::Uint64 SimpleChess::Engine::SearchCounters::NodesPerSecond(void) const {
+	return Milliseconds > 0 ? Nodes * 1000 / Milliseconds : 0;
+}
+
+void SimpleChess::Engine::ThreadStats::Bump(std::atomic<sf::Uint64>& counter) {
+	counter.store(counter.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+}
+
+void SimpleChess::Engine::ThreadStats::Clear(void) {
+	Nodes = QNodes = BetaCutoffs = FirstMoveCutoffs = TTProbes = TTHits = NullMoveCutoffs = EvalCalls = 0;
+	Depth = SelDepth = 0;
+}
+
+void SimpleChess::Engine::ThreadStats::Collect(SearchCounters& counters) const {
+	counters.Nodes += Nodes.load(std::memory_order_relaxed);
+	counters.QNodes += QNodes.load(std::memory_order_relaxed);
+	counters.BetaCutoffs += BetaCutoffs.load(std::memory_order_relaxed);
+	counters.FirstMoveCutoffs += FirstMoveCutoffs.load(std::memory_order_relaxed);
+	counters.TTProbes += TTProbes.load(std::memory_order_relaxed);
+	counters.TTHits += TTHits.load(std::memory_order_relaxed);
+	counters.NullMoveCutoffs += NullMoveCutoffs.load(std::memory_order_relaxed);
+	counters.EvalCalls += EvalCalls.load(std::memory_order_relaxed);
+	counters.Depth = std::max(counters.Depth, Depth.load(std::memory_order_relaxed));
+	counters.SelDepth = std::max(counters.SelDepth, SelDepth.load(std::memory_order_relaxed));
+}
+
+void SimpleChess::Engine::TranspositionTable::Resize(int megabytes) {
+	sf::Uint64 count = 1;
+	while (count * 2 * sizeof(Slot) <= static_cast<sf::Uint64>(std::max(megabytes, 1)) * 1024 * 1024) {
+		count *= 2;
+	}
+
+	Slots.reset(new Slot[count]);
+	Mask = count - 1;
+	Clear();
+}
+
+void SimpleChess::Engine::TranspositionTable::Clear(void) {
+	for (sf::Uint64 i = 0; i <= Mask and Slots; i++) {
+		Slots[i].Key.store(0, std::memory_order_relaxed);
+		Slots[i].Data.store(0, std::memory_order_relaxed);
+	}
+}
+
+bool SimpleChess::Engine::TranspositionTable::Probe(sf::Uint64 hash, Entry& entry) const {
+	const Slot& slot = Slots[hash & Mask];
+	const sf::Uint64 data = slot.Data.load(std::memory_order_relaxed);
+
+	if ((slot.Key.load(std::memory_order_relaxed) ^ data) != hash or data is 0) {
+		return false;
+	}
+
+	entry.Best = static_cast<Move16>(data & 0xFFFF);
+	entry.Score = static_cast<sf::Int16>((data >> 16) & 0xFFFF);
+	entry.Depth = static_cast<int>((data >> 32) & 0xFF);
+	entry.Bound = static_cast<sf::Uint8>((data >> 40) & 3);
+	return true;
+}
+
+void SimpleChess::Engine::TranspositionTable::Store(sf::Uint64 hash, const Entry& entry) {
+	Slot& slot = Slots[hash & Mask];
+	const sf::Uint64 data = static_cast<sf::Uint64>(entry.Best)
+						  | static_cast<sf::Uint64>(static_cast<sf::Uint16>(entry.Score)) << 16
+						  | static_cast<sf::Uint64>(std::max(entry.Depth, 0) & 0xFF) << 32
+						  | static_cast<sf::Uint64>(entry.Bound) << 40;
+
+	slot.Key.store(hash ^ data, std::memory_order_relaxed);
+	slot.Data.store(data, std::memory_order_relaxed);
+}
+
+bool SimpleChess::Engine::SearchThread::ShouldStop(void) {
+	if (Owner->Stop.load(std::memory_order_relaxed)) {
+		return true;
+	}
+
+	// Only the main thread looks at the clock, about every millisecond.
+	if (Id is 0 and (Stats.Nodes.load(std::memory_order_relaxed) & 1023) is 0) {
+		const SearchLimits& limits = Owner->Limits;
+
+		if ((Owner->TimeBudget > 0 and Owner->Clock.getElapsedTime().asMilliseconds() >= Owner->TimeBudget) or (limits.Nodes > 0 and Stats.Nodes.load(std::memory_order_relaxed) >= limits.Nodes)) {
+			Owner->Stop = true;
+			return true;
+		}
+	}
+
+	return false;
+}
+
+void SimpleChess::Engine::SearchThread::ScoreMoves(const MoveList& list, std::array<int, 256>& scores, Move16 best, int ply) const {
+	for (unsigned short i = 0; i < list.Size; i++) {
+		const Move16 move = list.Moves[i];
+		const short victim = Pos.At(ToSquare(move)), attacker = Pos.At(FromSquare(move));
+
+		if (move is best) {
+			scores[i] = 1 << 30;
+		} else if (victim != Pieces::Empty or FlagOf(move) is MoveFlag::EnPassant) {
+			// Most valuable victim, least valuable attacker.
+			scores[i] = (1 << 28) + PieceValue[TypeOf(victim)] * 16 - PieceValue[TypeOf(attacker)] / 16;
+		} else if (FlagOf(move) is MoveFlag::Promotion) {
+			scores[i] = (1 << 27) + PieceValue[TypeOf(PromotionOf(move, 1))];
+		} else if (move is Killers[ply][0]) {
+			scores[i] = (1 << 26) + 1;
+		} else if (move is Killers[ply][1]) {
+			scores[i] = 1 << 26;
+		} else {
+			scores[i] = History[attacker][ToSquare(move)];
+		}
+	}
+}
+
+void SimpleChess::Engine::SearchThread::PickMove(MoveList& list, std::array<int, 256>& scores, unsigned short index) {
+	unsigned short best = index;
+
+	for (unsigned short i = index + 1; i < list.Size; i++) {
+		if (scores[i] > scores[best]) {
+			best = i;
+		}
+	}
+
+	std::swap(list.Moves[index], list.Moves[best]);
+	std::swap(scores[index], scores[best]);
+}
+
+int SimpleChess::Engine::SearchThread::Quiesce(int alpha, int beta, int ply) {
+	ThreadStats::Bump(Stats.Nodes);
+	ThreadStats::Bump(Stats.QNodes);
+
+	if (ply > Stats.SelDepth.load(std::memory_order_relaxed)) {
+		Stats.SelDepth.store(ply, std::memory_order_relaxed);
+	}
+
+	if (ShouldStop()) {
+		return 0;
+	}
+
+	ThreadStats::Bump(Stats.EvalCalls);
+	const int stand_pat = Evaluate(Pos);
+
+	if (stand_pat >= beta or ply >= MaxPly) {
+		return stand_pat;
+	}
+
+	alpha = std::max(alpha, stand_pat);
+
+	MoveList list;
+	std::array<int, 256> scores;
+	Pos.GenerateMoves(list, true);
+	ScoreMoves(list, scores, NoMove, ply);
+
+	for (unsigned short i = 0; i < list.Size; i++) {
+		PickMove(list, scores, i);
+
+		Undo undo;
+		if (not Pos.DoMove(list.Moves[i], undo)) {
+			Pos.UndoMove(undo);
+			continue;
+		}
+
+		const int score = -Quiesce(-beta, -alpha, ply + 1);
+		Pos.UndoMove(undo);
+
+		if (score >= beta) {
+			ThreadStats::Bump(Stats.BetaCutoffs);
+			return score;
+		}
+
+		alpha = std::max(alpha, score);
+	}
+
+	return alpha;
+}
+
+int SimpleChess::Engine::SearchThread::Search(int alpha, int beta, int depth, int ply, bool allow_null) {
+	PVLength[ply] = ply;
+
+	if (Pos.Kings[Pos.SideToMove] < 0) {
+		return -Score::Mate + ply;
+	}
+
+	const bool in_check = Pos.InCheck();
+	if (in_check) {
+		depth++;
+	}
+
+	// One repetition is enough: whatever was best the first time can be played again.
+	if (ply > 0 and (Pos.IsRepetition(1) or Pos.IsFiftyMoves())) {
+		return Score::Draw;
+	}
+
+	if (depth <= 0 or ply >= MaxPly) {
+		return Quiesce(alpha, beta, ply);
+	}
+
+	ThreadStats::Bump(Stats.Nodes);
+
+	if (ShouldStop()) {
+		return 0;
+	}
+
+	const bool pv_node = beta - alpha > 1;
+	TranspositionTable::Entry entry;
+	Move16 tt_move = NoMove;
+
+	ThreadStats::Bump(Stats.TTProbes);
+	if (Owner->TT.Probe(Pos.Hash, entry)) {
+		ThreadStats::Bump(Stats.TTHits);
+		tt_move = entry.Best;
+
+		int score = entry.Score;
+		if (score > Score::MateBound) {
+			score -= ply;
+		} else if (score < -Score::MateBound) {
+			score += ply;
+		}
+
+		if (not pv_node and entry.Depth >= depth and ((entry.Bound is TranspositionTable::Exact) or (entry.Bound is TranspositionTable::Lower and score >= beta) or (entry.Bound is TranspositionTable::Upper and score <= alpha))) {
+			return score;
+		}
+	}
+
+	// Null move: if passing still fails high, a real move almost surely will.
+	if (allow_null and not pv_node and not in_check and depth >= 3 and beta < Score::MateBound) {
+		bool has_pieces = false;
+		for (int square = 0; square < 64 and not has_pieces; square++) {
+			const short type = TypeOf(Pos.At(square));
+			has_pieces = SideOf(Pos.At(square)) is Pos.SideToMove and type != Pieces::White_Pawn and type != Pieces::White_King;
+		}
+
+		if (has_pieces) {
+			Undo undo;
+			Pos.DoNullMove(undo);
+			const int score = -Search(-beta, -beta + 1, depth - 3 - depth / 4, ply + 1, false);
+			Pos.UndoNullMove(undo);
+
+			if (Owner->Stop.load(std::memory_order_relaxed)) {
+				return 0;
+			}
+
+			if (score >= beta) {
+				ThreadStats::Bump(Stats.NullMoveCutoffs);
+				return beta;
+			}
+		}
+	}
+
+	MoveList list;
+	std::array<int, 256> scores;
+	Pos.GenerateMoves(list);
+	ScoreMoves(list, scores, tt_move, ply);
+
+	const int original_alpha = alpha;
+	int best_score = -Score::Infinite, legal = 0;
+	Move16 best_move = NoMove;
+
+	for (unsigned short i = 0; i < list.Size; i++) {
+		PickMove(list, scores, i);
+		const Move16 move = list.Moves[i];
+		const bool quiet = Pos.At(ToSquare(move)) is Pieces::Empty and FlagOf(move) != MoveFlag::EnPassant and FlagOf(move) != MoveFlag::Promotion;
+
+		if (ply is 0 and std::find(Excluded.begin(), Excluded.end(), move) != Excluded.end()) {
+			continue;
+		}
+
+		Undo undo;
+		if (not Pos.DoMove(move, undo)) {
+			Pos.UndoMove(undo);
+			continue;
+		}
+		legal++;
+
+		int score;
+		if (legal is 1) {
+			score = -Search(-beta, -alpha, depth - 1, ply + 1, true);
+		} else {
+			score = -Search(-alpha - 1, -alpha, depth - 1, ply + 1, true);
+			if (score > alpha and score < beta) {
+				score = -Search(-beta, -alpha, depth - 1, ply + 1, true);
+			}
+		}
+
+		Pos.UndoMove(undo);
+
+		if (Owner->Stop.load(std::memory_order_relaxed)) {
+			return 0;
+		}
+
+		if (score > best_score) {
+			best_score = score;
+			best_move = move;
+
+			if (score > alpha) {
+				alpha = score;
+
+				PV[ply][ply] = move;
+				for (int next = ply + 1; next < PVLength[ply + 1]; next++) {
+					PV[ply][next] = PV[ply + 1][next];
+				}
+				PVLength[ply] = std::max(PVLength[ply + 1], ply + 1);
+			}
+		}
+
+		if (alpha >= beta) {
+			ThreadStats::Bump(Stats.BetaCutoffs);
+			if (legal is 1) {
+				ThreadStats::Bump(Stats.FirstMoveCutoffs);
+			}
+
+			if (quiet) {
+				if (Killers[ply][0] != move) {
+					Killers[ply][1] = Killers[ply][0];
+					Killers[ply][0] = move;
+				}
+
+				int& history = History[Pos.At(FromSquare(move))][ToSquare(move)];
+				history = std::min(history + depth * depth, 1 << 25);
+			}
+			break;
+		}
+	}
+
+	if (legal is 0) {
+		return in_check ? -Score::Mate + ply : Score::Draw;
+	}
+
+	// The best of the remaining root moves is not the best move of the position.
+	if (ply is 0 and not Excluded.empty()) {
+		return best_score;
+	}
+
+	TranspositionTable::Entry store;
+	store.Best = best_move;
+	store.Score = best_score > Score::MateBound ? best_score + ply : (best_score < -Score::MateBound ? best_score - ply : best_score);
+	store.Depth = depth;
+	store.Bound = best_score >= beta ? TranspositionTable::Lower : (best_score > original_alpha ? TranspositionTable::Exact : TranspositionTable::Upper);
+	Owner->TT.Store(Pos.Hash, store);
+
+	return best_score;
+}
+
+int SimpleChess::Engine::SearchThread::SearchRoot(int depth) {
+	const int count = Id is 0 ? std::max(Owner->Limits.MultiPV, 1) : 1;
+	std::vector<SearchInfo> lines;
+	int best = 0;
+
+	Excluded.clear();
+
+	for (int line = 0; line < count; line++) {
+		const int score = Search(-Score::Infinite, Score::Infinite, depth, 0, false);
+
+		// Stopped, or every root move already has a line.
+		if (Owner->Stop.load(std::memory_order_relaxed) or PVLength[0] is 0) {
+			break;
+		}
+
+		if (line is 0) {
+			RootBest = PV[0][0];
+			RootScore = best = score;
+		}
+
+		lines.emplace_back();
+		lines.back().Line = line + 1;
+		lines.back().Score = score;
+		lines.back().PV.assign(PV[0], PV[0] + PVLength[0]);
+		Excluded.push_back(PV[0][0]);
+	}
+
+	Excluded.clear();
+
+	if (not Owner->Stop.load(std::memory_order_relaxed)) {
+		Lines.swap(lines);
+	}
+
+	return best;
+}
+
+void SimpleChess::Engine::SearchThread::Run(void) {
+	const int max_depth = Owner->Limits.Depth > 0 ? std::min(Owner->Limits.Depth, MaxPly - 1) : MaxPly - 1;
+
+	for (short ply = 0; ply < MaxPly; ply++) {
+		Killers[ply][0] = Killers[ply][1] = NoMove;
+	}
+
+	for (short piece = 0; piece < 13; piece++) {
+		for (short square = 0; square < 64; square++) {
+			History[piece][square] = 0;
+		}
+	}
+
+	// Helpers start at different depths so they fill the table with different lines.
+	for (int depth = 1 + Id % 2; depth <= max_depth; depth++) {
+		SearchRoot(depth);
+
+		if (Owner->Stop.load(std::memory_order_relaxed)) {
+			break;
+		}
+
+		Stats.Depth.store(depth, std::memory_order_relaxed);
+
+		if (Id is 0) {
+			if (Owner->OnInfo) {
+				SearchCounters counters;
+				Owner->Collect(counters);
+
+				for (SearchInfo& info : Lines) {
+					info.Depth = depth;
+					info.SelDepth = counters.SelDepth;
+					info.Nodes = counters.Nodes;
+					info.Milliseconds = Owner->Clock.getElapsedTime().asMilliseconds();
+					Owner->OnInfo(info);
+				}
+			}
+
+			// A found mate will not get any better.
+			if (RootScore > Score::MateBound or RootScore < -Score::MateBound) {
+				if (not Owner->Limits.Infinite) {
+					break;
+				}
+			}
+
+			// Another iteration would most likely not finish in time.
+			if (Owner->TimeBudget > 0 and Owner->Clock.getElapsedTime().asMilliseconds() * 2 > Owner->TimeBudget) {
+				break;
+			}
+		}
+	}
+}
+
+SimpleChess::Engine::Searcher::Searcher(void) : Stop(false), Running(false) {
+	TT.Resize(16);
+	SetThreads(1);
+}
+
+SimpleChess::Engine::Searcher::~Searcher(void) {
+	Halt();
+}
+
+void SimpleChess::Engine::Searcher::SetThreads(int count) {
+	Halt();
+	Threads.clear();
+
+	for (int id = 0; id < std::max(count, 1); id++) {
+		Threads.emplace_back(new SearchThread);
+		Threads.back()->Owner = this;
+		Threads.back()->Id = id;
+		Threads.back()->Stats.Clear();
+	}
+}
+
+void SimpleChess::Engine::Searcher::SetHash(int megabytes) {
+	Halt();
+	TT.Resize(megabytes);
+}
+
+void SimpleChess::Engine::Searcher::Start(const Position& position, const SearchLimits& limits) {
+	Halt();
+
+	Limits = limits;
+	Stop = false;
+	BestMove = NoMove;
+	BestScore = 0;
+	Elapsed = 0;
+	TimeBudget = 0;
+
+	if (not limits.Infinite) {
+		const sf::Int32 time = position.SideToMove is 1 ? limits.WhiteTime : limits.BlackTime,
+						increment = position.SideToMove is 1 ? limits.WhiteIncrement : limits.BlackIncrement;
+
+		if (limits.MoveTime > 0) {
+			TimeBudget = limits.MoveTime;
+		} else if (time > 0) {
+			TimeBudget = std::max<sf::Int64>(1, std::min<sf::Int64>(time / (limits.MovesToGo > 0 ? limits.MovesToGo : 30) + increment * 3 / 4, time - 50));
+		}
+	}
+
+	for (auto& thread : Threads) {
+		thread->Pos = position;
+		thread->Pos.HashHistory.reserve(position.HashHistory.size() + MaxPly);
+		thread->Stats.Clear();
+		thread->RootBest = NoMove;
+		thread->RootScore = 0;
+		thread->PVLength[0] = 0;
+		thread->Lines.clear();
+	}
+
+	Clock.restart();
+	Running = true;
+	Worker = std::thread(&Searcher::Run, this);
+}
+
+void SimpleChess::Engine::Searcher::Run(void) {
+	std::vector<std::thread> helpers;
+	for (std::size_t id = 1; id < Threads.size(); id++) {
+		helpers.emplace_back(&SearchThread::Run, Threads[id].get());
+	}
+
+	SearchThread& main = *Threads[0];
+	main.Run();
+
+	// An infinite search only answers once it is told to stop.
+	while (Limits.Infinite and not Stop.load()) {
+		sf::sleep(sf::microseconds(100));
+	}
+
+	// Even a stopped search must answer with a legal move.
+	if (main.RootBest is NoMove) {
+		MoveList list;
+		main.Pos.GenerateLegalMoves(list);
+		if (list.Size > 0) {
+			main.RootBest = list.Moves[0];
+		}
+	}
+
+	Stop = true;
+	for (auto& helper : helpers) {
+		helper.join();
+	}
+
+	BestMove = main.RootBest;
+	BestScore = main.RootScore;
+	Elapsed = Clock.getElapsedTime().asMilliseconds();
+
+	if (OnDone) {
+		OnDone(BestMove);
+	}
+
+	Running = false;
+}
+
+bool SimpleChess::Engine::Searcher::IsRunning(void) const {
+	return Running.load();
+}
+
+void SimpleChess::Engine::Searcher::Halt(void) {
+	Stop = true;
+	Wait();
+}
+
+void SimpleChess::Engine::Searcher::Wait(void) {
+	if (Worker.joinable()) {
+		Worker.join();
+	}
+}
+
+void SimpleChess::Engine::Searcher::Collect(SearchCounters& counters) const {
+	for (const auto& thread : Threads) {
+		thread->Stats.Collect(counters);
+	}
+
+	counters.Searches++;
+	counters.Milliseconds += Running.load() ? Clock.getElapsedTime().asMilliseconds() : Elapsed;
+}
+
+#endif
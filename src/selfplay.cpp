@@ -0,0 +1,18 @@
+/*
+ *  selfplay.cpp
+ *  SimpleChess
+ *
+ *  Copyright (c) 2013-2015 Ronak Gajrawala. All rights reserved.
+ */
+
+/*
+ * Headless engine against engine matches. See config/selfplay.chessconf.
+ */
+
+#include "core.hpp"
+#include "selfplay.hpp"
+
+ChessMain
+	SimpleChess::Engine::Zobrist::Initialize();
+	SimpleChess::SelfPlay::Main();
+ChessEnd
@@ -0,0 +1,297 @@
+/*
+ *  selfplay.hpp
+ *  SimpleChess
+ *
+ *  Copyright (c) 2013-2015 Ronak Gajrawala. All rights reserved.
+ */
+
+#ifndef SimpleChess_selfplay_hpp
+#define SimpleChess_selfplay_hpp
+
+namespace SimpleChess {
+	/**
+	 * The SelfPlay class.
+	 * Plays many engine against engine games at once to compare two engine settings.
+	 */
+	namespace SelfPlay {
+		/**
+		 * Settings for a match.
+		 */
+		class Settings {
+		public:
+			int Games = 100, /**< Games to play. Openings are played twice, once with each color. */
+				Concurrency = 0, /**< Games played at once or 0 for one per core. */
+				OpeningPlies = 6, /**< Random plies played before the engines take over. */
+				MaxPlies = 400, /**< Games longer than this are drawn. */
+				Seed = 1, /**< Seed for the random openings. */
+				SaveGames = 1; /**< 1 to append every game with its result to log/SelfPlay.sca. */
+			Engine::Settings First, /**< The engine being tested. */
+							 Second; /**< The engine it plays against. */
+		};
+
+		/**
+		 * How a game ended.
+		 */
+		class Outcome {
+		public:
+			int Result = 0; /**< 1 if White won, -1 if Black won, 0 for a draw. */
+			const char* Reason = ""; /**< Why the game ended. */
+			int Plies = 0; /**< Plies played. */
+		};
+
+		Settings Match; /**< The match settings. */
+		std::atomic<int> NextGame(0); /**< The next game to hand out. */
+		std::atomic<int> Wins(0), /**< Games won by the first engine. */
+						 Draws(0), /**< Drawn games. */
+						 Losses(0); /**< Games lost by the first engine. */
+		std::mutex OutputLock, /**< Keeps progress lines from different games apart. */
+				   ArchiveLock; /**< Lets one game at a time be appended to the archive. */
+		sf::Clock Clock; /**< Started when the match starts. */
+
+		/**
+		 * Main function. Reads config/selfplay.chessconf, plays the match and prints the result.
+		 */
+		void Main(void);
+
+		/**
+		 * Reads the match settings.
+		 * Each line is a setting name followed by its value, e.g. "Games 200". Engine settings start with
+		 * "First" or "Second", e.g. "SecondMoveTime 50".
+		 * @param filename The name of the file to read from.
+		 * @param settings Where the settings will be dumped.
+		 * @return False if the file does not exist (the defaults are used).
+		 */
+		bool ReadSettings(std::string, Settings&);
+
+		/**
+		 * Plays games from NextGame until every game has been handed out.
+		 * Each worker keeps its own pair of engines.
+		 */
+		void Worker(void);
+
+		/**
+		 * Plays one game. Games 2n and 2n + 1 share an opening with the colors swapped.
+		 * @param index The game number.
+		 * @param first The first engine.
+		 * @param second The second engine.
+		 * @return How the game ended.
+		 */
+		Outcome PlayGame(int, Engine::Searcher&, Engine::Searcher&);
+
+		/**
+		 * Works out the Elo difference from the first engine's score.
+		 * @param wins Games won.
+		 * @param draws Games drawn.
+		 * @param losses Games lost.
+		 * @param elo Where the Elo difference will be stored.
+		 * @param margin Where the 95% error bar will be stored.
+		 */
+		void Elo(int, int, int, double&, double&);
+	};
+};
+
+////////// SOURCE //////////
+
+bool SimpleChess::SelfPlay::ReadSettings(std::string filename, Settings& settings) {
+	std::ifstream fl(File::Path + filename, std::ios::in);
+	if (not fl.is_open()) {
+		return false;
+	}
+
+	std::string name;
+	int value;
+
+	while (fl >> name) {
+		if (not (fl >> value)) {
+			FError(false, "ERROR: %s not formatted correctly!", filename.c_str());
+
+			throw 2;
+			return false;
+		}
+
+		Engine::Settings* engine = nullptr;
+		if (name.compare(0, 5, "First") is 0) {
+			engine = &settings.First;
+			name.erase(0, 5);
+		} else if (name.compare(0, 6, "Second") is 0) {
+			engine = &settings.Second;
+			name.erase(0, 6);
+		}
+
+		if (engine) {
+			if (name is "Threads") {
+				engine->Threads = value;
+			} else if (name is "Hash") {
+				engine->Hash = value;
+			} else if (name is "Depth") {
+				engine->Depth = value;
+			} else if (name is "MoveTime") {
+				engine->MoveTime = value;
+			}
+		} else if (name is "Games") {
+			settings.Games = value;
+		} else if (name is "Concurrency") {
+			settings.Concurrency = value;
+		} else if (name is "OpeningPlies") {
+			settings.OpeningPlies = value;
+		} else if (name is "MaxPlies") {
+			settings.MaxPlies = value;
+		} else if (name is "Seed") {
+			settings.Seed = value;
+		} else if (name is "SaveGames") {
+			settings.SaveGames = value;
+		}
+	}
+
+	return true;
+}
+
+SimpleChess::SelfPlay::Outcome SimpleChess::SelfPlay::PlayGame(int index, Engine::Searcher& first, Engine::Searcher& second) {
+	Outcome outcome;
+	Engine::Position position;
+	Engine::MoveList list;
+	Engine::Undo undo;
+	SCG::Game record;
+
+	// Both games of a pair get the same opening.
+	std::mt19937_64 random(static_cast<sf::Uint64>(Match.Seed) * 0x9E3779B97F4A7C15ULL + static_cast<sf::Uint64>(index / 2));
+	const bool first_is_white = index % 2 is 0;
+
+	position.Reset();
+	record.Start = position.Board;
+	record.CastlingRights = position.CastlingRights;
+	first.TT.Clear();
+	second.TT.Clear();
+
+	while (true) {
+		position.GenerateLegalMoves(list);
+		if (list.Size is 0) {
+			outcome.Result = position.InCheck() ? (position.SideToMove is 1 ? -1 : 1) : 0;
+			outcome.Reason = position.InCheck() ? "checkmate" : "stalemate";
+			break;
+		}
+
+		if (position.IsFiftyMoves()) {
+			outcome.Reason = "fifty moves";
+			break;
+		}
+
+		if (position.IsRepetition(2)) {
+			outcome.Reason = "repetition";
+			break;
+		}
+
+		if (outcome.Plies >= Match.MaxPlies) {
+			outcome.Reason = "move limit";
+			break;
+		}
+
+		Engine::Move16 move;
+		if (outcome.Plies < Match.OpeningPlies) {
+			move = list.Moves[random() % list.Size];
+		} else {
+			Engine::Searcher& engine = (position.SideToMove is 1) is first_is_white ? first : second;
+			const Engine::Settings& settings = &engine is &first ? Match.First : Match.Second;
+
+			Engine::SearchLimits limits;
+			limits.Depth = settings.Depth;
+			limits.MoveTime = settings.MoveTime;
+
+			engine.Start(position, limits);
+			engine.Wait();
+			move = engine.BestMove;
+		}
+
+		position.DoMove(move, undo);
+		record.Moves.push_back(move);
+		outcome.Plies++;
+	}
+
+	if (Match.SaveGames) {
+		std::lock_guard<std::mutex> lock(ArchiveLock);
+
+		try {
+			SCG::Append("log/SelfPlay.sca", record, static_cast<sf::Uint8>(outcome.Result > 0 ? 1 : outcome.Result < 0 ? 2 : 3));
+		} catch (int e) {}
+	}
+
+	return outcome;
+}
+
+void SimpleChess::SelfPlay::Worker(void) {
+	Engine::Searcher first, second;
+
+	first.SetThreads(Match.First.Threads);
+	first.SetHash(Match.First.Hash);
+	second.SetThreads(Match.Second.Threads);
+	second.SetHash(Match.Second.Hash);
+
+	for (int index = NextGame++; index < Match.Games; index = NextGame++) {
+		const Outcome outcome = PlayGame(index, first, second);
+		const int score = index % 2 is 0 ? outcome.Result : -outcome.Result;
+
+		(score > 0 ? Wins : score < 0 ? Losses : Draws)++;
+
+		double elo, margin;
+		const int wins = Wins.load(), draws = Draws.load(), losses = Losses.load();
+		Elo(wins, draws, losses, elo, margin);
+
+		std::lock_guard<std::mutex> lock(OutputLock);
+		std::cout << "Game " << index + 1 << " (" << (index % 2 is 0 ? "First" : "Second") << " is White): "
+				  << (outcome.Result > 0 ? "1-0" : outcome.Result < 0 ? "0-1" : "1/2-1/2") << " by " << outcome.Reason << " in " << outcome.Plies << " plies."
+				  << " Score " << wins << "-" << draws << "-" << losses << ", Elo " << elo << " +/- " << margin << std::endl;
+	}
+}
+
+void SimpleChess::SelfPlay::Elo(int wins, int draws, int losses, double& elo, double& margin) {
+	const double games = wins + draws + losses;
+	elo = margin = 0.0;
+	if (games <= 0.0) {
+		return;
+	}
+
+	const double score = (wins + draws * 0.5) / games,
+				 deviation = std::sqrt((wins * (1.0 - score) * (1.0 - score) + draws * (0.5 - score) * (0.5 - score) + losses * score * score) / games) / std::sqrt(games);
+
+	// The logistic curve is infinite at 0% and 100%.
+	auto to_elo = [](double s) {
+		s = std::min(std::max(s, 0.001), 0.999);
+		return -400.0 * std::log10(1.0 / s - 1.0);
+	};
+
+	elo = to_elo(score);
+	margin = (to_elo(score + 1.96 * deviation) - to_elo(score - 1.96 * deviation)) / 2.0;
+}
+
+void SimpleChess::SelfPlay::Main(void) {
+	try {
+		ReadSettings("config/selfplay.chessconf", Match);
+	} catch (int e) {
+		return;
+	}
+
+	const int concurrency = Match.Concurrency > 0 ? Match.Concurrency : std::max<int>(1, std::thread::hardware_concurrency());
+	std::cout << "Playing " << Match.Games << " games, " << concurrency << " at a time." << std::endl;
+
+	Clock.restart();
+
+	std::vector<std::thread> workers;
+	for (int c = 0; c < concurrency; c++) {
+		workers.emplace_back(Worker);
+	}
+
+	for (auto& worker : workers) {
+		worker.join();
+	}
+
+	const double hours = Clock.getElapsedTime().asSeconds() / 3600.0;
+	const int games = Wins + Draws + Losses;
+	double elo, margin;
+	Elo(Wins, Draws, Losses, elo, margin);
+
+	std::cout << "Finished " << games << " games: " << Wins << " wins, " << Draws << " draws, " << Losses << " losses." << std::endl
+			  << "Elo difference: " << elo << " +/- " << margin << " (95%)" << std::endl
+			  << "Throughput: " << (hours > 0.0 ? games / hours : 0.0) << " games/hour" << std::endl;
+}
+
+#endif
@@ -0,0 +1,73 @@
+/*
+ *  server.cpp
+ *  SimpleChess
+ *
+ *  Copyright (c) 2013-2015 Ronak Gajrawala. All rights reserved.
+ */
+
+/*
+ * Hosts networked games for any number of ConnectedGame windows until it is stopped with Ctrl+C.
+ * Usage: simplechess-server [port] [archive]
+ */
+
+#include "core.hpp"
+#include "server.hpp"
+
+namespace {
+	volatile std::sig_atomic_t Stop = 0; /**< Set when the server is asked to stop. */
+
+	void OnSignal(int) {
+		Stop = 1;
+	}
+}
+
+int main(int argc, char* argv[]) {
+	std::string port = argc > 1 ? argv[1] : "";
+	const std::string archive = argc > 2 ? argv[2] : "log/Server.sca";
+
+	// Without a port, use the one the game windows use.
+	if (port.empty()) {
+		std::ifstream fl(SimpleChess::File::Path + "config/connection.chessconf", std::ios::in);
+		std::getline(fl, port);
+		std::getline(fl, port);
+	}
+
+	if (std::atoi(port.c_str()) <= 0 or std::atoi(port.c_str()) > 65535) {
+		std::cerr << "Usage: simplechess-server [port] [archive], or put the port on the second line of config/connection.chessconf." << std::endl;
+		return EXIT_FAILURE;
+	}
+
+	SimpleChess::Engine::Zobrist::Initialize();
+	std::signal(SIGINT, OnSignal);
+	std::signal(SIGTERM, OnSignal);
+
+	const std::size_t sockets = SimpleChess::Server::RaiseSocketLimit();
+	SimpleChess::Server::Host host;
+
+	try {
+		host.Listen(static_cast<unsigned short>(std::atoi(port.c_str())), archive is "-" ? "" : archive);
+	} catch (int e) {
+		std::cerr << "Could not listen on port " << port << "." << std::endl;
+		return EXIT_FAILURE;
+	}
+
+	std::cout << "Listening on port " << port << " for up to " << sockets / 2 << " games." << std::endl;
+
+	sf::Clock clock;
+	sf::Uint64 moves = 0;
+
+	while (not Stop) {
+		host.Step(1000);
+
+		if (clock.getElapsedTime().asSeconds() >= 10.0f) {
+			const SimpleChess::Server::Stats& stats = host.Counters();
+			std::cout << stats.Clients << " clients, " << stats.Playing << " games, " << (stats.Moves - moves) / clock.restart().asSeconds() << " moves/s; "
+					  << stats.Finished << " games finished, " << stats.Abandoned << " abandoned, " << stats.Rejected << " clients rejected." << std::endl;
+			moves = stats.Moves;
+		}
+	}
+
+	const SimpleChess::Server::Stats& stats = host.Counters();
+	std::cout << "Stopped after " << stats.Games << " games (" << stats.Moves << " moves)." << std::endl;
+	return 0;
+}
@@ -0,0 +1,583 @@
+/*
+ *  server.hpp
+ *  SimpleChess
+ *
+ *  Copyright (c) 2013-2015 Ronak Gajrawala. All rights reserved.
+ */
+
+#ifndef SimpleChess_server_hpp
+#define SimpleChess_server_hpp
+
+namespace SimpleChess {
+	/**
+	 * The Server class.
+	 * Hosts many networked games in one process without a window (Linux only, since it waits on epoll).
+	 * Clients speak the protocol of ConnectedGame: SFML packets, i.e. a 4-byte big-endian size and then the data.
+	 * Clients are paired in the order they connect. When a game starts each player gets a 1-byte packet with its side
+	 * (1 for White, 2 for Black); after that every packet is a move, as the 7 fields of a log record, which is checked
+	 * against the rules of the game windows and sent on to the other player.
+	 */
+	namespace Server {
+		const std::size_t SizeBytes = 4; /**< Bytes before each packet's data. */
+		const std::size_t MoveSize = 7; /**< Bytes in a move packet. */
+		const std::size_t MaxPacketSize = 64; /**< Larger packets are refused. */
+		const int MaxEvents = 256; /**< Events taken from epoll at a time. */
+
+		/**
+		 * A connected client.
+		 */
+		class Client {
+		public:
+			int Socket = -1; /**< The client's socket. */
+			short Side = 0; /**< 1 or 2 once the client is paired, 0 while it waits. */
+			int Opponent = -1; /**< The other player's socket, -1 if none. */
+			std::shared_ptr<Game> Playing; /**< The game, null while waiting and once the game is over. */
+			std::string In, /**< Bytes received but not handled yet. */
+						Out; /**< Bytes not sent yet. */
+			bool Writing = false, /**< True while epoll also waits for Socket to take more bytes. */
+				 Closing = false, /**< True if the client is disconnected once Out is sent. */
+				 Gone = false; /**< True if the client is disconnected at the end of the step. */
+		};
+
+		/**
+		 * What the server did so far.
+		 */
+		class Stats {
+		public:
+			sf::Uint64 Connections = 0, /**< Clients that connected. */
+					   Games = 0, /**< Games started. */
+					   Finished = 0, /**< Games that ended with a captured king. */
+					   Abandoned = 0, /**< Games that ended with a player leaving. */
+					   Moves = 0, /**< Moves played. */
+					   Rejected = 0; /**< Clients dropped for breaking the protocol or the rules. */
+			std::size_t Clients = 0, /**< Clients connected now. */
+						Playing = 0; /**< Games being played now. */
+		};
+
+		/**
+		 * Makes the data of a move packet.
+		 * @param info The move.
+		 * @param data Where the MoveSize bytes will be written.
+		 */
+		void PackMove(const File::Info&, unsigned char*);
+
+		/**
+		 * Reads the data of a move packet.
+		 * @param data The MoveSize bytes.
+		 * @param info Where the move will be dumped.
+		 * @return False if a square is off the board.
+		 */
+		bool UnpackMove(const unsigned char*, File::Info&);
+
+		/**
+		 * Adds a packet to the bytes to send.
+		 * @param out The bytes to send.
+		 * @param data The packet's data.
+		 * @param size The size of the data.
+		 */
+		void AppendPacket(std::string&, const unsigned char*, std::size_t);
+
+		/**
+		 * Finds the next whole packet in the bytes received.
+		 * @param in The bytes received.
+		 * @param at Where the packet starts. Moved past it if it is whole.
+		 * @param data Where a pointer to the packet's data will be stored.
+		 * @param size Where the size of the data will be stored. Larger than MaxPacketSize if the packet is refused.
+		 * @return False if the packet has not been received completely.
+		 */
+		bool NextPacket(const std::string&, std::size_t&, const unsigned char*&, std::size_t&);
+
+		/**
+		 * Raises the limit of open files as far as allowed, since every client takes a socket.
+		 * @return The new limit.
+		 */
+		std::size_t RaiseSocketLimit(void);
+
+		/**
+		 * A server that pairs clients into games and passes their moves on.
+		 * Everything happens on the thread that calls Step, so games need no locks.
+		 */
+		class Host {
+		public:
+			Host(void) = default;
+			Host(const Host&) = delete;
+			Host& operator=(const Host&) = delete;
+			~Host(void);
+
+			/**
+			 * Starts listening. A listening host is closed first.
+			 * Games start from the position in config/default.chessconf, or the standard position if it is missing.
+			 * @param port The port.
+			 * @param archive Where finished games are appended, or an empty string to not keep them.
+			 */
+			void Listen(unsigned short, std::string);
+
+			/**
+			 * Disconnects every client and stops listening.
+			 */
+			void Close(void);
+
+			/**
+			 * Waits until a socket is ready and handles every socket that is.
+			 * @param timeout The most milliseconds to wait, -1 to wait until a socket is ready.
+			 * @return The number of sockets handled.
+			 */
+			int Step(int);
+
+			/**
+			 * Gets what the server did so far.
+			 * @return The counters.
+			 */
+			const Stats& Counters(void) const;
+
+		private:
+			/**
+			 * Accepts every waiting client.
+			 */
+			void Accept(void);
+
+			/**
+			 * Starts a game if another client is waiting, or makes the client wait.
+			 * @param client The new client.
+			 */
+			void Pair(Client&);
+
+			/**
+			 * Reads what a client sent and handles its whole packets.
+			 * @param client The client.
+			 * @return False if the client has to be dropped.
+			 */
+			bool Read(Client&);
+
+			/**
+			 * Handles one packet.
+			 * @param client The client that sent it.
+			 * @param data The packet's data.
+			 * @param size The size of the data.
+			 * @return False if the client has to be dropped.
+			 */
+			bool Handle(Client&, const unsigned char*, std::size_t);
+
+			/**
+			 * Sends a packet to a client.
+			 * @param client The client.
+			 * @param data The packet's data.
+			 * @param size The size of the data.
+			 */
+			void Send(Client&, const unsigned char*, std::size_t);
+
+			/**
+			 * Sends as much of a client's Out as its socket takes, and drops a closing client once everything is sent.
+			 * @param client The client.
+			 */
+			void Flush(Client&);
+
+			/**
+			 * Ends a game that a player won and archives it.
+			 * @param client The player who made the last move.
+			 * @param winner 1 or 2.
+			 */
+			void Finish(Client&, short);
+
+			/**
+			 * Drops a client at the end of the step, ending its game.
+			 * @param client The client.
+			 */
+			void Drop(Client&);
+
+			int Listener = -1, /**< The listening socket. */
+				Poller = -1, /**< The epoll instance. */
+				Waiting = -1; /**< The socket of the client waiting for an opponent, -1 if none. */
+			std::vector<std::unique_ptr<Client>> Clients; /**< The clients by socket. */
+			std::vector<int> Leaving; /**< The sockets to close at the end of the step. */
+			Engine::Position StartPosition; /**< Where every game starts. */
+			std::string Archive; /**< Where finished games are appended. */
+			Stats Counts; /**< What the server did so far. */
+		};
+	};
+};
+
+////////// SOURCE //////////
+
+void SimpleChess::Server::PackMove(const File::Info& info, unsigned char* data) {
+	data[0] = info.Piece1;
+	data[1] = info.Piece1Loc.x;
+	data[2] = info.Piece1Loc.y;
+	data[3] = info.Move;
+	data[4] = info.Piece2;
+	data[5] = info.Piece2Loc.x;
+	data[6] = info.Piece2Loc.y;
+}
+
+bool SimpleChess::Server::UnpackMove(const unsigned char* data, File::Info& info) {
+	info.Piece1 = data[0];
+	info.Piece1Loc = sf::Vector2<sf::Uint8>(data[1], data[2]);
+	info.Move = data[3];
+	info.Piece2 = data[4];
+	info.Piece2Loc = sf::Vector2<sf::Uint8>(data[5], data[6]);
+
+	return info.Piece1Loc.x < 8 and info.Piece1Loc.y < 8 and info.Piece2Loc.x < 8 and info.Piece2Loc.y < 8;
+}
+
+void SimpleChess::Server::AppendPacket(std::string& out, const unsigned char* data, std::size_t size) {
+	const char header[SizeBytes] = {
+		static_cast<char>(size >> 24 & 0xFF), static_cast<char>(size >> 16 & 0xFF),
+		static_cast<char>(size >> 8 & 0xFF), static_cast<char>(size & 0xFF)
+	};
+
+	out.append(header, SizeBytes);
+	out.append(reinterpret_cast<const char*>(data), size);
+}
+
+bool SimpleChess::Server::NextPacket(const std::string& in, std::size_t& at, const unsigned char*& data, std::size_t& size) {
+	if (in.size() - at < SizeBytes) {
+		return false;
+	}
+
+	const unsigned char* header = reinterpret_cast<const unsigned char*>(in.data()) + at;
+	size = static_cast<std::size_t>(header[0]) << 24 | static_cast<std::size_t>(header[1]) << 16 | static_cast<std::size_t>(header[2]) << 8 | header[3];
+
+	// A refused packet is reported at once rather than waited for.
+	if (size > MaxPacketSize) {
+		return true;
+	}
+
+	if (in.size() - at - SizeBytes < size) {
+		return false;
+	}
+
+	data = header + SizeBytes;
+	at += SizeBytes + size;
+	return true;
+}
+
+std::size_t SimpleChess::Server::RaiseSocketLimit(void) {
+	struct rlimit limit;
+
+	if (getrlimit(RLIMIT_NOFILE, &limit) != 0) {
+		return 0;
+	}
+
+	if (limit.rlim_cur < limit.rlim_max) {
+		limit.rlim_cur = limit.rlim_max;
+		setrlimit(RLIMIT_NOFILE, &limit);
+		getrlimit(RLIMIT_NOFILE, &limit);
+	}
+
+	return static_cast<std::size_t>(limit.rlim_cur);
+}
+
+SimpleChess::Server::Host::~Host(void) {
+	Close();
+}
+
+void SimpleChess::Server::Host::Listen(unsigned short port, std::string archive) {
+	Close();
+
+	Archive = archive;
+	try {
+		File::ReadStartPosition("config/default.chessconf", StartPosition);
+	} catch (int e) {
+		StartPosition.Reset();
+	}
+
+	Listener = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+	Poller = epoll_create1(EPOLL_CLOEXEC);
+
+	const int on = 1;
+	struct sockaddr_in address;
+	memset(&address, 0, sizeof(address));
+	address.sin_family = AF_INET;
+	address.sin_addr.s_addr = htonl(INADDR_ANY);
+	address.sin_port = htons(port);
+
+	struct epoll_event event;
+	memset(&event, 0, sizeof(event));
+	event.events = EPOLLIN;
+	event.data.fd = Listener;
+
+	if (Listener < 0 or Poller < 0 or setsockopt(Listener, SOL_SOCKET, SO_REUSEADDR, &on, sizeof(on)) != 0 or
+		bind(Listener, reinterpret_cast<struct sockaddr*>(&address), sizeof(address)) != 0 or listen(Listener, SOMAXCONN) != 0 or
+		epoll_ctl(Poller, EPOLL_CTL_ADD, Listener, &event) != 0) {
+		Close();
+		FError(false, "ERROR: Could not listen on port %d.", port);
+
+		throw 1;
+		return;
+	}
+}
+
+void SimpleChess::Server::Host::Close(void) {
+	for (auto& client : Clients) {
+		if (client) {
+			close(client->Socket);
+		}
+	}
+	Clients.clear();
+	Leaving.clear();
+
+	if (Listener >= 0) {
+		close(Listener);
+	}
+	if (Poller >= 0) {
+		close(Poller);
+	}
+
+	Listener = Poller = Waiting = -1;
+	Counts.Clients = Counts.Playing = 0;
+}
+
+int SimpleChess::Server::Host::Step(int timeout) {
+	struct epoll_event events[MaxEvents];
+	const int count = epoll_wait(Poller, events, MaxEvents, timeout);
+
+	for (int i = 0; i < count; i++) {
+		const int socket = events[i].data.fd;
+
+		if (socket is Listener) {
+			Accept();
+			continue;
+		}
+
+		Client* client = static_cast<std::size_t>(socket) < Clients.size() ? Clients[socket].get() : nullptr;
+		if (client is nullptr or client->Gone) {
+			continue;
+		}
+
+		if ((events[i].events & (EPOLLIN | EPOLLHUP | EPOLLERR)) and not Read(*client)) {
+			Counts.Rejected += client->Gone ? 0 : 1;
+			Drop(*client);
+			continue;
+		}
+
+		if ((events[i].events & EPOLLOUT) and not client->Gone) {
+			Flush(*client);
+		}
+	}
+
+	// Sockets are only closed here, so none is reused while its events are still being handled.
+	for (const int socket : Leaving) {
+		close(socket);
+		Clients[socket].reset();
+		Counts.Clients--;
+	}
+	Leaving.clear();
+
+	return std::max(count, 0);
+}
+
+const SimpleChess::Server::Stats& SimpleChess::Server::Host::Counters(void) const {
+	return Counts;
+}
+
+void SimpleChess::Server::Host::Accept(void) {
+	for (;;) {
+		const int socket = accept4(Listener, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+		if (socket < 0) {
+			if (errno != EAGAIN and errno != EWOULDBLOCK and errno != EINTR) {
+				FError(false, "ERROR: Could not accept a client: %s.", strerror(errno));
+			}
+			return;
+		}
+
+		const int on = 1;
+		setsockopt(socket, IPPROTO_TCP, TCP_NODELAY, &on, sizeof(on));
+
+		struct epoll_event event;
+		memset(&event, 0, sizeof(event));
+		event.events = EPOLLIN;
+		event.data.fd = socket;
+
+		if (epoll_ctl(Poller, EPOLL_CTL_ADD, socket, &event) != 0) {
+			close(socket);
+			continue;
+		}
+
+		if (Clients.size() <= static_cast<std::size_t>(socket)) {
+			Clients.resize(static_cast<std::size_t>(socket) + 1);
+		}
+
+		Clients[socket].reset(new Client());
+		Clients[socket]->Socket = socket;
+		Counts.Connections++;
+		Counts.Clients++;
+
+		Pair(*Clients[socket]);
+	}
+}
+
+void SimpleChess::Server::Host::Pair(Client& client) {
+	if (Waiting < 0) {
+		Waiting = client.Socket;
+		return;
+	}
+
+	Client& white = *Clients[Waiting];
+	Waiting = -1;
+
+	std::shared_ptr<Game> game = std::make_shared<Game>();
+	game->Start(StartPosition);
+
+	white.Side = 1;
+	client.Side = 2;
+	white.Opponent = client.Socket;
+	client.Opponent = white.Socket;
+	white.Playing = client.Playing = game;
+
+	Counts.Games++;
+	Counts.Playing++;
+
+	const unsigned char sides[2] = { 1, 2 };
+	Send(white, &sides[0], 1);
+	Send(client, &sides[1], 1);
+}
+
+bool SimpleChess::Server::Host::Read(Client& client) {
+	char buffer[4096];
+	const ssize_t size = recv(client.Socket, buffer, sizeof(buffer), 0);
+
+	if (size is 0) {
+		// The client left; that is not breaking the protocol.
+		Drop(client);
+		return true;
+	}
+
+	if (size < 0) {
+		if (errno is EAGAIN or errno is EWOULDBLOCK or errno is EINTR) {
+			return true;
+		}
+
+		Drop(client);
+		return true;
+	}
+
+	client.In.append(buffer, static_cast<std::size_t>(size));
+
+	std::size_t at = 0;
+	const unsigned char* data = nullptr;
+	std::size_t length = 0;
+
+	while (not client.Gone and NextPacket(client.In, at, data, length)) {
+		if (length > MaxPacketSize or not Handle(client, data, length)) {
+			return false;
+		}
+	}
+
+	client.In.erase(0, at);
+	return true;
+}
+
+bool SimpleChess::Server::Host::Handle(Client& client, const unsigned char* data, std::size_t size) {
+	File::Info info;
+
+	if (not client.Playing or size != MoveSize or not UnpackMove(data, info) or client.Side != client.Playing->Turn or not client.Playing->Play(info)) {
+		return false;
+	}
+
+	Counts.Moves++;
+	Send(*Clients[client.Opponent], data, size);
+
+	const short winner = client.Playing->Winner();
+	if (winner != 0) {
+		Finish(client, winner);
+	}
+
+	return true;
+}
+
+void SimpleChess::Server::Host::Send(Client& client, const unsigned char* data, std::size_t size) {
+	if (client.Gone) {
+		return;
+	}
+
+	AppendPacket(client.Out, data, size);
+	Flush(client);
+}
+
+void SimpleChess::Server::Host::Flush(Client& client) {
+	if (client.Gone) {
+		return;
+	}
+
+	while (not client.Out.empty()) {
+		const ssize_t sent = send(client.Socket, client.Out.data(), client.Out.size(), MSG_NOSIGNAL);
+
+		if (sent > 0) {
+			client.Out.erase(0, static_cast<std::size_t>(sent));
+		} else if (sent < 0 and (errno is EAGAIN or errno is EWOULDBLOCK)) {
+			break;
+		} else if (sent < 0 and errno is EINTR) {
+			continue;
+		} else {
+			Drop(client);
+			return;
+		}
+	}
+
+	// Only wait for the socket to take more bytes while there are bytes to send.
+	const bool writing = not client.Out.empty();
+	if (writing != client.Writing) {
+		struct epoll_event event;
+		memset(&event, 0, sizeof(event));
+		event.events = EPOLLIN;
+		if (writing) {
+			event.events |= EPOLLOUT;
+		}
+		event.data.fd = client.Socket;
+
+		epoll_ctl(Poller, EPOLL_CTL_MOD, client.Socket, &event);
+		client.Writing = writing;
+	}
+
+	if (client.Out.empty() and client.Closing) {
+		Drop(client);
+	}
+}
+
+void SimpleChess::Server::Host::Finish(Client& client, short winner) {
+	const std::shared_ptr<Game> game = client.Playing;
+	Client& opponent = *Clients[client.Opponent];
+
+	Counts.Finished++;
+	Counts.Playing--;
+
+	if (not Archive.empty()) {
+		try {
+			SCG::Append(Archive, game->Record, static_cast<sf::Uint8>(winner));
+		} catch (int e) {}
+	}
+
+	// The windows close themselves when a king is captured, so both players are let go once the last move is sent.
+	for (Client* player : { &client, &opponent }) {
+		player->Playing.reset();
+		player->Closing = true;
+		Flush(*player);
+	}
+}
+
+void SimpleChess::Server::Host::Drop(Client& client) {
+	if (client.Gone) {
+		return;
+	}
+
+	client.Gone = true;
+	Leaving.push_back(client.Socket);
+
+	if (Waiting is client.Socket) {
+		Waiting = -1;
+	}
+
+	if (client.Playing) {
+		Client& opponent = *Clients[client.Opponent];
+
+		Counts.Abandoned++;
+		Counts.Playing--;
+
+		client.Playing.reset();
+		opponent.Playing.reset();
+		opponent.Closing = true;
+		Flush(opponent);
+	}
+}
+
+#endif
@@ -36,7 +36,7 @@ namespace SimpleChess {
 						   GameConnectButton, /**< The button to connect the game. */
 						   LocalGameButton; /**< The button to connect to a local game. */
 
-		short WhoWon = 0; /**< Who won the game. -1 if an error occured, 1 if white won. 2 if black won. 0 if game is still playing or tie. */
+		short WhoWon = 0; /**< Who won the game. -1 if an error occured, 1 if white won. 2 if black won. 3 if the game was drawn. 0 if game is still playing. */
 		short Go; /**< -1 if error, 0 if go to game, 1 if go to reader, 2 if connect to game, 3 if play local game. */
 
 		/**
@@ -166,6 +166,8 @@ void SimpleChess::StartPage::Initialize(void) {
 		WhoWonText.setString("White (Player 1) Won!");
 	} else if (WhoWon == 2) {
 		WhoWonText.setString("Black (Player 2) Won!");
+	} else if (WhoWon == 3) {
+		WhoWonText.setString("      It's a Draw!");
 	} else if (WhoWon == -1) {
 		WhoWonText.setString(" There was an error!");
 	} else {
@@ -252,7 +254,7 @@ short SimpleChess::StartPage::Main(void) {
 }
 
 void SimpleChess::StartPage::SetWhoWon(short whowon) {
-	if (whowon > 2 or whowon < -1 or whowon == 0) {
+	if (whowon > 3 or whowon < -1 or whowon == 0) {
 		return;
 	}
 
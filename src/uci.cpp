@@ -0,0 +1,19 @@
+/*
+ *  uci.cpp
+ *  SimpleChess
+ *
+ *  Copyright (c) 2013-2015 Ronak Gajrawala. All rights reserved.
+ */
+
+/*
+ * Headless UCI engine. Needs no window, so __CPP_DEBUG__ stays off:
+ * stdout belongs to the protocol.
+ */
+
+#include "core.hpp"
+#include "uci.hpp"
+
+ChessMain
+	SimpleChess::Engine::Zobrist::Initialize();
+	SimpleChess::UCI::Main();
+ChessEnd
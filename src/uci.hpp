@@ -0,0 +1,247 @@
+/*
+ *  uci.hpp
+ *  SimpleChess
+ *
+ *  Copyright (c) 2013-2015 Ronak Gajrawala. All rights reserved.
+ */
+
+#ifndef SimpleChess_uci_hpp
+#define SimpleChess_uci_hpp
+
+namespace SimpleChess {
+	/**
+	 * The UCI class.
+	 * Speaks the Universal Chess Interface over stdin and stdout so the engine can be used by other programs.
+	 * Commands are read on the main thread while the search runs on its own, so "stop" is answered at once.
+	 */
+	namespace UCI {
+		Engine::Searcher Searcher; /**< Runs the searches. */
+		Engine::Position Current; /**< The position set with "position". */
+		std::mutex OutputLock; /**< Keeps lines from the search and command threads apart. */
+		int MultiPV = 1; /**< How many of the best lines to report. */
+
+		/**
+		 * Main loop. Reads commands until "quit" or the end of input.
+		 */
+		void Main(void);
+
+		/**
+		 * Writes one line to stdout and flushes it.
+		 * @param line The line without its newline.
+		 */
+		void Send(const std::string&);
+
+		/**
+		 * Handler for "uci". Sends the engine's name and options.
+		 */
+		void OnUCI(void);
+
+		/**
+		 * Handler for "setoption name <name> value <value>".
+		 * @param args The rest of the command.
+		 */
+		void OnSetOption(std::istringstream&);
+
+		/**
+		 * Handler for "position [startpos | fen <fen>] [moves <moves>...]".
+		 * @param args The rest of the command.
+		 */
+		void OnPosition(std::istringstream&);
+
+		/**
+		 * Handler for "go". Starts a search in the background.
+		 * @param args The rest of the command.
+		 */
+		void OnGo(std::istringstream&);
+
+		/**
+		 * Sends an "info" line after each completed iteration.
+		 * @param info The search progress.
+		 */
+		void OnInfo(const Engine::SearchInfo&);
+
+		/**
+		 * Sends "bestmove" when the search ends.
+		 * @param best The best move.
+		 */
+		void OnBestMove(Engine::Move16);
+	};
+};
+
+////////// SOURCE //////////
+
+void SimpleChess::UCI::Send(const std::string& line) {
+	std::lock_guard<std::mutex> lock(OutputLock);
+	std::cout << line << std::endl;
+}
+
+void SimpleChess::UCI::OnUCI(void) {
+	Send("id name SimpleChess");
+	Send("id author Ronak Gajrawala");
+	Send("option name Hash type spin default 16 min 1 max 4096");
+	Send("option name Threads type spin default 1 min 1 max 64");
+	Send("option name MultiPV type spin default 1 min 1 max 16");
+	Send("uciok");
+}
+
+void SimpleChess::UCI::OnSetOption(std::istringstream& args) {
+	std::string token, name, value;
+
+	args >> token;
+	while (args >> token and token != "value") {
+		name += (name.empty() ? "" : " ") + token;
+	}
+	args >> value;
+
+	Searcher.Halt();
+	if (name is "Hash") {
+		Searcher.SetHash(std::max(1, std::min(atoi(value.c_str()), 4096)));
+	} else if (name is "Threads") {
+		Searcher.SetThreads(std::max(1, std::min(atoi(value.c_str()), 64)));
+	} else if (name is "MultiPV") {
+		MultiPV = std::max(1, std::min(atoi(value.c_str()), 16));
+	}
+}
+
+void SimpleChess::UCI::OnPosition(std::istringstream& args) {
+	std::string token, fen;
+
+	Searcher.Halt();
+	args >> token;
+
+	if (token is "startpos") {
+		Current.Reset();
+		args >> token;
+	} else if (token is "fen") {
+		while (args >> token and token != "moves") {
+			fen += token + " ";
+		}
+
+		if (not Current.FromFEN(fen.c_str())) {
+			Send("info string invalid fen, using the starting position");
+			Current.Reset();
+		}
+	}
+
+	if (token != "moves") {
+		return;
+	}
+
+	while (args >> token) {
+		const Engine::Move16 move = Engine::ParseMove(Current, token);
+		if (move is Engine::NoMove) {
+			Send("info string illegal move " + token);
+			return;
+		}
+
+		Engine::Undo undo;
+		Current.DoMove(move, undo);
+	}
+}
+
+void SimpleChess::UCI::OnGo(std::istringstream& args) {
+	Engine::SearchLimits limits;
+	std::string token;
+
+	Searcher.Halt();
+	limits.MultiPV = MultiPV;
+
+	while (args >> token) {
+		if (token is "infinite") {
+			limits.Infinite = true;
+		} else if (token is "perft") {
+			int depth = 1;
+			args >> depth;
+
+			sf::Clock clock;
+			const sf::Uint64 nodes = Current.Perft(std::max(depth, 1));
+			Send("info string perft " + std::to_string(depth) + " nodes " + std::to_string(nodes) + " time " + std::to_string(clock.getElapsedTime().asMilliseconds()));
+			return;
+		} else {
+			long long value = 0;
+			args >> value;
+
+			if (token is "depth") {
+				limits.Depth = static_cast<int>(value);
+			} else if (token is "movetime") {
+				limits.MoveTime = static_cast<sf::Int32>(value);
+			} else if (token is "wtime") {
+				limits.WhiteTime = static_cast<sf::Int32>(value);
+			} else if (token is "btime") {
+				limits.BlackTime = static_cast<sf::Int32>(value);
+			} else if (token is "winc") {
+				limits.WhiteIncrement = static_cast<sf::Int32>(value);
+			} else if (token is "binc") {
+				limits.BlackIncrement = static_cast<sf::Int32>(value);
+			} else if (token is "movestogo") {
+				limits.MovesToGo = static_cast<sf::Int32>(value);
+			} else if (token is "nodes") {
+				limits.Nodes = static_cast<sf::Uint64>(value);
+			}
+		}
+	}
+
+	Searcher.Start(Current, limits);
+}
+
+void SimpleChess::UCI::OnInfo(const Engine::SearchInfo& info) {
+	std::stringstream ss;
+	ss << "info depth " << info.Depth << " seldepth " << info.SelDepth << " multipv " << info.Line;
+
+	if (info.Score > Engine::Score::MateBound) {
+		ss << " score mate " << (Engine::Score::Mate - info.Score + 1) / 2;
+	} else if (info.Score < -Engine::Score::MateBound) {
+		ss << " score mate -" << (Engine::Score::Mate + info.Score) / 2;
+	} else {
+		ss << " score cp " << info.Score;
+	}
+
+	ss << " nodes " << info.Nodes << " nps " << (info.Milliseconds > 0 ? info.Nodes * 1000 / info.Milliseconds : info.Nodes) << " time " << info.Milliseconds << " pv";
+	for (Engine::Move16 move : info.PV) {
+		ss << ' ' << Engine::MoveToString(move);
+	}
+
+	Send(ss.str());
+}
+
+void SimpleChess::UCI::OnBestMove(Engine::Move16 best) {
+	Send("bestmove " + (best is Engine::NoMove ? std::string("0000") : Engine::MoveToString(best)));
+}
+
+void SimpleChess::UCI::Main(void) {
+	std::string line, command;
+
+	Current.Reset();
+	Searcher.OnInfo = OnInfo;
+	Searcher.OnDone = OnBestMove;
+
+	while (std::getline(std::cin, line)) {
+		std::istringstream args(line);
+		if (not (args >> command)) {
+			continue;
+		}
+
+		if (command is "uci") {
+			OnUCI();
+		} else if (command is "isready") {
+			Send("readyok");
+		} else if (command is "ucinewgame") {
+			Searcher.Halt();
+			Searcher.TT.Clear();
+		} else if (command is "setoption") {
+			OnSetOption(args);
+		} else if (command is "position") {
+			OnPosition(args);
+		} else if (command is "go") {
+			OnGo(args);
+		} else if (command is "stop") {
+			Searcher.Halt();
+		} else if (command is "quit") {
+			break;
+		}
+	}
+
+	Searcher.Halt();
+}
+
+#endif
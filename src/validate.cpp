@@ -0,0 +1,40 @@
+/*
+ *  validate.cpp
+ *  SimpleChess
+ *
+ *  Copyright (c) 2013-2015 Ronak Gajrawala. All rights reserved.
+ */
+
+/*
+ * Replays every game of an archive by the rules of the game windows and reports the first broken move of each broken game.
+ * Games that leave a king in check, which only the windows allow, are counted but pass.
+ * Usage: simplechess-validate [archive] [threads]
+ */
+
+#include "core.hpp"
+
+int main(int argc, char* argv[]) {
+	const std::string archive = argc > 1 ? argv[1] : "log/Games.sca";
+	const int threads = argc > 2 ? std::atoi(argv[2]) : 0;
+
+	SimpleChess::Engine::Zobrist::Initialize();
+	sf::Clock clock;
+	SimpleChess::Replay::Stats stats;
+
+	try {
+		stats = SimpleChess::Replay::Run(archive, threads);
+	} catch (int e) {
+		std::cerr << "Could not validate " << archive << "." << std::endl;
+		return EXIT_FAILURE;
+	}
+
+	const double seconds = std::max(clock.getElapsedTime().asSeconds(), 1e-6f);
+	for (const auto& problem : stats.Problems) {
+		std::cout << "Game " << problem.Game + 1 << ": move " << problem.Ply + 1 << " (" << SimpleChess::Engine::MoveToString(problem.Move) << ") is broken" << std::endl;
+	}
+
+	std::cout << "Replayed " << stats.Games << " games (" << stats.Moves << " moves) in " << seconds << " s, " << stats.Problems.size() << " with a broken move." << std::endl
+			  << stats.Windows << " games leave a king in check, which only the window rules allow." << std::endl
+			  << "Throughput: " << stats.Moves / seconds / 1e6 << "M moves/s" << std::endl;
+	return stats.Problems.empty() ? 0 : EXIT_FAILURE;
+}